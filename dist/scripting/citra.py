@@ -16,6 +16,14 @@ class RequestType(enum.IntEnum):
     WriteMemory = 2,
     ProcessList = 3,
     SetGetProcess = 4,
+    ReadMemoryBatch = 5,
+    Subscribe = 6,
+    Unsubscribe = 7,
+    SubscriptionUpdate = 8,
+
+class SubscriptionEncoding(enum.IntEnum):
+    Full = 0,
+    Delta = 1,
 
 CITRA_PORT = 45987
 
@@ -23,6 +31,7 @@ class Citra:
     def __init__(self, address="127.0.0.1", port=CITRA_PORT):
         self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
         self.address = address
+        self.subscriptions = {}
 
     def is_connected(self):
         return self.socket is not None
@@ -145,6 +154,107 @@ class Citra:
                 return False
         return True
 
+    def _pack_ranges(self, ranges):
+        return b"".join(struct.pack("II", address, size) for address, size in ranges)
+
+    def _split_ranges(self, data, ranges):
+        result = []
+        offset = 0
+        for _, size in ranges:
+            result.append(bytes(data[offset:offset + size]))
+            offset += size
+        return result
+
+    def read_memory_batch(self, ranges):
+        """
+        Reads a list of (address, size) ranges at the same frame boundary.
+        >>> c.read_memory_batch([(0x100000, 4)])
+        [b'\\x07\\x00\\x00\\xeb']
+        """
+        request_data = struct.pack("II", len(ranges), 0) + self._pack_ranges(ranges)
+        request, request_id = self._generate_header(RequestType.ReadMemoryBatch, len(request_data))
+        request += request_data
+        self.socket.sendto(request, (self.address, CITRA_PORT))
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemoryBatch)
+
+        if reply_data:
+            return self._split_ranges(reply_data, ranges)
+        return None
+
+    def subscribe(self, ranges, interval_frames=1):
+        """
+        Asks the server to push the contents of a list of (address, size) ranges every
+        interval_frames frames, only sending the bytes that changed. Returns the subscription id,
+        use receive_update to wait for the pushed contents.
+        """
+        request_data = struct.pack("II", interval_frames, len(ranges)) + self._pack_ranges(ranges)
+        request, request_id = self._generate_header(RequestType.Subscribe, len(request_data))
+        request += request_data
+        self.socket.sendto(request, (self.address, CITRA_PORT))
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.Subscribe)
+
+        if reply_data:
+            subscription_id = struct.unpack("I", reply_data)[0]
+            self.subscriptions[subscription_id] = {
+                "ranges": ranges,
+                "data": bytearray(sum(size for _, size in ranges)),
+                "sequence": None,
+            }
+            return subscription_id
+        return None
+
+    def unsubscribe(self, subscription_id):
+        request_data = struct.pack("II", subscription_id, 0)
+        request, request_id = self._generate_header(RequestType.Unsubscribe, len(request_data))
+        request += request_data
+        self.socket.sendto(request, (self.address, CITRA_PORT))
+        self.subscriptions.pop(subscription_id, None)
+
+        # Updates may still be in flight, skip them until the reply arrives
+        while True:
+            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            if self._read_and_validate_header(raw_reply, request_id, RequestType.Unsubscribe) is not None:
+                return True
+
+    def receive_update(self):
+        """
+        Waits for the next update of any subscription and returns its id and the contents of its
+        ranges. Lost updates are detected through the sequence number, the contents are then
+        wrong until the next full update, which the server sends periodically.
+        """
+        while True:
+            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            reply_type = struct.unpack("I", raw_reply[8:12])[0]
+            if reply_type != RequestType.SubscriptionUpdate:
+                continue
+            reply_data = raw_reply[4*4:]
+            subscription_id, sequence, encoding = struct.unpack("III", reply_data[:12])
+            subscription = self.subscriptions.get(subscription_id)
+            if subscription is None:
+                continue
+
+            update = reply_data[12:]
+            data = subscription["data"]
+            if encoding == SubscriptionEncoding.Full:
+                data[:] = update
+            elif subscription["sequence"] is None or sequence != subscription["sequence"] + 1:
+                # Missed an update, wait for the next full one
+                subscription["sequence"] = None
+                continue
+            else:
+                offset = 0
+                while offset < len(update):
+                    run_offset, run_size = struct.unpack("HH", update[offset:offset + 4])
+                    offset += 4
+                    data[run_offset:run_offset + run_size] = update[offset:offset + run_size]
+                    offset += run_size
+            subscription["sequence"] = sequence
+            return subscription_id, self._split_ranges(data, subscription["ranges"])
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
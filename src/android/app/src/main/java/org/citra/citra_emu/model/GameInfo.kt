@@ -40,5 +40,10 @@ class GameInfo(path: String) {
     companion object {
         @JvmStatic
         private external fun initialize(path: String): Long
+
+        // Writes the metadata read by the GameInfo instances to the title index on disk, dropping
+        // the files that were not looked up since the last call. Call it after a full scan.
+        @JvmStatic
+        external fun saveIndex()
     }
 }
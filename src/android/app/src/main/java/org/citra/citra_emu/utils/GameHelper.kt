@@ -34,6 +34,7 @@ object GameHelper {
         NativeLibrary.getInstalledGamePaths().forEach {
             games.add(getGame(Uri.parse(it), isInstalled = true, addedToLibrary = true))
         }
+        GameInfo.saveIndex()
 
         // Cache list of games found on disk
         val serializedGames = mutableSetOf<String>()
@@ -132,6 +132,7 @@ void Config::ReadValues() {
 
     // Core
     ReadSetting("Core", Settings::values.use_cpu_jit);
+    ReadSetting("Core", Settings::values.use_fastmem);
     ReadSetting("Core", Settings::values.cpu_clock_percentage);
 
     // Renderer
@@ -140,6 +141,7 @@ void Config::ReadValues() {
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_mul", false);
     ReadSetting("Renderer", Settings::values.graphics_api);
     ReadSetting("Renderer", Settings::values.async_presentation);
+    ReadSetting("Renderer", Settings::values.use_gpu_thread);
     ReadSetting("Renderer", Settings::values.async_shader_compilation);
     ReadSetting("Renderer", Settings::values.spirv_shader_gen);
     ReadSetting("Renderer", Settings::values.disable_spirv_optimizer);
@@ -220,6 +222,8 @@ void Config::ReadValues() {
 
     // Storage
     ReadSetting("Storage", Settings::values.compress_cia_installs);
+    ReadSetting("Storage", Settings::values.use_artic_disk_cache);
+    ReadSetting("Storage", Settings::values.artic_disk_cache_size_mb);
 
     // Utility
     ReadSetting("Utility", Settings::values.dump_textures);
@@ -94,6 +94,11 @@ use_artic_base_controller=
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether the JIT accesses guest memory through a host mapping of the emulated address space.
+# Only supported on Linux and Android hosts with 4 KiB pages.
+# 0 (default): Off, 1: On
+use_fastmem =
+
 # Change the Clock Frequency of the emulated 3DS CPU.
 # Underclocking can increase the performance of the game at the risk of freezing.
 # Overclocking may fix lag that happens on console, but also comes with the risk of freezing.
@@ -129,6 +134,11 @@ shaders_accurate_mul =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Whether to process GPU commands on a separate thread, overlapping them with CPU emulation.
+# Only supported by the software renderer. Disable for games that show glitches with it.
+# 0 (default): Off, 1: On
+use_gpu_thread =
+
 # Overrides the sampling filter used by games. This can be useful in certain
 # cases with poorly behaved games when upscaling.
 # 0 (default): Game Controlled, 1: Nearest Neighbor, 2: Linear
@@ -215,6 +225,13 @@ layout_option =
 # 0 (default): Do not compress, 1: Compress
 compress_cia_installs =
 
+# Whether to keep content streamed through Artic Base in a persistent on-disk cache
+# 0 (default): No, 1: Yes
+use_artic_disk_cache =
+
+# Maximum size of the Artic Base disk cache, in megabytes. Default: 2048
+artic_disk_cache_size_mb =
+
 # Position of the performance overlay
 # 0: Top Left
 # 1: Center Top
@@ -12,6 +12,7 @@
 #include "core/hle/service/fs/archive.h"
 #include "core/loader/loader.h"
 #include "core/loader/smdh.h"
+#include "core/loader/title_index.h"
 #include "jni/android_common/android_common.h"
 #include "jni/id_cache.h"
 
@@ -27,47 +28,49 @@ struct GameInfoData {
     std::string file_type = "";
 };
 
-GameInfoData* GetNewGameInfoData(const std::string& path) {
-    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(path);
-    u64 program_id = 0;
-    bool is_encrypted = false;
+Loader::TitleIndex& GetTitleIndex() {
+    static Loader::TitleIndex title_index;
+    return title_index;
+}
 
-    if (!loader || loader->ReadProgramId(program_id) != Loader::ResultStatus::Success) {
+GameInfoData* GetNewGameInfoData(const std::string& path) {
+    auto& title_index = GetTitleIndex();
+    const auto entry = title_index.Get(path);
+    if (!entry || !entry->has_program_id) {
         GameInfoData* gid = new GameInfoData();
         memset(&gid->smdh, 0, sizeof(Loader::SMDH));
         return gid;
     }
 
-    std::vector<u8> smdh = [program_id, &loader, &is_encrypted]() -> std::vector<u8> {
-        std::vector<u8> original_smdh;
-        auto result = loader->ReadIcon(original_smdh);
-        if (result != Loader::ResultStatus::Success) {
-            is_encrypted = result == Loader::ResultStatus::ErrorEncrypted;
+    const u64 program_id = entry->program_id;
+    bool is_encrypted = false;
+
+    std::vector<u8> smdh = [program_id, &entry, &title_index, &is_encrypted]() -> std::vector<u8> {
+        if (entry->is_encrypted) {
+            is_encrypted = true;
             return {};
         }
 
         if (program_id < 0x00040000'00000000 || program_id > 0x00040000'FFFFFFFF)
-            return original_smdh;
+            return entry->smdh;
 
         u64 update_tid = (program_id & 0xFFFFFFFFULL) | UPDATE_TID_HIGH;
         std::string update_path =
             Service::AM::GetTitleContentPath(Service::FS::MediaType::SDMC, update_tid);
 
         if (!FileUtil::Exists(update_path))
-            return original_smdh;
+            return entry->smdh;
 
-        std::unique_ptr<Loader::AppLoader> update_loader = Loader::GetLoader(update_path);
+        const auto update_entry = title_index.Get(update_path);
 
-        if (!update_loader)
-            return original_smdh;
+        if (!update_entry)
+            return entry->smdh;
 
-        std::vector<u8> update_smdh;
-        result = update_loader->ReadIcon(update_smdh);
-        if (result != Loader::ResultStatus::Success) {
-            is_encrypted = result == Loader::ResultStatus::ErrorEncrypted;
+        if (update_entry->is_encrypted) {
+            is_encrypted = true;
             return {};
         }
-        return update_smdh;
+        return update_entry->smdh;
     }();
 
     GameInfoData* gid = new GameInfoData();
@@ -79,7 +82,7 @@ GameInfoData* GetNewGameInfoData(const std::string& path) {
     gid->loaded = true;
     gid->is_encrypted = is_encrypted;
     gid->title_id = program_id;
-    gid->file_type = Loader::GetFileTypeString(loader->GetFileType(), loader->IsFileCompressed());
+    gid->file_type = Loader::GetFileTypeString(entry->file_type, entry->is_compressed);
 
     return gid;
 }
@@ -98,6 +101,12 @@ JNIEXPORT jlong JNICALL Java_org_citra_citra_1emu_model_GameInfo_initialize(JNIE
     return reinterpret_cast<jlong>(game_info_data);
 }
 
+JNIEXPORT void JNICALL Java_org_citra_citra_1emu_model_GameInfo_saveIndex(JNIEnv* env, jclass) {
+    auto& title_index = GetTitleIndex();
+    title_index.RemoveUnseen();
+    title_index.Save();
+}
+
 JNIEXPORT jboolean JNICALL Java_org_citra_citra_1emu_model_GameInfo_isValid(JNIEnv* env,
                                                                             jobject obj) {
     return GetPointer(env, obj)->loaded;
@@ -25,6 +25,10 @@ constexpr char help_string[] =
     // TODO: Move -m outside of this check when it is implemented in Qt frontend
     "-m, --multiplayer [nick:password@address:port]   Nickname, password, address and port for "
     "multiplayer (currently only usable with SDL frontend)\n"
+    "    --replay-trace [path]   Replay a CiTrace through the PICA emulation and report the time "
+    "spent on every frame (currently only usable with SDL frontend)\n"
+    "    --null-rasterizer       Discard triangles instead of rasterizing them when replaying a "
+    "CiTrace\n"
 #endif
 #ifdef ENABLE_ROOM
     "    --room                  Utilize dedicated multiplayer room functionality (equivalent to "
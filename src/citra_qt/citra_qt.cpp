@@ -2277,14 +2277,18 @@ void GMainWindow::InstallCIA(QStringList filepaths) {
     progress_bar->setMaximum(INT_MAX);
 
     (void)QtConcurrent::run([&, filepaths] {
-        Service::AM::InstallStatus status;
+        std::vector<std::string> paths;
+        paths.reserve(filepaths.size());
+        for (const auto& current_path : filepaths) {
+            paths.push_back(current_path.toStdString());
+        }
         const auto cia_progress = [&](std::size_t written, std::size_t total) {
             emit UpdateProgress(written, total);
         };
-        for (const auto& current_path : filepaths) {
-            status = Service::AM::InstallCIA(current_path.toStdString(), cia_progress);
-            emit CIAInstallReport(status, current_path);
-        }
+        const auto cia_report = [&](const std::string& path, Service::AM::InstallStatus status) {
+            emit CIAInstallReport(status, QString::fromStdString(path));
+        };
+        Service::AM::InstallCIAs(paths, cia_progress, cia_report);
         emit CIAInstallFinished();
     });
 }
@@ -2814,14 +2818,23 @@ void GMainWindow::OnLoadAmiibo() {
         return;
     }
 
-    std::scoped_lock lock{system.Kernel().GetHLELock()};
-    if (nfc->IsTagActive()) {
+    // Only hold the HLE lock while querying the service, not while the dialogs are open, so that
+    // emulation does not stall behind the UI.
+    bool is_tag_active;
+    bool is_searching;
+    {
+        const auto lock = system.Kernel().AcquireHLELock();
+        is_tag_active = nfc->IsTagActive();
+        is_searching = nfc->IsSearchingForAmiibos();
+    }
+
+    if (is_tag_active) {
         QMessageBox::warning(this, tr("Error opening amiibo data file"),
                              tr("A tag is already in use."));
         return;
     }
 
-    if (!nfc->IsSearchingForAmiibos()) {
+    if (!is_searching) {
         QMessageBox::warning(this, tr("Error opening amiibo data file"),
                              tr("Application is not looking for amiibos."));
         return;
@@ -2845,8 +2858,13 @@ void GMainWindow::LoadAmiibo(const QString& filename) {
         return;
     }
 
-    std::scoped_lock lock{system.Kernel().GetHLELock()};
-    if (!nfc->LoadAmiibo(filename.toStdString())) {
+    bool loaded;
+    {
+        const auto lock = system.Kernel().AcquireHLELock();
+        loaded = nfc->LoadAmiibo(filename.toStdString());
+    }
+
+    if (!loaded) {
         QMessageBox::warning(this, tr("Error opening amiibo data file"),
                              tr("Unable to open amiibo file \"%1\" for reading.").arg(filename));
         return;
@@ -2862,8 +2880,10 @@ void GMainWindow::OnRemoveAmiibo() {
         return;
     }
 
-    std::scoped_lock lock{system.Kernel().GetHLELock()};
-    nfc->RemoveAmiibo();
+    {
+        const auto lock = system.Kernel().AcquireHLELock();
+        nfc->RemoveAmiibo();
+    }
     ui->action_Remove_Amiibo->setEnabled(false);
 }
 
@@ -11,11 +11,11 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QPushButton>
-#include <nihstro/float24.h>
 #include "citra_qt/debugger/graphics/graphics_tracing.h"
 #include "common/common_types.h"
 #include "core/core.h"
 #include "core/tracer/recorder.h"
+#include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
 #include "video_core/pica/pica_core.h"
 
@@ -62,46 +62,7 @@ void GraphicsTracingWidget::StartRecording() {
     if (!context)
         return;
 
-    auto& pica = system.GPU().PicaCore();
-    auto shader_binary = pica.vs_setup.program_code;
-    auto swizzle_data = pica.vs_setup.swizzle_data;
-
-    // Encode floating point numbers to 24-bit values
-    // TODO: Drop this explicit conversion once we store float24 values bit-correctly internally.
-    std::array<u32, 4 * 16> default_attributes;
-    for (u32 i = 0; i < 16; ++i) {
-        for (u32 comp = 0; comp < 3; ++comp) {
-            default_attributes[4 * i + comp] =
-                nihstro::to_float24(pica.input_default_attributes[i][comp].ToFloat32());
-        }
-    }
-
-    std::array<u32, 4 * 96> vs_float_uniforms;
-    for (u32 i = 0; i < 96; ++i) {
-        for (u32 comp = 0; comp < 3; ++comp) {
-            vs_float_uniforms[4 * i + comp] =
-                nihstro::to_float24(pica.vs_setup.uniforms.f[i][comp].ToFloat32());
-        }
-    }
-
-    CiTrace::Recorder::InitialState state;
-
-    const auto copy = [&](std::vector<u32>& dest, auto& data) {
-        dest.resize(sizeof(data));
-        std::memcpy(dest.data(), std::addressof(data), sizeof(data));
-    };
-
-    copy(state.pica_registers, pica.regs);
-    copy(state.lcd_registers, pica.regs_lcd);
-    copy(state.default_attributes, default_attributes);
-    copy(state.vs_program_binary, shader_binary);
-    copy(state.vs_swizzle_data, swizzle_data);
-    copy(state.vs_float_uniforms, vs_float_uniforms);
-    // copy(TODO: Not implemented, std::back_inserter(state.gs_program_binary));
-    // copy(TODO: Not implemented, std::back_inserter(state.gs_swizzle_data));
-    // copy(TODO: Not implemented, std::back_inserter(state.gs_float_uniforms));
-
-    context->recorder = std::make_shared<CiTrace::Recorder>(state);
+    context->recorder = Pica::DebugUtils::CreateTraceRecorder(system.GPU().PicaCore());
 
     emit SetStartTracingButtonEnabled(false);
     emit SetStopTracingButtonEnabled(true);
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <QBoxLayout>
 #include <QFileDialog>
@@ -520,10 +521,12 @@ void GraphicsVertexShaderWidget::Reload(bool replace_vertex_data, const void* ve
     u32 entry_point = pica.regs.internal.vs.main_offset;
     info.labels.insert({entry_point, "main"});
 
-    // Generate debug information
+    // Generate debug information. The engine points the setup at its own program cache, so run
+    // it on a copy to leave the setup used by the GPU untouched.
     Pica::Shader::InterpreterEngine shader_engine;
-    shader_engine.SetupBatch(pica.vs_setup, entry_point);
-    debug_data = shader_engine.ProduceDebugInfo(pica.vs_setup, input_vertex, pica.regs.internal.vs);
+    const auto shader_setup = std::make_unique<Pica::ShaderSetup>(pica.vs_setup);
+    shader_engine.SetupBatch(*shader_setup, entry_point);
+    debug_data = shader_engine.ProduceDebugInfo(*shader_setup, input_vertex, pica.regs.internal.vs);
 
     // Reload widget state
     for (int attr = 0; attr < num_attributes; ++attr) {
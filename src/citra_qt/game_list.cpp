@@ -37,6 +37,7 @@
 #include "core/file_sys/archive_source_sd_savedata.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/fs/archive.h"
+#include "core/loader/title_index.h"
 #include "qcursor.h"
 
 GameListSearchField::KeyReleaseEater::KeyReleaseEater(GameList* gamelist, QObject* parent)
@@ -307,7 +308,8 @@ void GameList::OnFilterCloseClicked() {
 }
 
 GameList::GameList(PlayTime::PlayTimeManager& play_time_manager_, GMainWindow* parent)
-    : QWidget{parent}, play_time_manager{play_time_manager_} {
+    : QWidget{parent}, title_index{std::make_shared<Loader::TitleIndex>()},
+      play_time_manager{play_time_manager_} {
     watcher = new QFileSystemWatcher(this);
     connect(watcher, &QFileSystemWatcher::directoryChanged, this, &GameList::RefreshGameDirectory,
             Qt::UniqueConnection);
@@ -1006,7 +1008,8 @@ void GameList::PopulateAsync(QVector<UISettings::GameDir>& game_dirs) {
 
     emit ShouldCancelWorker();
 
-    GameListWorker* worker = new GameListWorker(game_dirs, compatibility_list, play_time_manager);
+    GameListWorker* worker =
+        new GameListWorker(game_dirs, compatibility_list, play_time_manager, title_index);
 
     connect(worker, &GameListWorker::EntryReady, this, &GameList::AddEntry, Qt::QueuedConnection);
     connect(worker, &GameListWorker::DirEntryReady, this, &GameList::AddDirEntry,
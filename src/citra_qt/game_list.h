@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <QMenu>
 #include <QPushButton>
 #include <QString>
@@ -14,6 +15,10 @@
 #include "common/play_time_manager.h"
 #include "uisettings.h"
 
+namespace Loader {
+class TitleIndex;
+}
+
 namespace Service::FS {
 enum class MediaType : u32;
 }
@@ -146,6 +151,7 @@ private:
     GameListWorker* current_worker = nullptr;
     QFileSystemWatcher* watcher = nullptr;
     CompatibilityList compatibility_list;
+    std::shared_ptr<Loader::TitleIndex> title_index;
 
     friend class GameListSearchField;
 
@@ -22,6 +22,7 @@
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/fs/archive.h"
 #include "core/loader/loader.h"
+#include "core/loader/title_index.h"
 
 namespace {
 bool HasSupportedFileExtension(const std::string& file_name) {
@@ -32,18 +33,18 @@ bool HasSupportedFileExtension(const std::string& file_name) {
 
 GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
                                const CompatibilityList& compatibility_list,
-                               const PlayTime::PlayTimeManager& play_time_manager_)
+                               const PlayTime::PlayTimeManager& play_time_manager_,
+                               std::shared_ptr<Loader::TitleIndex> title_index_)
     : game_dirs(game_dirs), compatibility_list(compatibility_list),
-      play_time_manager{play_time_manager_} {}
+      play_time_manager{play_time_manager_}, title_index{std::move(title_index_)} {}
 
 GameListWorker::~GameListWorker() = default;
 
-void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
-                                             GameListDir* parent_dir,
-                                             Service::FS::MediaType media_type) {
-    const auto callback = [this, recursion, parent_dir,
-                           media_type](u64* num_entries_out, const std::string& directory,
-                                       const std::string& virtual_name) -> bool {
+void GameListWorker::CollectFstEntries(const std::string& dir_path, unsigned int recursion,
+                                       std::vector<std::string>& paths) {
+    const auto callback = [this, recursion, &paths](u64* num_entries_out,
+                                                    const std::string& directory,
+                                                    const std::string& virtual_name) -> bool {
         if (stop_processing) {
             // Breaks the callback loop.
             return false;
@@ -52,86 +53,94 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
+            paths.push_back(physical_name);
+        } else if (is_dir && recursion > 0) {
+            watch_list.append(QString::fromStdString(physical_name));
+            CollectFstEntries(physical_name, recursion - 1, paths);
+        }
 
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
-                return true;
-            }
+        return true;
+    };
 
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh;
-            // Look for an update icon if available
-            if (!(program_id & ~0x00040000FFFFFFFF)) {
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
-                if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
-                }
-            }
+    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+}
 
-            if (!Loader::IsValidSMDH(smdh)) {
-                // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
-            }
+void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
+                                             GameListDir* parent_dir,
+                                             Service::FS::MediaType media_type) {
+    std::vector<std::string> paths;
+    CollectFstEntries(dir_path, recursion, paths);
+
+    // Only the files that changed since the last scan are opened, in parallel
+    const auto entries = title_index->Get(paths, &stop_processing);
 
-            const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
-            if (Loader::IsValidSMDH(smdh)) {
-                if (system_title) {
-                    auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
-                    if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
-                        // Skip system titles without the visible flag.
-                        return true;
-                    }
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        if (stop_processing) {
+            return;
+        }
+        if (!entries[i]) {
+            continue;
+        }
+
+        const std::string& physical_name = paths[i];
+        const Loader::TitleIndexEntry& entry = *entries[i];
+        if (!entry.is_executable && !entry.is_encrypted) {
+            continue;
+        }
+
+        const u64 program_id = entry.program_id;
+
+        std::vector<u8> smdh;
+        // Look for an update icon if available
+        if (!(program_id & ~0x00040000FFFFFFFF)) {
+            std::string update_path = Service::AM::GetTitleContentPath(
+                Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
+            if (FileUtil::Exists(update_path)) {
+                if (const auto update_entry = title_index->Get(update_path)) {
+                    smdh = update_entry->smdh;
                 }
-            } else if (UISettings::values.game_list_hide_no_icon || system_title) {
-                // Skip this invalid entry
-                return true;
             }
+        }
 
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility(QStringLiteral("99"));
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id, media_type,
-                                         res == Loader::ResultStatus::ErrorEncrypted),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(QString::fromStdString(Loader::GetFileTypeString(
-                        loader->GetFileType(), loader->IsFileCompressed()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                    new GameListItemPlayTime(play_time_manager.GetPlayTime(program_id)),
-                },
-                parent_dir);
-
-        } else if (is_dir && recursion > 0) {
-            watch_list.append(QString::fromStdString(physical_name));
-            AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir, media_type);
+        if (!Loader::IsValidSMDH(smdh)) {
+            // Use the original smdh if there is no valid update smdh
+            smdh = entry.smdh;
         }
 
-        return true;
-    };
+        const auto system_title = ((program_id >> 32) & 0xFFFFFFFF) == 0x00040010;
+        if (Loader::IsValidSMDH(smdh)) {
+            if (system_title) {
+                auto smdh_struct = reinterpret_cast<Loader::SMDH*>(smdh.data());
+                if (!(smdh_struct->flags & Loader::SMDH::Flags::Visible)) {
+                    // Skip system titles without the visible flag.
+                    continue;
+                }
+            }
+        } else if (UISettings::values.game_list_hide_no_icon || system_title) {
+            // Skip this invalid entry
+            continue;
+        }
 
-    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+        auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
+
+        // The game list uses this as compatibility number for untested games
+        QString compatibility(QStringLiteral("99"));
+        if (it != compatibility_list.end())
+            compatibility = it->second.first;
+
+        emit EntryReady(
+            {
+                new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
+                                     entry.extdata_id, media_type, entry.is_encrypted),
+                new GameListItemCompat(compatibility),
+                new GameListItemRegion(smdh),
+                new GameListItem(QString::fromStdString(
+                    Loader::GetFileTypeString(entry.file_type, entry.is_compressed))),
+                new GameListItemSize(entry.size),
+                new GameListItemPlayTime(play_time_manager.GetPlayTime(program_id)),
+            },
+            parent_dir);
+    }
 }
 
 void GameListWorker::run() {
@@ -175,6 +184,11 @@ void GameListWorker::run() {
         }
     }
 
+    if (!stop_processing) {
+        // Forget the files that are gone, a cancelled scan did not look at all of them
+        title_index->RemoveUnseen();
+    }
+    title_index->Save();
     emit Finished(watch_list);
 }
 
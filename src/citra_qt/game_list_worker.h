@@ -11,6 +11,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -20,6 +21,10 @@
 #include "common/common_types.h"
 #include "common/play_time_manager.h"
 
+namespace Loader {
+class TitleIndex;
+}
+
 namespace Service::FS {
 enum class MediaType : u32;
 }
@@ -36,7 +41,8 @@ class GameListWorker : public QObject, public QRunnable {
 public:
     GameListWorker(QVector<UISettings::GameDir>& game_dirs,
                    const CompatibilityList& compatibility_list,
-                   const PlayTime::PlayTimeManager& play_time_manager_);
+                   const PlayTime::PlayTimeManager& play_time_manager_,
+                   std::shared_ptr<Loader::TitleIndex> title_index_);
     ~GameListWorker() override;
 
     /// Starts the processing of directory tree information.
@@ -61,12 +67,16 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// Appends the supported files found in dir_path to paths, and its subdirectories to watch_list
+    void CollectFstEntries(const std::string& dir_path, unsigned int recursion,
+                           std::vector<std::string>& paths);
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir, Service::FS::MediaType media_type);
 
     QVector<UISettings::GameDir>& game_dirs;
     const CompatibilityList& compatibility_list;
     const PlayTime::PlayTimeManager& play_time_manager;
+    std::shared_ptr<Loader::TitleIndex> title_index;
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
@@ -40,9 +40,11 @@
 #include "core/frontend/framebuffer_layout.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cfg/cfg.h"
+#include "core/memory.h"
 #include "core/movie.h"
 #include "input_common/main.h"
 #include "network/network.h"
+#include "video_core/debug_utils/trace_player.h"
 #include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
 
@@ -170,6 +172,48 @@ static void OnStatusMessageReceived(const Network::StatusMessageEntry& msg) {
         std::cout << std::endl << "* " << message << std::endl << std::endl;
 }
 
+/// Replays a CiTrace without loading a ROM and prints the time spent on every frame.
+static int ReplayTrace(const std::string& path, bool rasterize) {
+    Memory::MemorySystem memory{Core::System::GetInstance()};
+    CiTrace::Player player{memory, rasterize};
+    if (!player.Load(path)) {
+        return 1;
+    }
+
+    const auto frames = player.Play();
+    if (frames.empty()) {
+        std::cout << "The trace does not contain any frames" << std::endl;
+        return 1;
+    }
+
+    const auto to_ms = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+    const auto print_frame = [&](std::string_view name, const CiTrace::Player::FrameStats& frame) {
+        std::cout << fmt::format("{:>8}: {:9.3f} ms total, {:9.3f} ms commands, {:9.3f} ms "
+                                 "shading, {:9.3f} ms rasterization, {} triangles",
+                                 name, to_ms(frame.total), to_ms(frame.CommandProcessing()),
+                                 to_ms(frame.vertex_shading), to_ms(frame.rasterization),
+                                 frame.triangles)
+                  << std::endl;
+    };
+
+    CiTrace::Player::FrameStats average{};
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        print_frame(fmt::format("frame {}", i), frames[i]);
+        average.total += frames[i].total;
+        average.vertex_shading += frames[i].vertex_shading;
+        average.rasterization += frames[i].rasterization;
+        average.triangles += frames[i].triangles;
+    }
+    average.total /= frames.size();
+    average.vertex_shading /= frames.size();
+    average.rasterization /= frames.size();
+    average.triangles /= frames.size();
+    print_frame("average", average);
+    return 0;
+}
+
 /// Application entry point
 void LaunchSdlFrontend(int argc, char** argv) {
     Common::Log::Initialize();
@@ -184,6 +228,8 @@ void LaunchSdlFrontend(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    std::string replay_trace;
+    bool replay_rasterize = true;
 
     char* endarg;
 #ifdef _WIN32
@@ -216,6 +262,8 @@ void LaunchSdlFrontend(int argc, char** argv) {
         {"multiplayer", required_argument, 0, 'm'},
         {"version", no_argument, 0, 'v'},
         {"windowed", no_argument, 0, 'w'},
+        {"replay-trace", required_argument, 0, 't'},
+        {"null-rasterizer", no_argument, 0, 'z'},
         {0, 0, 0, 0},
     };
 
@@ -264,6 +312,12 @@ void LaunchSdlFrontend(int argc, char** argv) {
             case 'a':
                 movie_record_author = optarg;
                 break;
+            case 't':
+                replay_trace = optarg;
+                break;
+            case 'z':
+                replay_rasterize = false;
+                break;
             case 'm': {
                 use_multiplayer = true;
                 const std::string str_arg(optarg);
@@ -319,6 +373,10 @@ void LaunchSdlFrontend(int argc, char** argv) {
     MicroProfileOnThreadCreate("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
 
+    if (!replay_trace.empty()) {
+        exit(ReplayTrace(replay_trace, replay_rasterize));
+    }
+
     if (filepath.empty()) {
         LOG_CRITICAL(Frontend, "Failed to load ROM: No ROM specified");
         exit(-1);
@@ -130,6 +130,7 @@ void SdlConfig::ReadValues() {
 
     // Core
     ReadSetting("Core", Settings::values.use_cpu_jit);
+    ReadSetting("Core", Settings::values.use_fastmem);
     ReadSetting("Core", Settings::values.cpu_clock_percentage);
 
     // Renderer
@@ -138,6 +139,7 @@ void SdlConfig::ReadValues() {
     ReadSetting("Renderer", Settings::values.spirv_shader_gen);
     ReadSetting("Renderer", Settings::values.async_shader_compilation);
     ReadSetting("Renderer", Settings::values.async_presentation);
+    ReadSetting("Renderer", Settings::values.use_gpu_thread);
     ReadSetting("Renderer", Settings::values.use_gles);
     ReadSetting("Renderer", Settings::values.use_hw_shader);
     ReadSetting("Renderer", Settings::values.shaders_accurate_mul);
@@ -214,6 +216,8 @@ void SdlConfig::ReadValues() {
     ReadSetting("Data Storage", Settings::values.use_virtual_sd);
     ReadSetting("Data Storage", Settings::values.use_custom_storage);
     ReadSetting("Data Storage", Settings::values.compress_cia_installs);
+    ReadSetting("Data Storage", Settings::values.use_artic_disk_cache);
+    ReadSetting("Data Storage", Settings::values.artic_disk_cache_size_mb);
 
     if (Settings::values.use_custom_storage) {
         FileUtil::UpdateUserPath(FileUtil::UserPath::NANDDir,
@@ -386,6 +390,11 @@ void SdlConfig::ReadValues() {
         sdl2_config->GetString("Video Dumping", "audio_encoder_options", "");
     Settings::values.audio_bitrate =
         sdl2_config->GetInteger("Video Dumping", "audio_bitrate", 64000);
+
+    Settings::values.video_frame_queue_depth = static_cast<u32>(
+        sdl2_config->GetInteger("Video Dumping", "video_frame_queue_depth", 4));
+    Settings::values.drop_video_frames =
+        sdl2_config->GetBoolean("Video Dumping", "drop_video_frames", false);
 }
 
 void SdlConfig::Reload() {
@@ -91,6 +91,11 @@ udp_pad_index=
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether the JIT accesses guest memory through a host mapping of the emulated address space.
+# Only supported on Linux and Android hosts with 4 KiB pages.
+# 0 (default): Off, 1: On
+use_fastmem =
+
 # Change the Clock Frequency of the emulated 3DS CPU.
 # Underclocking can increase the performance of the game at the risk of freezing.
 # Overclocking may fix lag that happens on console, but also comes with the risk of freezing.
@@ -118,6 +123,11 @@ shaders_accurate_mul =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Whether to process GPU commands on a separate thread, overlapping them with CPU emulation.
+# Only supported by the software renderer. Disable for games that show glitches with it.
+# 0 (default): Off, 1: On
+use_gpu_thread =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
@@ -290,6 +300,13 @@ sdmc_directory =
 # empty (default) will use the user_path
 nand_directory =
 
+# Whether to keep content streamed through Artic Base in a persistent on-disk cache
+# 0 (default): No, 1: Yes
+use_artic_disk_cache =
+
+# Maximum size of the Artic Base disk cache, in megabytes. Default: 2048
+artic_disk_cache_size_mb =
+
 [System]
 # The system model that Citra will try to emulate
 # 0: Old 3DS, 1: New 3DS (default)
@@ -397,5 +414,12 @@ audio_encoder_options =
 
 # Audio bitrate, default: 64000
 audio_bitrate =
+
+# Number of video frames that can wait for the encoder, default: 4
+video_frame_queue_depth =
+
+# What to do when the encoder falls behind and the frame queue is full
+# 0 (default): Wait for the encoder, 1: Drop the frame
+drop_video_frames =
 )";
 }
@@ -413,6 +413,26 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+u64 GetModificationTime(const std::string& filename) {
+#ifdef _WIN32
+    struct _stat64 buf;
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0) {
+        return static_cast<u64>(buf.st_mtime);
+    }
+#elif ANDROID
+    // Not exposed through the Android storage access framework
+    return 0;
+#else
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) == 0) {
+        return static_cast<u64>(buf.st_mtime);
+    }
+#endif
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 u64 GetSize(const int fd) {
     struct stat buf;
     if (fstat(fd, &buf) != 0) {
@@ -1240,8 +1260,31 @@ static std::size_t pread(int fd, void* buf, std::size_t count, uint64_t offset)
     }
     return read_bytes;
 }
+
+static std::size_t pwrite(int fd, const void* buf, std::size_t count, uint64_t offset) {
+    long unsigned int written_bytes = 0;
+    OVERLAPPED overlapped = {0};
+    HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+
+    overlapped.OffsetHigh = static_cast<uint32_t>(offset >> 32);
+    overlapped.Offset = static_cast<uint32_t>(offset & 0xFFFF'FFFFLL);
+    LARGE_INTEGER orig, dummy;
+    // Same as pread, the file pos pointer is restored but is undefined with multiple threads.
+    SetFilePointerEx(file, {}, &orig, FILE_CURRENT);
+    SetLastError(0);
+    bool ret = WriteFile(file, buf, static_cast<uint32_t>(count), &written_bytes, &overlapped);
+    DWORD last_error = GetLastError();
+    SetFilePointerEx(file, orig, &dummy, FILE_BEGIN);
+
+    if (!ret) {
+        errno = last_error;
+        return std::numeric_limits<std::size_t>::max();
+    }
+    return written_bytes;
+}
 #else
 #define pread ::pread
+#define pwrite ::pwrite
 #endif
 
 std::size_t IOFile::ReadAtImpl(void* data, std::size_t length, std::size_t data_size,
@@ -1275,6 +1318,22 @@ std::size_t IOFile::WriteImpl(const void* data, std::size_t length, std::size_t
     return std::fwrite(data, data_size, length, m_file);
 }
 
+std::size_t IOFile::WriteAtImpl(const void* data, std::size_t length, std::size_t data_size,
+                                std::size_t offset) {
+    if (!IsOpen()) {
+        m_good = false;
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    DEBUG_ASSERT(data != nullptr);
+
+    return pwrite(fileno(m_file), data, data_size * length, offset);
+}
+
 bool IOFile::Resize(u64 size) {
     if (!IsOpen() || 0 !=
 #ifdef _WIN32
@@ -1315,10 +1374,13 @@ struct CryptoIOFileImpl {
                            std::size_t offset) {
         std::size_t res = f.IOFile::ReadAtImpl(data, length, data_size, offset);
         if (res != std::numeric_limits<std::size_t>::max() && res != 0) {
-            d.Seek(offset);
-            d.ProcessData(reinterpret_cast<CryptoPP::byte*>(data),
-                          reinterpret_cast<CryptoPP::byte*>(data), length * data_size);
-            e.Seek(f.IOFile::Tell());
+            // Use a local cipher so that positional reads neither race with each other nor
+            // disturb the keystream position of the sequential reads and writes.
+            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption local_d;
+            local_d.SetKeyWithIV(key.data(), key.size(), iv.data());
+            local_d.Seek(offset);
+            local_d.ProcessData(reinterpret_cast<CryptoPP::byte*>(data),
+                                reinterpret_cast<CryptoPP::byte*>(data), length * data_size);
         }
         return res;
     }
@@ -1337,6 +1399,17 @@ struct CryptoIOFileImpl {
         return res;
     }
 
+    std::size_t WriteAtImpl(CryptoIOFile& f, const void* data, std::size_t length,
+                            std::size_t data_size, std::size_t offset) {
+        std::vector<u8> encrypted(length * data_size);
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption local_e;
+        local_e.SetKeyWithIV(key.data(), key.size(), iv.data());
+        local_e.Seek(offset);
+        local_e.ProcessData(encrypted.data(), reinterpret_cast<const CryptoPP::byte*>(data),
+                            encrypted.size());
+        return f.IOFile::WriteAtImpl(encrypted.data(), length, data_size, offset);
+    }
+
     bool SeekImpl(CryptoIOFile& f, s64 off, int origin) {
         bool res = f.IOFile::SeekImpl(off, origin);
         if (res) {
@@ -1377,6 +1450,11 @@ std::size_t CryptoIOFile::WriteImpl(const void* data, std::size_t length, std::s
     return impl->WriteImpl(*this, data, length, data_size);
 }
 
+std::size_t CryptoIOFile::WriteAtImpl(const void* data, std::size_t length, std::size_t data_size,
+                                      std::size_t offset) {
+    return impl->WriteAtImpl(*this, data, length, data_size, offset);
+}
+
 bool CryptoIOFile::SeekImpl(s64 off, int origin) {
     return impl->SeekImpl(*this, off, origin);
 }
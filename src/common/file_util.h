@@ -117,6 +117,9 @@ private:
 // Returns the size of filename (64bit)
 [[nodiscard]] u64 GetSize(const std::string& filename);
 
+// Returns the last modification time of filename in seconds since the epoch, 0 if unavailable
+[[nodiscard]] u64 GetModificationTime(const std::string& filename);
+
 // Overloaded GetSize, accepts file descriptor
 [[nodiscard]] u64 GetSize(int fd);
 
@@ -339,6 +342,22 @@ public:
         return items_written;
     }
 
+    /**
+     * Writes an array of T data at the given offset without using or moving the file pointer,
+     * so several threads may write to different parts of the same file at once.
+     */
+    template <typename T>
+    std::size_t WriteAtArray(const T* data, std::size_t length, std::size_t offset) {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Given array does not consist of trivially copyable objects");
+
+        std::size_t items_written = WriteAtImpl(data, length, sizeof(T), offset);
+        if (items_written != length)
+            m_good = false;
+
+        return items_written;
+    }
+
     template <typename T>
     std::size_t ReadBytes(T* data, std::size_t length) {
         static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
@@ -357,6 +376,12 @@ public:
         return WriteArray(reinterpret_cast<const char*>(data), length);
     }
 
+    template <typename T>
+    std::size_t WriteAtBytes(const T* data, std::size_t length, std::size_t offset) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        return WriteAtArray(reinterpret_cast<const char*>(data), length, offset);
+    }
+
     template <typename T>
     std::size_t WriteObject(const T& object) {
         static_assert(!std::is_pointer_v<T>, "WriteObject arguments must not be a pointer");
@@ -470,6 +495,8 @@ protected:
     virtual std::size_t ReadAtImpl(void* data, std::size_t length, std::size_t data_size,
                                    std::size_t offset);
     virtual std::size_t WriteImpl(const void* data, std::size_t length, std::size_t data_size);
+    virtual std::size_t WriteAtImpl(const void* data, std::size_t length, std::size_t data_size,
+                                    std::size_t offset);
 
     virtual bool SeekImpl(s64 off, int origin);
     virtual u64 TellImpl() const;
@@ -524,6 +551,8 @@ private:
     std::size_t ReadAtImpl(void* data, std::size_t length, std::size_t data_size,
                            std::size_t offset) override;
     std::size_t WriteImpl(const void* data, std::size_t length, std::size_t data_size) override;
+    std::size_t WriteAtImpl(const void* data, std::size_t length, std::size_t data_size,
+                            std::size_t offset) override;
 
     bool SeekImpl(s64 off, int origin) override;
 
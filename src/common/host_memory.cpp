@@ -0,0 +1,161 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HOST_MEMORY_SHAREABLE
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include "common/assert.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+#ifdef HOST_MEMORY_SHAREABLE
+
+namespace {
+
+int CreateSharedMemoryFile(std::size_t size) {
+    // Older Android NDK headers do not declare memfd_create, so use the syscall directly.
+    const int fd = static_cast<int>(syscall(SYS_memfd_create, "HostMemory", 1U /*MFD_CLOEXEC*/));
+    if (fd < 0) {
+        LOG_WARNING(Common_Memory, "memfd_create failed: {}", strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_WARNING(Common_Memory, "ftruncate failed: {}", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // Anonymous namespace
+
+HostMemory::HostMemory(std::size_t backing_size_) : backing_size{backing_size_} {
+    fd = CreateSharedMemoryFile(backing_size);
+    if (fd >= 0) {
+        void* ptr = mmap(nullptr, backing_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED) {
+            backing_base = static_cast<u8*>(ptr);
+            return;
+        }
+        LOG_WARNING(Common_Memory, "Failed to map shared memory: {}", strerror(errno));
+        close(fd);
+        fd = -1;
+    }
+    fallback_buffer = std::make_unique<u8[]>(backing_size);
+    backing_base = fallback_buffer.get();
+}
+
+HostMemory::~HostMemory() {
+    if (fd >= 0) {
+        munmap(backing_base, backing_size);
+        close(fd);
+    }
+}
+
+VirtualArena::VirtualArena(HostMemory& backing_, std::size_t virtual_size_)
+    : backing{backing_}, virtual_size{virtual_size_} {
+    if (!backing.IsShareable()) {
+        return;
+    }
+    void* ptr =
+        mmap(nullptr, virtual_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (ptr == MAP_FAILED) {
+        LOG_WARNING(Common_Memory, "Failed to reserve virtual arena: {}", strerror(errno));
+        return;
+    }
+    virtual_base = static_cast<u8*>(ptr);
+}
+
+VirtualArena::~VirtualArena() {
+    if (virtual_base) {
+        munmap(virtual_base, virtual_size);
+    }
+}
+
+bool VirtualArena::Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length) {
+    ASSERT(virtual_base && virtual_offset + length <= virtual_size &&
+           host_offset + length <= backing.backing_size);
+    if (disabled) {
+        return false;
+    }
+    void* ptr = mmap(virtual_base + virtual_offset, length, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_FIXED, backing.fd, static_cast<off_t>(host_offset));
+    if (ptr == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to map 0x{:X} bytes at arena offset 0x{:X}: {}", length,
+                  virtual_offset, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool VirtualArena::Unmap(std::size_t virtual_offset, std::size_t length) {
+    ASSERT(virtual_base && virtual_offset + length <= virtual_size);
+    // Replace the range with a fresh reservation instead of unmapping it, so that nothing else can
+    // be allocated inside of the arena.
+    void* ptr = mmap(virtual_base + virtual_offset, length, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    if (ptr == MAP_FAILED) {
+        LOG_ERROR(Common_Memory, "Failed to unmap 0x{:X} bytes at arena offset 0x{:X}: {}", length,
+                  virtual_offset, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool VirtualArena::Disable() {
+    ASSERT(virtual_base);
+    disabled = true;
+    // A single reservation over the whole arena also releases the mappings that fragmented it.
+    return Unmap(0, virtual_size);
+}
+
+bool VirtualArena::SupportsPageSize(std::size_t page_size) {
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) == page_size;
+}
+
+#else
+
+HostMemory::HostMemory(std::size_t backing_size_)
+    : backing_size{backing_size_}, fallback_buffer{std::make_unique<u8[]>(backing_size_)} {
+    backing_base = fallback_buffer.get();
+}
+
+HostMemory::~HostMemory() = default;
+
+VirtualArena::VirtualArena(HostMemory& backing_, std::size_t virtual_size_)
+    : backing{backing_}, virtual_size{virtual_size_} {}
+
+VirtualArena::~VirtualArena() = default;
+
+bool VirtualArena::Map(std::size_t, std::size_t, std::size_t) {
+    UNREACHABLE();
+    return false;
+}
+
+bool VirtualArena::Unmap(std::size_t, std::size_t) {
+    UNREACHABLE();
+    return false;
+}
+
+bool VirtualArena::Disable() {
+    UNREACHABLE();
+    return false;
+}
+
+bool VirtualArena::SupportsPageSize(std::size_t) {
+    return false;
+}
+
+#endif
+
+} // namespace Common
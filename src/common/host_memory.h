@@ -0,0 +1,107 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Block of host memory that can additionally be mirrored at other locations of the host address
+ * space through a VirtualArena. Mirroring is only supported on Linux and Android, on other
+ * platforms this behaves like a plain heap allocation.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t backing_size);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    u8* BackingBasePointer() noexcept {
+        return backing_base;
+    }
+
+    const u8* BackingBasePointer() const noexcept {
+        return backing_base;
+    }
+
+    std::size_t BackingSize() const noexcept {
+        return backing_size;
+    }
+
+    /// Returns whether the backing memory can be mapped into a VirtualArena.
+    bool IsShareable() const noexcept {
+        return fd >= 0;
+    }
+
+private:
+    friend class VirtualArena;
+
+    std::size_t backing_size;
+    u8* backing_base = nullptr;
+    int fd = -1;
+    std::unique_ptr<u8[]> fallback_buffer;
+};
+
+/**
+ * Reserved range of the host address space in which pages of a HostMemory can be mapped at
+ * arbitrary offsets. Ranges that are not mapped fault on access.
+ */
+class VirtualArena {
+public:
+    VirtualArena(HostMemory& backing, std::size_t virtual_size);
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    /// Returns whether the arena could be reserved, which requires a shareable backing.
+    bool IsValid() const noexcept {
+        return virtual_base != nullptr;
+    }
+
+    u8* VirtualBasePointer() noexcept {
+        return virtual_base;
+    }
+
+    /// Returns whether Disable was called, in which case nothing can be mapped anymore.
+    bool IsDisabled() const noexcept {
+        return disabled;
+    }
+
+    /**
+     * Mirrors [host_offset, host_offset + length) of the backing memory at virtual_offset.
+     * @returns false if the host failed to map the range or the arena is disabled.
+     */
+    bool Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length);
+
+    /**
+     * Makes [virtual_offset, virtual_offset + length) inaccessible.
+     * @returns false if the host failed to update the range.
+     */
+    bool Unmap(std::size_t virtual_offset, std::size_t length);
+
+    /**
+     * Makes the whole arena inaccessible with a single reservation and rejects any further
+     * mapping, for when the host can't keep up with the mappings anymore.
+     * @returns false if even the reservation failed, the contents of the arena are then undefined.
+     */
+    bool Disable();
+
+    /// Returns whether the host page size allows mapping at the given granularity.
+    static bool SupportsPageSize(std::size_t page_size);
+
+private:
+    HostMemory& backing;
+    u8* virtual_base = nullptr;
+    std::size_t virtual_size;
+    bool disabled = false;
+};
+
+} // namespace Common
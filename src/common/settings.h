@@ -458,6 +458,7 @@ struct Values {
 
     // Core
     Setting<bool> use_cpu_jit{true, "use_cpu_jit"};
+    Setting<bool> use_fastmem{false, "use_fastmem"};
     SwitchableSetting<s32, true> cpu_clock_percentage{100, 5, 400, "cpu_clock_percentage"};
     SwitchableSetting<bool> is_new_3ds{true, "is_new_3ds"};
     SwitchableSetting<bool> lle_applets{true, "lle_applets"};
@@ -469,6 +470,8 @@ struct Values {
     Setting<bool> use_virtual_sd{true, "use_virtual_sd"};
     Setting<bool> use_custom_storage{false, "use_custom_storage"};
     Setting<bool> compress_cia_installs{false, "compress_cia_installs"};
+    Setting<bool> use_artic_disk_cache{false, "use_artic_disk_cache"};
+    Setting<u32> artic_disk_cache_size_mb{2048, "artic_disk_cache_size_mb"};
 
     // System
     SwitchableSetting<s32> region_value{REGION_VALUE_AUTO_SELECT, "region_value"};
@@ -502,6 +505,7 @@ struct Values {
     SwitchableSetting<bool> disable_spirv_optimizer{true, "disable_spirv_optimizer"};
     SwitchableSetting<bool> async_shader_compilation{false, "async_shader_compilation"};
     SwitchableSetting<bool> async_presentation{true, "async_presentation"};
+    SwitchableSetting<bool> use_gpu_thread{false, "use_gpu_thread"};
     SwitchableSetting<bool> use_hw_shader{true, "use_hw_shader"};
     SwitchableSetting<bool> use_disk_shader_cache{true, "use_disk_shader_cache"};
     SwitchableSetting<bool> shaders_accurate_mul{true, "shaders_accurate_mul"};
@@ -611,6 +615,8 @@ struct Values {
     std::string video_encoder;
     std::string video_encoder_options;
     u64 video_bitrate;
+    u32 video_frame_queue_depth = 4;
+    bool drop_video_frames = false;
 
     std::string audio_encoder;
     std::string audio_encoder_options;
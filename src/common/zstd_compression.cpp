@@ -376,6 +376,13 @@ std::size_t Z3DSWriteIOFile::WriteImpl(const void* data, std::size_t length,
     return ret;
 }
 
+std::size_t Z3DSWriteIOFile::WriteAtImpl(const void* data, std::size_t length,
+                                         std::size_t data_size, std::size_t offset) {
+    // Stubbed
+    UNIMPLEMENTED();
+    return 0;
+}
+
 bool Z3DSWriteIOFile::SeekImpl(s64 off, int origin) {
     if (is_serializing) {
         return true;
@@ -439,68 +446,128 @@ struct Z3DSReadIOFile::Z3DSReadIOFileImpl {
             metadata = Z3DSMetadata(buff);
         }
 
-        seekable = ZSTD_seekable_create();
+        auto context = CreateContext();
+        if (!context) {
+            m_good = false;
+            return;
+        }
+        free_contexts.push_back(std::move(context));
+    }
+
+    /**
+     * A seekable decompression context. Each one tracks its own position in the compressed
+     * file and reads through positional reads, so different contexts can decompress at the
+     * same time without sharing the file pointer of the underlying file.
+     */
+    struct SeekableContext {
+        ~SeekableContext() {
+            ZSTD_seekable_free(seekable);
+        }
+
+        int OnZSTDRead(void* buffer, size_t n) {
+            const size_t read =
+                parent->curr_file->ReadAtBytes(reinterpret_cast<uint8_t*>(buffer), n, position);
+            if (read != n) {
+                return -1;
+            }
+            position += n;
+            return 0;
+        }
+
+        int OnZSTDSeek(long long offset, int origin) {
+            long long start = 0;
+            switch (origin) {
+            case SEEK_SET:
+                start = static_cast<long long>(parent->header.metadata_size) +
+                        parent->header.header_size;
+                break;
+            case SEEK_CUR:
+                start = static_cast<long long>(position);
+                break;
+            case SEEK_END:
+                start = static_cast<long long>(parent->curr_file->GetSize());
+                break;
+            default:
+                return -1;
+            }
+            if (start + offset < 0) {
+                return -1;
+            }
+            position = static_cast<u64>(start + offset);
+            return 0;
+        }
+
+        Z3DSReadIOFileImpl* parent = nullptr;
+        ZSTD_seekable* seekable = nullptr;
+        u64 position = 0;
+    };
+
+    std::unique_ptr<SeekableContext> CreateContext() {
+        auto context = std::make_unique<SeekableContext>();
+        context->parent = this;
+        context->seekable = ZSTD_seekable_create();
 
         ZSTD_seekable_customFile custom_file{
-            .opaque = this,
+            .opaque = context.get(),
             .read = [](void* opaque, void* buffer, size_t n) -> int {
-                return reinterpret_cast<Z3DSReadIOFileImpl*>(opaque)->OnZSTDRead(buffer, n);
+                return reinterpret_cast<SeekableContext*>(opaque)->OnZSTDRead(buffer, n);
             },
             .seek = [](void* opaque, long long offset, int origin) -> int {
-                return reinterpret_cast<Z3DSReadIOFileImpl*>(opaque)->OnZSTDSeek(offset, origin);
+                return reinterpret_cast<SeekableContext*>(opaque)->OnZSTDSeek(offset, origin);
             },
         };
-        size_t init_result = ZSTD_seekable_initAdvanced(seekable, custom_file);
+        size_t init_result = ZSTD_seekable_initAdvanced(context->seekable, custom_file);
         if (ZSTD_isError(init_result)) {
             LOG_ERROR(Common_Filesystem, "ZSTD_seekable_initCStream() error : {}",
                       ZSTD_getErrorName(init_result));
-            m_good = false;
+            return nullptr;
         }
-    }
-
-    int OnZSTDRead(void* buffer, size_t n) {
-        const size_t read = curr_file->ReadBytes(reinterpret_cast<uint8_t*>(buffer), n);
-        if (read != n) {
-            return -1;
+        return context;
+    }
+
+    size_t Decompress(void* data, std::size_t length, size_t pos) {
+        // Seekable decompression contexts are not thread safe, so instead of locking a single
+        // one, every concurrent read takes an idle context or creates a new one.
+        std::unique_ptr<SeekableContext> context;
+        {
+            std::scoped_lock lock(contexts_mutex);
+            if (!free_contexts.empty()) {
+                context = std::move(free_contexts.back());
+                free_contexts.pop_back();
+            }
         }
-        return 0;
-    }
-
-    int OnZSTDSeek(long long offset, int origin) {
-        if (origin == SEEK_SET) {
-            offset += static_cast<long long>(header.metadata_size) + header.header_size;
+        if (!context) {
+            context = CreateContext();
+            if (!context) {
+                return 0;
+            }
         }
-        const bool res = curr_file->Seek(offset, origin);
-        return res ? 0 : -1;
-    }
 
-    size_t Read(void* data, std::size_t length) {
-        if (!m_good)
-            return 0;
-        size_t result = ZSTD_seekable_decompress(seekable, data, length, uncompressed_pos);
+        size_t result = ZSTD_seekable_decompress(context->seekable, data, length, pos);
+        {
+            std::scoped_lock lock(contexts_mutex);
+            free_contexts.push_back(std::move(context));
+        }
         if (ZSTD_isError(result)) {
             LOG_ERROR(Common_Filesystem, "ZSTD_seekable_decompress() error : {}",
                       ZSTD_getErrorName(result));
             return 0;
         }
-        uncompressed_pos += result;
         return result;
     }
 
-    size_t ReadAt(void* data, std::size_t length, size_t pos) {
+    size_t Read(void* data, std::size_t length) {
         if (!m_good)
             return 0;
-        // ReadAt should be thread safe, but seekable compression is not,
-        // so we are forced to use a lock.
-        std::scoped_lock lock(read_mutex);
+        size_t result = Decompress(data, length, uncompressed_pos);
+        uncompressed_pos += result;
+        return result;
+    }
 
-        size_t result = ZSTD_seekable_decompress(seekable, data, length, pos);
-        if (ZSTD_isError(result)) {
-            LOG_ERROR(Common_Filesystem, "ZSTD_seekable_decompress() error : {}",
-                      ZSTD_getErrorName(result));
+    size_t ReadAt(void* data, std::size_t length, size_t pos) {
+        if (!m_good)
             return 0;
-        }
-        return result;
+        return Decompress(data, length, pos);
     }
 
     bool Seek(s64 off, int origin) {
@@ -526,14 +593,15 @@ struct Z3DSReadIOFile::Z3DSReadIOFileImpl {
     }
 
     void Close() {
-        ZSTD_seekable_free(seekable);
+        std::scoped_lock lock(contexts_mutex);
+        free_contexts.clear();
     }
 
     Z3DSFileHeader header{};
-    ZSTD_seekable* seekable = nullptr;
     bool m_good = true;
     IOFile* curr_file = nullptr;
-    std::mutex read_mutex;
+    std::mutex contexts_mutex;
+    std::vector<std::unique_ptr<SeekableContext>> free_contexts;
     u64 uncompressed_pos = 0;
     Z3DSMetadata metadata;
 };
@@ -630,6 +698,13 @@ std::size_t Z3DSReadIOFile::WriteImpl(const void* data, std::size_t length, std:
     return 0;
 }
 
+std::size_t Z3DSReadIOFile::WriteAtImpl(const void* data, std::size_t length,
+                                        std::size_t data_size, std::size_t offset) {
+    // Stubbed
+    UNIMPLEMENTED();
+    return 0;
+}
+
 bool Z3DSReadIOFile::SeekImpl(s64 off, int origin) {
     if (is_serializing) {
         return true;
@@ -177,6 +177,8 @@ private:
     std::size_t ReadAtImpl(void* data, std::size_t length, std::size_t data_size,
                            std::size_t offset) override;
     std::size_t WriteImpl(const void* data, std::size_t length, std::size_t data_size) override;
+    std::size_t WriteAtImpl(const void* data, std::size_t length, std::size_t data_size,
+                            std::size_t offset) override;
 
     bool SeekImpl(s64 off, int origin) override;
     u64 TellImpl() const override;
@@ -244,6 +246,8 @@ private:
     std::size_t ReadAtImpl(void* data, std::size_t length, std::size_t data_size,
                            std::size_t offset) override;
     std::size_t WriteImpl(const void* data, std::size_t length, std::size_t data_size) override;
+    std::size_t WriteAtImpl(const void* data, std::size_t length, std::size_t data_size,
+                            std::size_t offset) override;
 
     bool SeekImpl(s64 off, int origin) override;
     u64 TellImpl() const override;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstdint>
 #include <cstring>
 #include <dynarmic/interface/A32/a32.h>
 #include <dynarmic/interface/optimization_flags.h>
@@ -306,6 +307,12 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     config.callbacks = cb.get();
     if (current_page_table) {
         config.page_table = &current_page_table->GetPointerArray();
+        if (u8* fastmem_pointer = current_page_table->GetFastmemPointer()) {
+            // Accesses to pages missing from the arena fault, in which case the faulting code is
+            // recompiled to go through the page table and the memory callbacks instead.
+            config.fastmem_pointer = reinterpret_cast<std::uintptr_t>(fastmem_pointer);
+            config.recompile_on_fastmem_failure = true;
+        }
     }
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
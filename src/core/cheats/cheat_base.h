@@ -11,11 +11,20 @@ namespace Core {
 class System;
 }
 
+namespace Kernel {
+class Process;
+}
+
+namespace Memory {
+class MemorySystem;
+}
+
 namespace Cheats {
 class CheatBase {
 public:
     virtual ~CheatBase();
-    virtual void Execute(Core::System& system, u32 process_id) const = 0;
+    virtual void Execute(Core::System& system, Memory::MemorySystem& memory,
+                         const Kernel::Process& process) const = 0;
 
     virtual bool IsEnabled() const = 0;
     virtual void SetEnabled(bool enabled) = 0;
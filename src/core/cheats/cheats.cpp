@@ -10,6 +10,7 @@
 #include "core/cheats/gateway_cheat.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/hle/kernel/process.h"
 
 namespace Cheats {
 
@@ -104,11 +105,12 @@ void CheatEngine::LoadCheatFile(u64 title_id) {
 }
 
 void CheatEngine::RunCallback([[maybe_unused]] std::uintptr_t user_data, s64 cycles_late) {
-    {
+    // Resolve the process once per tick rather than once per cheat
+    if (const auto process = system.Kernel().GetProcessById(process_id)) {
         std::shared_lock lock{cheats_list_mutex};
         for (const auto& cheat : cheats_list) {
             if (cheat->IsEnabled()) {
-                cheat->Execute(system, process_id);
+                cheat->Execute(system, system.Memory(), *process);
             }
         }
     }
@@ -3,10 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
-#include <cmath>
 #include <fstream>
-#include <functional>
-#include <span>
 #include <string>
 #include <vector>
 #include <boost/iostreams/device/file_descriptor.hpp>
@@ -31,39 +28,40 @@ struct State {
     bool loop_flag = false;
 };
 
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::CheatLine& line,
-                                                              const State& state,
-                                                              ReadFunction read_func,
-                                                              WriteFunction write_func,
-                                                              Core::System& system) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(line.value)) {
-        write_func(addr, static_cast<T>(line.value));
-        system.InvalidateCacheRange(addr, sizeof(T));
+template <typename T>
+static inline T Read(Memory::MemorySystem& memory, const Kernel::Process& process, VAddr addr) {
+    if constexpr (sizeof(T) == 1) {
+        return memory.Read8(process, addr);
+    } else if constexpr (sizeof(T) == 2) {
+        return memory.Read16(process, addr);
+    } else {
+        return memory.Read32(process, addr);
     }
 }
 
-template <typename T, typename ReadFunction, typename CompareFunc>
-static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func,
-                                                             CompareFunc comp) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (!comp(val)) {
-        state.if_flag++;
+template <typename T>
+static inline void Write(Memory::MemorySystem& memory, const Kernel::Process& process, VAddr addr,
+                         T value) {
+    if constexpr (sizeof(T) == 1) {
+        memory.Write8(process, addr, value);
+    } else if constexpr (sizeof(T) == 2) {
+        memory.Write16(process, addr, value);
+    } else {
+        memory.Write32(process, addr, value);
     }
 }
 
-static inline void LoadOffsetOp(Memory::MemorySystem& memory, const Kernel::Process& process,
-                                const GatewayCheat::CheatLine& line, State& state) {
-    u32 addr = line.address + state.offset;
-    state.offset = memory.Read32(process, addr);
+template <typename T>
+static inline void WriteIfChanged(Core::System& system, Memory::MemorySystem& memory,
+                                  const Kernel::Process& process, VAddr addr, T value) {
+    if (Read<T>(memory, process, addr) != value) {
+        Write<T>(memory, process, addr, value);
+        system.InvalidateCacheRange(addr, sizeof(T));
+    }
 }
 
-static inline void LoopOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.loop_flag = state.loop_count < line.value;
+static inline void LoopOp(const GatewayCheat::Instruction& inst, State& state) {
+    state.loop_flag = state.loop_count < inst.value;
     state.loop_count++;
     state.loop_back_line = state.current_line_nr;
 }
@@ -94,92 +92,14 @@ static inline void FullTerminateOp(State& state) {
     }
 }
 
-static inline void SetOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset = line.value;
-}
-
-static inline void AddValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg += line.value;
-}
-
-static inline void SetValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg = line.value;
-}
-
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
-    const GatewayCheat::CheatLine& line, State& state, ReadFunction read_func,
-    WriteFunction write_func, Core::System& system) {
-    u32 addr = line.value + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(state.reg)) {
-        write_func(addr, static_cast<T>(state.reg));
-        system.InvalidateCacheRange(addr, sizeof(T));
-    }
-    state.offset += sizeof(T);
-}
-
-template <typename T, typename ReadFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> LoadOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func) {
-
-    u32 addr = line.value + state.offset;
-    state.reg = read_func(addr);
-}
-
-static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset += line.value;
-}
-
-static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
-                           const Core::System& system) {
+static inline bool JokerPressed(const GatewayCheat::Instruction& inst,
+                                const Core::System& system) {
     u32 pad_state = system.ServiceManager()
                         .GetService<Service::HID::Module::Interface>("hid:USER")
                         ->GetModule()
                         ->GetState()
                         .hex;
-    bool pressed = (pad_state & line.value) == line.value;
-    if (!pressed) {
-        state.if_flag++;
-    }
-}
-
-static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
-                           const Kernel::Process& process,
-                           std::span<const GatewayCheat::CheatLine> cheat_lines) {
-    if (state.if_flag > 0) {
-        // Skip over the additional patch lines
-        state.current_line_nr += static_cast<int>(std::ceil(line.value / 8.0));
-        return;
-    }
-    u32 num_bytes = line.value;
-    u32 addr = line.address + state.offset;
-    system.InvalidateCacheRange(addr, num_bytes);
-
-    bool first = true;
-    u32 bit_offset = 0;
-    if (num_bytes > 0)
-        state.current_line_nr++; // skip over the current code
-    while (num_bytes >= 4) {
-        u32 tmp = first ? cheat_lines[state.current_line_nr].first
-                        : cheat_lines[state.current_line_nr].value;
-        if (!first && num_bytes > 4) {
-            state.current_line_nr++;
-        }
-        first = !first;
-        system.Memory().Write32(process, addr, tmp);
-        addr += 4;
-        num_bytes -= 4;
-    }
-    while (num_bytes > 0) {
-        u32 tmp = (first ? cheat_lines[state.current_line_nr].first
-                         : cheat_lines[state.current_line_nr].value) >>
-                  bit_offset;
-        system.Memory().Write8(process, addr, static_cast<u8>(tmp));
-        addr += 1;
-        num_bytes -= 1;
-        bit_offset += 8;
-    }
+    return (pad_state & inst.value) == inst.value;
 }
 
 GatewayCheat::CheatLine::CheatLine(const std::string& line) {
@@ -213,6 +133,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    Compile();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -226,37 +147,73 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(line);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    Compile();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
-void GatewayCheat::Execute(Core::System& system, u32 process_id) const {
-    State state;
+void GatewayCheat::Compile() {
+    program.clear();
+    program.reserve(cheat_lines.size());
+    patch_data.clear();
 
-    Memory::MemorySystem& memory = system.Memory();
-    std::shared_ptr<Kernel::Process> process = system.Kernel().GetProcessById(process_id);
-    if (!process) {
-        return;
+    for (std::size_t i = 0; i < cheat_lines.size(); i++) {
+        const auto& line = cheat_lines[i];
+        Instruction& inst = program.emplace_back();
+        if (!line.valid) {
+            continue;
+        }
+        inst.type = line.type;
+        inst.address = line.address;
+        inst.value = line.value;
+
+        switch (line.type) {
+        case CheatType::GreaterThan16WithMask:
+        case CheatType::LessThan16WithMask:
+        case CheatType::EqualTo16WithMask:
+        case CheatType::NotEqualTo16WithMask:
+            // ZZZZYYYY: compare YYYY against the half word masked with (not ZZZZ)
+            inst.compare = static_cast<u16>(line.value);
+            inst.mask = static_cast<u16>(~line.value >> 16);
+            break;
+        case CheatType::Patch: {
+            // The payload is stored in the following lines, both columns little endian. Gather
+            // it here so the patch is a single block write. Bytes past the end of the cheat
+            // are not written.
+            const std::size_t remaining = cheat_lines.size() - i - 1;
+            const std::size_t lines =
+                std::min<std::size_t>((static_cast<u64>(line.value) + 7) / 8, remaining);
+            const u32 num_bytes = std::min<u32>(line.value, static_cast<u32>(lines * 8));
+            inst.value = num_bytes;
+            inst.skip_lines = static_cast<u32>(lines);
+            inst.data_offset = static_cast<u32>(patch_data.size());
+            for (std::size_t j = i + 1; j <= i + lines; j++) {
+                const auto& data_line = cheat_lines[j];
+                for (const u32 word : {data_line.first, data_line.value}) {
+                    const u32 data = data_line.valid ? word : 0;
+                    for (u32 byte = 0; byte < 4; byte++) {
+                        patch_data.push_back(static_cast<u8>(data >> (byte * 8)));
+                    }
+                }
+            }
+            patch_data.resize(inst.data_offset + num_bytes);
+            break;
+        }
+        default:
+            break;
+        }
     }
+}
 
-    auto Read8 = [&memory, &process](VAddr addr) { return memory.Read8(*process, addr); };
-    auto Read16 = [&memory, &process](VAddr addr) { return memory.Read16(*process, addr); };
-    auto Read32 = [&memory, &process](VAddr addr) { return memory.Read32(*process, addr); };
-    auto Write8 = [&memory, &process](VAddr addr, u8 value) {
-        memory.Write8(*process, addr, value);
-    };
-    auto Write16 = [&memory, &process](VAddr addr, u16 value) {
-        memory.Write16(*process, addr, value);
-    };
-    auto Write32 = [&memory, &process](VAddr addr, u32 value) {
-        memory.Write32(*process, addr, value);
-    };
-
-    for (state.current_line_nr = 0; state.current_line_nr < cheat_lines.size();
+void GatewayCheat::Execute(Core::System& system, Memory::MemorySystem& memory,
+                           const Kernel::Process& process) const {
+    State state;
+
+    for (state.current_line_nr = 0; state.current_line_nr < program.size();
          state.current_line_nr++) {
-        auto line = cheat_lines[state.current_line_nr];
+        const auto& inst = program[state.current_line_nr];
         if (state.if_flag > 0) {
-            switch (line.type) {
+            switch (inst.type) {
             case CheatType::GreaterThan32:
             case CheatType::LessThan32:
             case CheatType::EqualTo32:
@@ -270,10 +227,8 @@ void GatewayCheat::Execute(Core::System& system, u32 process_id) const {
                 state.if_flag++;
                 break;
             case CheatType::Patch:
-                // EXXXXXXX YYYYYYYY
-                // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-                // We need to call this here to skip the additional patch lines
-                PatchOp(line, state, system, *process, cheat_lines);
+                // Skip over the additional patch lines
+                state.current_line_nr += inst.skip_lines;
                 break;
             case CheatType::Terminator:
                 // D0000000 00000000 - ENDIF
@@ -289,149 +244,139 @@ void GatewayCheat::Execute(Core::System& system, u32 process_id) const {
             // Do not execute any other op code
             continue;
         }
-        switch (line.type) {
+
+        const u32 addr = inst.address + state.offset;
+        bool condition = true;
+        switch (inst.type) {
         case CheatType::Null:
             break;
         case CheatType::Write32:
             // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
-            WriteOp<u32>(line, state, Read32, Write32, system);
+            WriteIfChanged<u32>(system, memory, process, addr, inst.value);
             break;
         case CheatType::Write16:
             // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
-            WriteOp<u16>(line, state, Read16, Write16, system);
+            WriteIfChanged<u16>(system, memory, process, addr, static_cast<u16>(inst.value));
             break;
         case CheatType::Write8:
             // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
-            WriteOp<u8>(line, state, Read8, Write8, system);
+            WriteIfChanged<u8>(system, memory, process, addr, static_cast<u8>(inst.value));
             break;
         case CheatType::GreaterThan32:
             // 3XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY > word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value > val; });
+            condition = inst.value > Read<u32>(memory, process, addr);
             break;
         case CheatType::LessThan32:
             // 4XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY < word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value < val; });
+            condition = inst.value < Read<u32>(memory, process, addr);
             break;
         case CheatType::EqualTo32:
             // 5XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY == word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value == val; });
+            condition = inst.value == Read<u32>(memory, process, addr);
             break;
         case CheatType::NotEqualTo32:
             // 6XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY != word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value != val; });
+            condition = inst.value != Read<u32>(memory, process, addr);
             break;
         case CheatType::GreaterThan16WithMask:
             // 7XXXXXXX ZZZZYYYY - Execute next block IF YYYY > ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) > (static_cast<u16>(~line.value >> 16) & val);
-            });
+            condition = inst.compare > (inst.mask & Read<u16>(memory, process, addr));
             break;
         case CheatType::LessThan16WithMask:
             // 8XXXXXXX ZZZZYYYY - Execute next block IF YYYY < ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) < (static_cast<u16>(~line.value >> 16) & val);
-            });
+            condition = inst.compare < (inst.mask & Read<u16>(memory, process, addr));
             break;
         case CheatType::EqualTo16WithMask:
             // 9XXXXXXX ZZZZYYYY - Execute next block IF YYYY = ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) == (static_cast<u16>(~line.value >> 16) & val);
-            });
+            condition = inst.compare == (inst.mask & Read<u16>(memory, process, addr));
             break;
         case CheatType::NotEqualTo16WithMask:
             // AXXXXXXX ZZZZYYYY - Execute next block IF YYYY <> ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) != (static_cast<u16>(~line.value >> 16) & val);
-            });
+            condition = inst.compare != (inst.mask & Read<u16>(memory, process, addr));
             break;
         case CheatType::LoadOffset:
             // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
-            LoadOffsetOp(system.Memory(), *process, line, state);
+            state.offset = Read<u32>(memory, process, addr);
             break;
-        case CheatType::Loop: {
+        case CheatType::Loop:
             // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
             // TODO(B3N30): Support nested loops if necessary
-            LoopOp(line, state);
+            LoopOp(inst, state);
             break;
-        }
-        case CheatType::Terminator: {
+        case CheatType::Terminator:
             // D0000000 00000000 - END IF
             TerminateOp(state);
             break;
-        }
-        case CheatType::LoopExecuteVariant: {
+        case CheatType::LoopExecuteVariant:
             // D1000000 00000000 - END LOOP
             LoopExecuteVariantOp(state);
             break;
-        }
-        case CheatType::FullTerminator: {
+        case CheatType::FullTerminator:
             // D2000000 00000000 - NEXT & Flush
             FullTerminateOp(state);
             break;
-        }
-        case CheatType::SetOffset: {
+        case CheatType::SetOffset:
             // D3000000 XXXXXXXX – Sets the offset to XXXXXXXX
-            SetOffsetOp(line, state);
+            state.offset = inst.value;
             break;
-        }
-        case CheatType::AddValue: {
+        case CheatType::AddValue:
             // D4000000 XXXXXXXX – reg += XXXXXXXX
-            AddValueOp(line, state);
+            state.reg += inst.value;
             break;
-        }
-        case CheatType::SetValue: {
+        case CheatType::SetValue:
             // D5000000 XXXXXXXX – reg = XXXXXXXX
-            SetValueOp(line, state);
+            state.reg = inst.value;
             break;
-        }
-        case CheatType::IncrementiveWrite32: {
+        case CheatType::IncrementiveWrite32:
             // D6000000 XXXXXXXX – (32bit) [XXXXXXXX+offset] = reg ; offset += 4
-            IncrementiveWriteOp<u32>(line, state, Read32, Write32, system);
+            WriteIfChanged<u32>(system, memory, process, inst.value + state.offset, state.reg);
+            state.offset += 4;
             break;
-        }
-        case CheatType::IncrementiveWrite16: {
+        case CheatType::IncrementiveWrite16:
             // D7000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
-            IncrementiveWriteOp<u16>(line, state, Read16, Write16, system);
+            WriteIfChanged<u16>(system, memory, process, inst.value + state.offset,
+                                static_cast<u16>(state.reg));
+            state.offset += 2;
             break;
-        }
-        case CheatType::IncrementiveWrite8: {
+        case CheatType::IncrementiveWrite8:
             // D8000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
-            IncrementiveWriteOp<u8>(line, state, Read8, Write8, system);
+            WriteIfChanged<u8>(system, memory, process, inst.value + state.offset,
+                               static_cast<u8>(state.reg));
+            state.offset += 1;
             break;
-        }
-        case CheatType::Load32: {
+        case CheatType::Load32:
             // D9000000 XXXXXXXX – reg = [XXXXXXXX+offset]
-            LoadOp<u32>(line, state, Read32);
+            state.reg = Read<u32>(memory, process, inst.value + state.offset);
             break;
-        }
-        case CheatType::Load16: {
+        case CheatType::Load16:
             // DA000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFFFF
-            LoadOp<u16>(line, state, Read16);
+            state.reg = Read<u16>(memory, process, inst.value + state.offset);
             break;
-        }
-        case CheatType::Load8: {
+        case CheatType::Load8:
             // DB000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFF
-            LoadOp<u8>(line, state, Read8);
+            state.reg = Read<u8>(memory, process, inst.value + state.offset);
             break;
-        }
-        case CheatType::AddOffset: {
+        case CheatType::AddOffset:
             // DC000000 XXXXXXXX – offset + XXXXXXXX
-            AddOffsetOp(line, state);
+            state.offset += inst.value;
             break;
-        }
-        case CheatType::Joker: {
+        case CheatType::Joker:
             // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+            condition = JokerPressed(inst, system);
             break;
-        }
-        case CheatType::Patch: {
+        case CheatType::Patch:
             // EXXXXXXX YYYYYYYY
             // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-            PatchOp(line, state, system, *process, cheat_lines);
+            if (inst.value > 0) {
+                system.InvalidateCacheRange(addr, inst.value);
+                memory.WriteBlock(process, addr, patch_data.data() + inst.data_offset,
+                                  inst.value);
+            }
+            state.current_line_nr += inst.skip_lines;
             break;
         }
+        if (!condition) {
+            state.if_flag++;
         }
     }
 }
@@ -55,11 +55,28 @@ public:
         bool valid = true;
     };
 
+    /// A cheat line decoded once into the operands its op code needs, so that executing it
+    /// does not parse or reinterpret anything.
+    struct Instruction {
+        CheatType type = CheatType::Null;
+        u32 address = 0;
+        /// Operand, or the number of bytes written for a patch.
+        u32 value = 0;
+        /// Comparand (YYYY) and mask (not ZZZZ) of the 16-bit conditionals.
+        u16 compare = 0;
+        u16 mask = 0;
+        /// Start of the patch payload in patch_data.
+        u32 data_offset = 0;
+        /// Number of payload lines following a patch.
+        u32 skip_lines = 0;
+    };
+
     GatewayCheat(std::string name, std::vector<CheatLine> cheat_lines, std::string comments);
     GatewayCheat(std::string name, std::string code, std::string comments);
     ~GatewayCheat();
 
-    void Execute(Core::System& system, u32 process_id) const override;
+    void Execute(Core::System& system, Memory::MemorySystem& memory,
+                 const Kernel::Process& process) const override;
 
     bool IsEnabled() const override;
     void SetEnabled(bool enabled) override;
@@ -80,9 +97,15 @@ public:
     static std::vector<std::shared_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    /// Decodes the parsed cheat lines into the program executed on every tick.
+    void Compile();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
+    std::vector<Instruction> program;
+    /// Payloads of the patch instructions, already in the byte order they are written in.
+    std::vector<u8> patch_data;
     const std::string comments;
 };
 } // namespace Cheats
@@ -821,6 +821,11 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         timing->UnlockEventQueue();
         memory->SetDSP(*dsp_core);
         cheat_engine.Connect(cheats_pid);
+#ifdef ENABLE_SCRIPTING
+        if (rpc_server) {
+            rpc_server->OnStateLoaded();
+        }
+#endif
 
         // Re-register gpu callback, because gsp service changed after service_manager got
         // serialized
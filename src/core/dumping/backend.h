@@ -21,6 +21,8 @@ public:
     std::size_t height;
     u32 stride;
     std::vector<u8> data;
+    /// Number of frames dropped right before this one, so that timestamps stay in sync with audio
+    u64 dropped_before{};
 
     VideoFrame(std::size_t width_ = 0, std::size_t height_ = 0, u8* data_ = nullptr);
 };
@@ -29,7 +31,12 @@ class Backend {
 public:
     virtual ~Backend();
     virtual bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) = 0;
-    virtual void AddVideoFrame(VideoFrame frame) = 0;
+    /**
+     * Queues a frame for dumping. The data is copied before returning, so the caller can reuse
+     * its buffer right away.
+     * @param data Pixel data in the format of VideoFrame::data, width * height * 4 bytes.
+     */
+    virtual void AddVideoFrame(std::size_t width, std::size_t height, const u8* data) = 0;
     virtual void AddAudioFrame(AudioCore::StereoFrame16 frame) = 0;
     virtual void AddAudioSample(const std::array<s16, 2>& sample) = 0;
     virtual void StopDumping() = 0;
@@ -44,7 +51,8 @@ public:
                       const Layout::FramebufferLayout& /*layout*/) override {
         return false;
     }
-    void AddVideoFrame(VideoFrame /*frame*/) override {}
+    void AddVideoFrame(std::size_t /*width*/, std::size_t /*height*/,
+                       const u8* /*data*/) override {}
     void AddAudioFrame(AudioCore::StereoFrame16 /*frame*/) override {}
     void AddAudioSample(const std::array<s16, 2>& /*sample*/) override {}
     void StopDumping() override {}
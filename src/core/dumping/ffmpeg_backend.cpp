@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <span>
 #include <unordered_map>
+#include <utility>
 #include "common/assert.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
@@ -253,6 +256,8 @@ void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
     current_frame->format = pixel_format;
     current_frame->width = layout.width;
     current_frame->height = layout.height;
+    // Dropped frames still take up their time slot
+    frame_count += frame.dropped_before;
     current_frame->pts = frame_count++;
 
     // Filter the frame
@@ -757,21 +762,37 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     if (video_processing_thread.joinable()) {
         video_processing_thread.join();
     }
+
+    // Allocate all the frame buffers upfront: one per queue slot, plus the one being encoded.
+    const std::size_t pool_size =
+        std::max<std::size_t>(Settings::values.video_frame_queue_depth, 1) + 1;
+    free_video_frames.Clear();
+    queued_video_frames.Clear();
+    video_frame_pool.clear();
+    video_frame_pool.reserve(pool_size);
+    for (std::size_t i = 0; i < pool_size; ++i) {
+        auto& frame = video_frame_pool.emplace_back();
+        frame.width = layout.width;
+        frame.height = layout.height;
+        frame.stride = static_cast<u32>(layout.width * 4);
+        frame.data.resize(layout.width * layout.height * 4);
+        free_video_frames.Push(&frame);
+    }
+    video_frames_dumped = 0;
+    video_frames_dropped = 0;
+    pending_dropped_frames = 0;
+    max_video_queue_depth = 0;
+
     video_processing_thread = std::thread([&] {
-        event1.Set();
         while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
-            // Process this frame
-            auto& frame = video_frame_buffers[current_buffer];
-            if (frame.width == 0 && frame.height == 0) {
-                // An empty frame marks the end of frame data
+            VideoFrame* frame = queued_video_frames.PopWait();
+            if (!frame) {
+                // A null frame marks the end of frame data
                 ffmpeg.FlushVideo();
                 break;
             }
-            ffmpeg.ProcessVideoFrame(frame);
+            ffmpeg.ProcessVideoFrame(*frame);
+            free_video_frames.Push(frame);
         }
         // Finish audio execution first if not done yet
         if (audio_processing_thread.joinable())
@@ -802,10 +823,35 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     return true;
 }
 
-void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+void FFmpegBackend::AddVideoFrame(std::size_t width, std::size_t height, const u8* data) {
+    if (!IsDumping()) {
+        return;
+    }
+    if (width != video_layout.width || height != video_layout.height) {
+        LOG_ERROR(Render, "Frame dropped: resolution does not match");
+        return;
+    }
+
+    VideoFrame* frame;
+    if (Settings::values.drop_video_frames) {
+        if (!free_video_frames.Pop(frame)) {
+            ++video_frames_dropped;
+            ++pending_dropped_frames;
+            return;
+        }
+    } else {
+        frame = free_video_frames.PopWait();
+    }
+
+    std::memcpy(frame->data.data(), data, frame->data.size());
+    frame->dropped_before = std::exchange(pending_dropped_frames, 0);
+    queued_video_frames.Push(frame);
+    ++video_frames_dumped;
+
+    const std::size_t queue_depth = video_frame_pool.size() - free_video_frames.Size();
+    if (queue_depth > max_video_queue_depth) {
+        max_video_queue_depth = queue_depth;
+    }
 }
 
 void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
@@ -832,7 +878,7 @@ void FFmpegBackend::StopDumping() {
     renderer.CleanupVideoDumping();
 
     // Flush the video processing queue
-    AddVideoFrame(VideoFrame());
+    queued_video_frames.Push(nullptr);
     for (auto i : {0, 1}) {
         // Flush the audio processing queue
         audio_frame_queues[i].Push(VariableAudioFrame());
@@ -850,7 +896,9 @@ Layout::FramebufferLayout FFmpegBackend::GetLayout() const {
 }
 
 void FFmpegBackend::EndDumping() {
-    LOG_INFO(Render, "Ending frame dumping");
+    LOG_INFO(Render, "Ending frame dumping ({} frames dumped, {} dropped, max queue depth {})",
+             video_frames_dumped.load(), video_frames_dropped.load(),
+             max_video_queue_depth.load());
 
     ffmpeg.WriteTrailer();
     ffmpeg.Free();
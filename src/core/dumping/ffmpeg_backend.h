@@ -181,14 +181,16 @@ private:
 
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer.
+ * Video frames are copied into a fixed pool of buffers and handed to the encoding thread through
+ * a bounded queue. When the queue is full, frames are either dropped or the caller waits for the
+ * encoder, depending on Settings::values.drop_video_frames.
  */
 class FFmpegBackend : public Backend {
 public:
     FFmpegBackend(VideoCore::RendererBase& renderer);
     ~FFmpegBackend() override;
     bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) override;
-    void AddVideoFrame(VideoFrame frame) override;
+    void AddVideoFrame(std::size_t width, std::size_t height, const u8* data) override;
     void AddAudioFrame(AudioCore::StereoFrame16 frame) override;
     void AddAudioSample(const std::array<s16, 2>& sample) override;
     void StopDumping() override;
@@ -204,11 +206,20 @@ private:
     FFmpegMuxer ffmpeg{};
 
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
+    std::vector<VideoFrame> video_frame_pool;
+    /// Frames of the pool that are not queued. Filled by the encoding thread.
+    Common::SPSCQueue<VideoFrame*> free_video_frames;
+    /// Frames waiting to be encoded, a null frame marks the end of the video.
+    Common::MPSCQueue<VideoFrame*> queued_video_frames;
     std::thread video_processing_thread;
 
+    // Statistics of the current dump, logged when it ends
+    std::atomic<u64> video_frames_dumped = 0;
+    std::atomic<u64> video_frames_dropped = 0;
+    std::atomic<std::size_t> max_video_queue_depth = 0;
+    /// Frames dropped since the last queued one. Only accessed by the thread adding frames.
+    u64 pending_dropped_frames = 0;
+
     std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
     std::thread audio_processing_thread;
 
@@ -132,6 +132,10 @@ public:
         return artic_client.get() != nullptr;
     }
 
+    bool AllowsPersistentCache() const override {
+        return true;
+    }
+
 private:
     std::shared_ptr<Network::ArticBase::Client> artic_client = nullptr;
 
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include "artic_cache.h"
+#include "common/hash.h"
 
 namespace FileSys {
 ResultVal<std::size_t> ArticCache::Read(s32 file_handle, std::size_t offset, std::size_t length,
@@ -23,7 +25,7 @@ ResultVal<std::size_t> ArticCache::Read(s32 file_handle, std::size_t offset, std
                 big_cache_entry.second.clear();
                 big_cache_entry.second.resize(length);
                 auto res =
-                    ReadFromArtic(file_handle, reinterpret_cast<u8*>(big_cache_entry.second.data()),
+                    ReadUncached(file_handle, reinterpret_cast<u8*>(big_cache_entry.second.data()),
                                   length, offset);
                 if (res.Failed())
                     return res;
@@ -41,7 +43,7 @@ ResultVal<std::size_t> ArticCache::Read(s32 file_handle, std::size_t offset, std
                               length);
                     very_big_cache_entry.second.clear();
                     very_big_cache_entry.second.resize(length);
-                    auto res = ReadFromArtic(
+                    auto res = ReadUncached(
                         file_handle, reinterpret_cast<u8*>(very_big_cache_entry.second.data()),
                         length, offset);
                     if (res.Failed())
@@ -54,7 +56,7 @@ ResultVal<std::size_t> ArticCache::Read(s32 file_handle, std::size_t offset, std
             } else {
                 LOG_TRACE(Service_FS, "ArticCache SKIP: offset={}, length={}", offset, length);
 
-                auto res = ReadFromArtic(file_handle, buffer, length, offset);
+                auto res = ReadUncached(file_handle, buffer, length, offset);
                 if (res.Failed())
                     return res;
                 length = res.Unwrap();
@@ -65,17 +67,52 @@ ResultVal<std::size_t> ArticCache::Read(s32 file_handle, std::size_t offset, std
 
     // TODO(PabloMK7): Make cache thread safe, read the comment in CacheReady function.
     std::unique_lock read_guard(cache_mutex);
+
+    // Fetch every missing line touched by this read with a single request, instead of paying a
+    // round trip per line.
+    std::optional<std::size_t> first_missing, last_missing;
+    for (const auto& seg : segments) {
+        const std::size_t page = OffsetToPage(seg.first);
+        if (!cache.contains(page)) {
+            if (!first_missing) {
+                first_missing = page;
+            }
+            last_missing = page;
+        }
+    }
+
+    // A read of up to max_breakup_size bytes spans at most one extra line.
+    std::array<u8, max_breakup_size + cache_line_size> fetch_buffer;
+    std::size_t fetched_size = 0;
+    if (first_missing) {
+        auto res = ReadUncached(file_handle, fetch_buffer.data(),
+                                 *last_missing + cache_line_size - *first_missing, *first_missing);
+        if (res.Failed())
+            return res;
+        fetched_size = res.Unwrap();
+    }
+
     for (const auto& seg : segments) {
         std::size_t read_size = cache_line_size;
         std::size_t page = OffsetToPage(seg.first);
         // Check if segment is in cache
         auto cache_entry = cache.request(page);
         if (!cache_entry.first) {
-            // If not found, read from artic and cache the data
-            auto res = ReadFromArtic(file_handle, cache_entry.second.data(), read_size, page);
-            if (res.Failed())
-                return res;
-            read_size = res.Unwrap();
+            // If not found, cache the data fetched above
+            if (first_missing && page >= *first_missing && page <= *last_missing) {
+                const std::size_t fetch_offset = page - *first_missing;
+                read_size = fetched_size > fetch_offset
+                                ? std::min(fetched_size - fetch_offset, cache_line_size)
+                                : 0;
+                std::memcpy(cache_entry.second.data(), fetch_buffer.data() + fetch_offset,
+                            read_size);
+            } else {
+                // The line got evicted after the scan above, read it on its own.
+                auto res = ReadUncached(file_handle, cache_entry.second.data(), read_size, page);
+                if (res.Failed())
+                    return res;
+                read_size = res.Unwrap();
+            }
             LOG_TRACE(Service_FS, "ArticCache MISS: page={}, length={}, into={}", page, seg.second,
                       (seg.first - page));
         } else {
@@ -159,6 +196,15 @@ ResultVal<size_t> ArticCache::GetSize(s32 file_handle) {
     if (data_size.has_value())
         return data_size.value();
 
+    auto res = RequestSize(file_handle);
+    if (res.Failed())
+        return res;
+
+    data_size = res.Unwrap();
+    return data_size.value();
+}
+
+ResultVal<size_t> ArticCache::RequestSize(s32 file_handle) {
     auto req = client->NewRequest("FSFILE_GetSize");
 
     req.AddParameterS32(file_handle);
@@ -176,41 +222,148 @@ ResultVal<size_t> ArticCache::GetSize(s32 file_handle) {
         return Result(-1);
     }
 
-    data_size = static_cast<size_t>(*size_buf);
-    return data_size.value();
+    return static_cast<size_t>(*size_buf);
 }
 
 ResultVal<size_t> ArticCache::ReadFromArtic(s32 file_handle, u8* buffer, size_t len,
                                             size_t offset) {
-    size_t read_amount = 0;
-    while (read_amount != len) {
-        size_t to_read =
-            std::min<size_t>(client->GetServerRequestMaxSize() - 0x100, len - read_amount);
+    const size_t chunk_size = client->GetServerRequestMaxSize() - 0x100;
 
-        auto req = client->NewRequest("FSFILE_Read");
+    // Pipeline all the chunks, so that the server can process the next ones while the previous
+    // responses are still in transit.
+    std::vector<Network::ArticBase::Client::Request> requests;
+    requests.reserve((len + chunk_size - 1) / chunk_size);
+    for (size_t chunk_offset = 0; chunk_offset < len; chunk_offset += chunk_size) {
+        auto& req = requests.emplace_back(client->NewRequest("FSFILE_Read"));
         req.AddParameterS32(file_handle);
-        req.AddParameterS64(static_cast<s64>(offset + read_amount));
-        req.AddParameterS32(static_cast<s32>(to_read));
-        auto resp = client->Send(req);
-        if (!resp.has_value() || !resp->Succeeded())
-            return Result(-1);
+        req.AddParameterS64(static_cast<s64>(offset + chunk_offset));
+        req.AddParameterS32(static_cast<s32>(std::min(chunk_size, len - chunk_offset)));
+    }
+
+    Result result = ResultSuccess;
+    size_t read_amount = 0;
+    bool done = false;
+    client->SendMultiple(requests, [&](size_t index, auto& resp) {
+        // Stop at the first failure or short read. Any later chunks are past the end of the data.
+        if (done)
+            return;
+
+        if (!resp.has_value() || !resp->Succeeded()) {
+            result = Result(-1);
+            done = true;
+            return;
+        }
 
         auto res = Result(static_cast<u32>(resp->GetMethodResult()));
-        if (res.IsError())
-            return res;
+        if (res.IsError()) {
+            result = res;
+            done = true;
+            return;
+        }
 
+        const size_t to_read = std::min(chunk_size, len - index * chunk_size);
         auto read_buff = resp->GetResponseBuffer(0);
         size_t actually_read = 0;
         if (read_buff.has_value()) {
-            actually_read = read_buff->second;
+            actually_read = std::min(read_buff->second, to_read);
             memcpy(buffer + read_amount, read_buff->first, actually_read);
         }
 
         read_amount += actually_read;
         if (actually_read != to_read)
+            done = true;
+    });
+
+    if (result.IsError())
+        return result;
+    return read_amount;
+}
+
+ResultVal<size_t> ArticCache::ReadUncached(s32 file_handle, u8* buffer, size_t len,
+                                           size_t offset) {
+    ArticDiskCache* disk_cache = GetDiskCache(file_handle);
+    if (!disk_cache) {
+        return ReadFromArtic(file_handle, buffer, len, offset);
+    }
+
+    constexpr std::size_t block_size = ArticDiskCache::BLOCK_SIZE;
+    const std::size_t first_block = Common::AlignDown(offset, block_size);
+    const std::size_t end_block = Common::AlignUp(offset + len, block_size);
+
+    std::vector<u8> blocks(end_block - first_block);
+    std::size_t available = 0;
+    std::size_t block = first_block;
+    while (block < end_block) {
+        u8* block_data = blocks.data() + (block - first_block);
+        if (const auto block_size_read = disk_cache->ReadBlock(block, block_data)) {
+            available += *block_size_read;
+            if (*block_size_read != block_size) {
+                // Short block, this is the end of the file.
+                break;
+            }
+            block += block_size;
+            continue;
+        }
+
+        // Fetch the whole run of blocks missing from the disk with a single read.
+        std::size_t run_end = block + block_size;
+        while (run_end < end_block && !disk_cache->HasBlock(run_end)) {
+            run_end += block_size;
+        }
+
+        auto res = ReadFromArtic(file_handle, block_data, run_end - block, block);
+        if (res.Failed())
+            return res;
+        const std::size_t fetched = res.Unwrap();
+        for (std::size_t pos = 0; pos < fetched; pos += block_size) {
+            disk_cache->WriteBlock(block + pos, block_data + pos,
+                                   std::min(block_size, fetched - pos));
+        }
+
+        available += fetched;
+        if (fetched != run_end - block) {
             break;
+        }
+        block = run_end;
     }
-    return read_amount;
+
+    const std::size_t available_end = first_block + available;
+    if (available_end <= offset) {
+        return size_t();
+    }
+    const std::size_t read_size = std::min(offset + len, available_end) - offset;
+    std::memcpy(buffer, blocks.data() + (offset - first_block), read_size);
+    return read_size;
+}
+
+ArticDiskCache* ArticCache::GetDiskCache(s32 file_handle) {
+    std::scoped_lock lock(disk_cache_mutex);
+    if (disk_cache || disk_cache_key.empty()) {
+        return disk_cache.get();
+    }
+
+    // The size and the first block identify the content version. For RomFS and ExeFS the first
+    // block holds the hashes of everything else, so a title update always changes the key.
+    auto size = RequestSize(file_handle);
+    if (size.Failed()) {
+        return nullptr;
+    }
+    std::vector<u8> first_block(std::min(ArticDiskCache::BLOCK_SIZE, size.Unwrap()));
+    auto read = ReadFromArtic(file_handle, first_block.data(), first_block.size(), 0);
+    if (read.Failed() || read.Unwrap() != first_block.size()) {
+        return nullptr;
+    }
+
+    const std::array<u64, 2> version{static_cast<u64>(size.Unwrap()),
+                                     Common::ComputeHash64(first_block.data(), first_block.size())};
+    const auto* version_bytes = reinterpret_cast<const u8*>(version.data());
+    disk_cache_key.insert(disk_cache_key.end(), version_bytes, version_bytes + sizeof(version));
+
+    disk_cache = std::make_unique<ArticDiskCache>(disk_cache_key);
+    if (!disk_cache->HasBlock(0)) {
+        disk_cache->WriteBlock(0, first_block.data(), first_block.size());
+    }
+    return disk_cache.get();
 }
 
 std::vector<std::pair<std::size_t, std::size_t>> ArticCache::BreakupRead(std::size_t offset,
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <mutex>
 #include <shared_mutex>
 #include "vector"
 
@@ -15,6 +16,7 @@
 #include "common/common_types.h"
 #include "common/static_lru_cache.h"
 #include "core/file_sys/archive_backend.h"
+#include "core/file_sys/artic_disk_cache.h"
 #include "core/hle/result.h"
 #include "network/artic_base/artic_base_client.h"
 
@@ -41,9 +43,23 @@ public:
         data_size = size;
     }
 
+    /**
+     * Backs this cache with the persistent on-disk cache. Only use this for read-only content.
+     * The disk cache is opened on the first uncached read, once the size and a hash of the first
+     * block of the content have been added to the key.
+     * @param key Bytes identifying the content, see ArticDiskCache.
+     */
+    void EnableDiskCache(std::span<const u8> key) {
+        std::scoped_lock lock(disk_cache_mutex);
+        disk_cache_key.assign(key.begin(), key.end());
+    }
+
 private:
     std::shared_ptr<Network::ArticBase::Client> client;
     std::optional<size_t> data_size;
+    std::vector<u8> disk_cache_key;
+    std::unique_ptr<ArticDiskCache> disk_cache;
+    std::mutex disk_cache_mutex;
 
     // Total cache size: 32MB small, 512MB big (worst case), 160MB very big (worst case).
     // The worst case values are unrealistic, they will never happen in any real game.
@@ -76,8 +92,16 @@ private:
         very_big_cache;
     std::shared_mutex very_big_cache_mutex;
 
+    ResultVal<size_t> RequestSize(s32 file_handle);
+
+    /// Returns the disk cache, opening it on first use. Returns nullptr if it is not enabled.
+    ArticDiskCache* GetDiskCache(s32 file_handle);
+
     ResultVal<std::size_t> ReadFromArtic(s32 file_handle, u8* buffer, size_t len, size_t offset);
 
+    /// Reads data missing from the memory cache, going through the disk cache if enabled.
+    ResultVal<std::size_t> ReadUncached(s32 file_handle, u8* buffer, size_t len, size_t offset);
+
     std::size_t OffsetToPage(std::size_t offset) {
         return Common::AlignDown<std::size_t>(offset, cache_line_size);
     }
@@ -119,6 +143,9 @@ public:
                 return nullptr;
             }
             auto res = std::make_shared<ArticCache>(cli);
+            if (AllowsPersistentCache() && ArticDiskCache::IsEnabled()) {
+                res->EnableDiskCache(path);
+            }
             file_caches->insert({path, res});
             return res;
         }
@@ -131,6 +158,11 @@ public:
         }
     }
 
+    /// Whether the archive content is read-only, so that it can be kept in the disk cache.
+    virtual bool AllowsPersistentCache() const {
+        return false;
+    }
+
     virtual void EnsureCacheCreated() {
         if (file_caches == nullptr) {
             file_caches =
@@ -0,0 +1,258 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/swap.h"
+#include "core/file_sys/artic_disk_cache.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr u32 BLOCK_MAGIC = 0x43445241; // "ARDC"
+constexpr u32 BLOCK_VERSION = 1;
+
+struct BlockHeader {
+    u32_le magic;
+    u32_le version;
+    u32_le data_size;
+    u32_le reserved;
+    u64_le data_hash;
+    u64_le last_used;
+};
+static_assert(sizeof(BlockHeader) == 0x20, "BlockHeader has incorrect size.");
+
+std::string GetRootPath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "artic" DIR_SEP;
+}
+
+u64 GetCurrentTime() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::seconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count());
+}
+
+/**
+ * Keeps track of the total size of the store and of the blocks being written, shared by all the
+ * cache instances. Blocks only store the time they were written, reads during this session are
+ * tracked here instead of rewriting the block headers.
+ */
+class DiskCacheIndex {
+public:
+    void OnBlockRead(const std::string& path) {
+        std::scoped_lock lock{mutex};
+        last_used.insert_or_assign(path, GetCurrentTime());
+    }
+
+    /// Returns false if another thread is already writing the block at path.
+    bool BeginWrite(const std::string& path) {
+        std::scoped_lock lock{mutex};
+        return pending_writes.insert(path).second;
+    }
+
+    void EndWrite(const std::string& path) {
+        std::scoped_lock lock{mutex};
+        pending_writes.erase(path);
+    }
+
+    /// Returns a temporary file name for a write to path that no other writer uses.
+    std::string GetTemporaryPath(const std::string& path) {
+        return fmt::format("{}.{}.tmp", path, next_temporary_id++);
+    }
+
+    void OnBlockWritten(std::size_t size) {
+        std::scoped_lock lock{mutex};
+        if (!total_size) {
+            total_size = 0;
+            for (const auto& block : ListBlocks()) {
+                *total_size += block.size;
+            }
+        }
+        *total_size += size;
+
+        const u64 limit =
+            static_cast<u64>(Settings::values.artic_disk_cache_size_mb.GetValue()) * 1024 * 1024;
+        if (*total_size > limit) {
+            // Evict a bit more than needed so that this does not run on every write.
+            Evict(limit - limit / 10);
+        }
+    }
+
+private:
+    struct BlockEntry {
+        std::string path;
+        u64 size;
+        u64 last_used;
+    };
+
+    std::vector<BlockEntry> ListBlocks() {
+        // ScanDirectoryTree adds its own separator, without this the listed paths would not match
+        // the ones built by GetBlockPath that the maps are keyed by.
+        std::string root_path = GetRootPath();
+        root_path.pop_back();
+
+        FileUtil::FSTEntry root;
+        FileUtil::ScanDirectoryTree(root_path, root, 1);
+        std::vector<FileUtil::FSTEntry> files;
+        FileUtil::GetAllFilesFromNestedEntries(root, files);
+
+        std::vector<BlockEntry> blocks;
+        blocks.reserve(files.size());
+        for (const auto& file : files) {
+            // Temporary files of writes in flight are not blocks yet
+            if (file.virtualName.ends_with(".tmp")) {
+                continue;
+            }
+            blocks.push_back({file.physicalName, file.size, 0});
+        }
+        return blocks;
+    }
+
+    void Evict(u64 target_size) {
+        auto blocks = ListBlocks();
+        for (auto& block : blocks) {
+            BlockHeader header{};
+            FileUtil::IOFile file(block.path, "rb");
+            if (file.ReadBytes(&header, sizeof(header)) == sizeof(header)) {
+                block.last_used = header.last_used;
+            }
+            if (const auto it = last_used.find(block.path); it != last_used.end()) {
+                block.last_used = std::max(block.last_used, it->second);
+            }
+        }
+        std::sort(blocks.begin(), blocks.end(),
+                  [](const auto& a, const auto& b) { return a.last_used < b.last_used; });
+
+        u64 size = 0;
+        for (const auto& block : blocks) {
+            size += block.size;
+        }
+        for (const auto& block : blocks) {
+            if (size <= target_size) {
+                break;
+            }
+            if (pending_writes.contains(block.path)) {
+                continue;
+            }
+            if (FileUtil::Delete(block.path)) {
+                size -= block.size;
+                last_used.erase(block.path);
+            }
+        }
+        LOG_DEBUG(Service_FS, "Artic disk cache trimmed to {} bytes", size);
+        total_size = size;
+    }
+
+    std::mutex mutex;
+    std::optional<u64> total_size;
+    std::unordered_map<std::string, u64> last_used;
+    std::unordered_set<std::string> pending_writes;
+    std::atomic<u64> next_temporary_id{0};
+};
+
+DiskCacheIndex& GetIndex() {
+    static DiskCacheIndex index;
+    return index;
+}
+
+} // Anonymous namespace
+
+ArticDiskCache::ArticDiskCache(std::span<const u8> key) {
+    directory = fmt::format("{}{:016X}" DIR_SEP, GetRootPath(),
+                            Common::ComputeHash64(key.data(), key.size()));
+}
+
+std::optional<std::size_t> ArticDiskCache::ReadBlock(std::size_t block_offset, u8* out) {
+    const std::string path = GetBlockPath(block_offset);
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        return std::nullopt;
+    }
+
+    BlockHeader header{};
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) || header.magic != BLOCK_MAGIC ||
+        header.version != BLOCK_VERSION || header.data_size > BLOCK_SIZE ||
+        file.ReadBytes(out, header.data_size) != header.data_size ||
+        Common::ComputeHash64(out, header.data_size) != header.data_hash) {
+        LOG_WARNING(Service_FS, "Discarding invalid Artic disk cache block {}", path);
+        file.Close();
+        FileUtil::Delete(path);
+        return std::nullopt;
+    }
+
+    GetIndex().OnBlockRead(path);
+    return header.data_size;
+}
+
+bool ArticDiskCache::HasBlock(std::size_t block_offset) const {
+    return FileUtil::Exists(GetBlockPath(block_offset));
+}
+
+void ArticDiskCache::WriteBlock(std::size_t block_offset, const u8* data, std::size_t size) {
+    ASSERT(size <= BLOCK_SIZE);
+
+    if (!FileUtil::CreateFullPath(directory)) {
+        return;
+    }
+
+    BlockHeader header{};
+    header.magic = BLOCK_MAGIC;
+    header.version = BLOCK_VERSION;
+    header.data_size = static_cast<u32>(size);
+    header.data_hash = Common::ComputeHash64(data, size);
+    header.last_used = GetCurrentTime();
+
+    // The content is read-only, so if another thread is already storing this block there is
+    // nothing left to do.
+    auto& index = GetIndex();
+    const std::string path = GetBlockPath(block_offset);
+    if (!index.BeginWrite(path)) {
+        return;
+    }
+
+    // Write to a temporary file first, so that an interrupted write never leaves a block that
+    // looks valid behind.
+    const std::string temp_path = index.GetTemporaryPath(path);
+    bool written = false;
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        written = file.IsOpen() && file.WriteBytes(&header, sizeof(header)) == sizeof(header) &&
+                  file.WriteBytes(data, size) == size;
+    }
+    if (written) {
+        FileUtil::Delete(path);
+        written = FileUtil::Rename(temp_path, path);
+    }
+    if (!written) {
+        FileUtil::Delete(temp_path);
+    }
+    index.EndWrite(path);
+
+    if (written) {
+        index.OnBlockWritten(sizeof(header) + size);
+    }
+}
+
+bool ArticDiskCache::IsEnabled() {
+    return Settings::values.use_artic_disk_cache.GetValue();
+}
+
+std::string ArticDiskCache::GetBlockPath(std::size_t block_offset) const {
+    return fmt::format("{}{:016X}.bin", directory, block_offset);
+}
+
+} // namespace FileSys
@@ -0,0 +1,52 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include "common/common_types.h"
+
+namespace FileSys {
+
+/**
+ * Persistent on-disk store for read-only content fetched through Artic Base, such as RomFS and
+ * ExeFS data. Content is stored in fixed size blocks, one file per block, under a directory derived
+ * from a key that identifies the title and archive path. Every block carries a hash of its data and
+ * is discarded if it does not match. The total size of the store is capped, evicting the least
+ * recently used blocks first.
+ */
+class ArticDiskCache {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    /**
+     * @param key Bytes uniquely identifying the cached content, it must include the title ID and
+     * the archive/file path.
+     */
+    explicit ArticDiskCache(std::span<const u8> key);
+
+    /**
+     * Reads the block starting at block_offset into out, which must be BLOCK_SIZE bytes long.
+     * @returns The amount of valid bytes in the block, or std::nullopt if it is not cached.
+     */
+    std::optional<std::size_t> ReadBlock(std::size_t block_offset, u8* out);
+
+    /// Returns whether the block starting at block_offset is present, without validating it.
+    bool HasBlock(std::size_t block_offset) const;
+
+    /// Stores a block starting at block_offset. A block shorter than BLOCK_SIZE marks the file end.
+    void WriteBlock(std::size_t block_offset, const u8* data, std::size_t size);
+
+    /// Returns whether the persistent cache has been enabled by the user.
+    static bool IsEnabled();
+
+private:
+    std::string GetBlockPath(std::size_t block_offset) const;
+
+    std::string directory;
+};
+
+} // namespace FileSys
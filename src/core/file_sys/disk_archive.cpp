@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include "common/archives.h"
 #include "common/common_types.h"
@@ -21,8 +22,11 @@ ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length
     if (!mode.read_flag)
         return ResultInvalidOpenFlags;
 
-    file->Seek(offset, SEEK_SET);
-    return file->ReadBytes(buffer, length);
+    // Positional reads don't use the file pointer, so concurrent requests can share the file
+    const std::size_t read = file->ReadAtBytes(buffer, length, offset);
+    if (read == std::numeric_limits<std::size_t>::max())
+        return std::size_t{0};
+    return read;
 }
 
 ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t length, const bool flush,
@@ -30,8 +34,9 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ResultInvalidOpenFlags;
 
-    file->Seek(offset, SEEK_SET);
-    std::size_t written = file->WriteBytes(buffer, length);
+    std::size_t written = file->WriteAtBytes(buffer, length, offset);
+    if (written == std::numeric_limits<std::size_t>::max())
+        written = 0;
     if (flush)
         file->Flush();
     return written;
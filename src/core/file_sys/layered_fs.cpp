@@ -4,11 +4,14 @@
 
 #include <algorithm>
 #include <cstring>
+#include <optional>
+#include <fmt/format.h>
 #include "common/alignment.h"
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
@@ -23,6 +26,8 @@ struct FileRelocationInfo {
     u64 original_offset;           // Type 0. Offset is absolute
     std::string replace_file_path; // Type 1
     std::vector<u8> patched_file;  // Type 2
+    std::string patch_file_path;   // Type 2
+    u64 original_size;             // Type 2. Size of the original data the patch was applied to
     u64 size;                      // Relocated file size
 };
 struct LayeredFS::File {
@@ -54,12 +59,38 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+constexpr u32 METADATA_CACHE_MAGIC = 0x4346534C; // "LSFC"
+constexpr u32 METADATA_CACHE_VERSION = 1;
+
+struct MetadataCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le key;
+    u64_le metadata_size;
+    u64_le data_size;
+    u64_le extent_count;
+};
+static_assert(sizeof(MetadataCacheHeader) == 0x28, "Size of MetadataCacheHeader is not correct");
+
+struct MetadataCacheExtent {
+    u64_le data_offset;
+    u64_le original_offset;
+    u64_le original_size;
+    u64_le size;
+    u32_le type;
+    u32_le source_path_length; // Absolute path of the replacement or patch file
+    u32_le path_length;        // Path of the file in the RomFS
+    u32_le reserved;
+};
+static_assert(sizeof(MetadataCacheExtent) == 0x30, "Size of MetadataCacheExtent is not correct");
+
 LayeredFS::LayeredFS() = default;
 
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
-                     std::string patch_ext_path_, bool load_relocations_)
+                     std::string patch_ext_path_, bool load_relocations_, u64 title_id_)
     : romfs(std::move(romfs_)), patch_path(std::move(patch_path_)),
-      patch_ext_path(std::move(patch_ext_path_)), load_relocations(load_relocations_) {
+      patch_ext_path(std::move(patch_ext_path_)), load_relocations(load_relocations_),
+      title_id(title_id_) {
     Load();
 }
 
@@ -68,6 +99,21 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    if (!patch_ext_path.empty() &&
+        (patch_ext_path.back() == '/' || patch_ext_path.back() == '\\')) {
+        // ScanDirectoryTree expects a path without trailing '/'
+        patch_ext_path.erase(patch_ext_path.size() - 1, 1);
+    }
+
+    // Without any patch directory there is nothing expensive to cache
+    std::optional<u64> cache_key;
+    if (load_relocations && (FileUtil::Exists(patch_path) || FileUtil::Exists(patch_ext_path))) {
+        cache_key = GetMetadataCacheKey();
+        if (LoadMetadataCache(*cache_key)) {
+            return;
+        }
+    }
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
     LoadDirectory(root, 0);
@@ -78,6 +124,10 @@ void LayeredFS::Load() {
     }
 
     RebuildMetadata();
+
+    if (cache_key) {
+        SaveMetadataCache(*cache_key);
+    }
 }
 
 LayeredFS::~LayeredFS() = default;
@@ -192,11 +242,6 @@ void LayeredFS::LoadExtRelocations() {
         return;
     }
 
-    if (patch_ext_path.back() == '/' || patch_ext_path.back() == '\\') {
-        // ScanDirectoryTree expects a path without trailing '/'
-        patch_ext_path.erase(patch_ext_path.size() - 1, 1);
-    }
-
     FileUtil::FSTEntry result;
     FileUtil::ScanDirectoryTree(patch_ext_path, result, 256);
 
@@ -230,45 +275,250 @@ void LayeredFS::LoadExtRelocations() {
                 continue;
             }
 
-            FileUtil::IOFile patch_file(entry.physicalName, "rb");
-            if (!patch_file) {
-                LOG_ERROR(Service_FS, "LayeredFS Could not open file {}", entry.physicalName);
-                continue;
-            }
+            auto& file = *file_path_map[file_path];
+            PatchFile(file, entry.physicalName, file.relocation.size);
+        } else {
+            LOG_WARNING(Service_FS, "LayeredFS unknown ext file {}", path);
+        }
+    }
+}
 
-            const auto size = patch_file.GetSize();
-            std::vector<u8> patch(size);
-            if (patch_file.ReadBytes(patch.data(), size) != size) {
-                LOG_ERROR(Service_FS, "LayeredFS Could not read file {}", entry.physicalName);
-                continue;
-            }
+bool LayeredFS::PatchFile(File& file, const std::string& patch_file_path,
+                          std::size_t original_size) {
+    FileUtil::IOFile patch_file(patch_file_path, "rb");
+    if (!patch_file) {
+        LOG_ERROR(Service_FS, "LayeredFS Could not open file {}", patch_file_path);
+        return false;
+    }
 
-            auto& file = *file_path_map[file_path];
-            std::vector<u8> buffer(file.relocation.size); // Original size
-            romfs->ReadFile(file.relocation.original_offset, buffer.size(), buffer.data());
+    const auto size = patch_file.GetSize();
+    std::vector<u8> patch(size);
+    if (patch_file.ReadBytes(patch.data(), size) != size) {
+        LOG_ERROR(Service_FS, "LayeredFS Could not read file {}", patch_file_path);
+        return false;
+    }
 
-            bool ret = false;
-            if (extension == ".ips") {
-                ret = Patch::ApplyIpsPatch(patch, buffer);
-            } else {
-                ret = Patch::ApplyBpsPatch(patch, buffer);
-            }
+    std::vector<u8> buffer(original_size);
+    romfs->ReadFile(file.relocation.original_offset, buffer.size(), buffer.data());
 
-            if (ret) {
-                LOG_INFO(Service_FS, "LayeredFS patched file {}", file_path);
+    bool ret = false;
+    if (patch_file_path.ends_with(".ips")) {
+        ret = Patch::ApplyIpsPatch(patch, buffer);
+    } else {
+        ret = Patch::ApplyBpsPatch(patch, buffer);
+    }
 
-                file.relocation.type = 2;
-                file.relocation.size = buffer.size();
-                file.relocation.patched_file = std::move(buffer);
-            } else {
-                LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file_path);
-            }
+    if (!ret) {
+        LOG_ERROR(Service_FS, "LayeredFS failed to patch file {}", file.path);
+        return false;
+    }
+
+    LOG_INFO(Service_FS, "LayeredFS patched file {}", file.path);
+
+    file.relocation.type = 2;
+    file.relocation.size = buffer.size();
+    file.relocation.original_size = original_size;
+    file.relocation.patch_file_path = patch_file_path;
+    file.relocation.patched_file = std::move(buffer);
+    return true;
+}
+
+static void AppendFingerprint(const FileUtil::FSTEntry& entry, std::size_t root_length,
+                              std::vector<std::string>& out) {
+    for (const auto& child : entry.children) {
+        const auto path = child.physicalName.substr(root_length);
+        if (child.isDirectory) {
+            out.push_back(path + DIR_SEP);
+            AppendFingerprint(child, root_length, out);
         } else {
-            LOG_WARNING(Service_FS, "LayeredFS unknown ext file {}", path);
+            out.push_back(fmt::format("{}:{}:{}", path, child.size,
+                                      FileUtil::GetModificationTime(child.physicalName)));
         }
     }
 }
 
+u64 LayeredFS::GetMetadataCacheKey() {
+    std::vector<u8> base_metadata(header.file_data_offset);
+    romfs->ReadFile(0, base_metadata.size(), base_metadata.data());
+    u64 key = Common::ComputeHash64(base_metadata.data(), base_metadata.size());
+
+    // Only the directory entries are looked at, file contents are not read
+    std::vector<std::string> entries;
+    for (const auto& directory : {patch_path, patch_ext_path}) {
+        if (directory.empty() || !FileUtil::Exists(directory)) {
+            continue;
+        }
+        FileUtil::FSTEntry result;
+        FileUtil::ScanDirectoryTree(directory, result, 256);
+        entries.push_back(directory + '|');
+        AppendFingerprint(result, directory.size(), entries);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for (const auto& entry : entries) {
+        key = Common::HashCombine(key, Common::ComputeHash64(entry.data(), entry.size()));
+    }
+    return key;
+}
+
+std::string LayeredFS::GetMetadataCachePath() const {
+    const auto paths = patch_path + '|' + patch_ext_path;
+    return fmt::format("{}layeredfs" DIR_SEP "{:016X}_{:016X}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), title_id,
+                       Common::ComputeHash64(paths.data(), paths.size()));
+}
+
+bool LayeredFS::LoadMetadataCache(u64 key) {
+    const auto cache_path = GetMetadataCachePath();
+    FileUtil::IOFile cache_file(cache_path, "rb");
+    if (!cache_file) {
+        return false;
+    }
+
+    std::vector<u8> data(cache_file.GetSize());
+    if (cache_file.ReadBytes(data.data(), data.size()) != data.size()) {
+        return false;
+    }
+
+    std::size_t position = 0;
+    const auto read = [&data, &position](void* dest, std::size_t size) {
+        if (data.size() - position < size) {
+            return false;
+        }
+        std::memcpy(dest, data.data() + position, size);
+        position += size;
+        return true;
+    };
+    const auto read_string = [&read](std::string& dest, std::size_t size) {
+        dest.resize(size);
+        return read(dest.data(), size);
+    };
+
+    MetadataCacheHeader cache_header;
+    if (!read(&cache_header, sizeof(cache_header)) ||
+        cache_header.magic != METADATA_CACHE_MAGIC ||
+        cache_header.version != METADATA_CACHE_VERSION || cache_header.key != key ||
+        cache_header.metadata_size > data.size() ||
+        cache_header.extent_count > data.size() / sizeof(MetadataCacheExtent)) {
+        return false;
+    }
+
+    std::vector<u8> cached_metadata(cache_header.metadata_size);
+    if (!read(cached_metadata.data(), cached_metadata.size())) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<File>> files;
+    std::vector<DataExtent> extents;
+    for (u64 i = 0; i < cache_header.extent_count; ++i) {
+        MetadataCacheExtent extent;
+        std::string source_path;
+        auto file = std::make_unique<File>();
+        if (!read(&extent, sizeof(extent)) ||
+            !read_string(source_path, extent.source_path_length) ||
+            !read_string(file->path, extent.path_length)) {
+            return false;
+        }
+
+        // ReadFile relies on the extents being sorted and within the data region
+        if ((!extents.empty() && extent.data_offset <= extents.back().offset) ||
+            extent.size > cache_header.data_size ||
+            extent.data_offset > cache_header.data_size - extent.size) {
+            return false;
+        }
+
+        file->relocation.type = extent.type;
+        file->relocation.original_offset = extent.original_offset;
+        file->relocation.size = extent.size;
+        switch (extent.type) {
+        case 0:
+            break;
+        case 1:
+            file->relocation.replace_file_path = std::move(source_path);
+            break;
+        case 2:
+            // Patched data is not stored, the patch is applied again
+            if (!PatchFile(*file, source_path, extent.original_size) ||
+                file->relocation.size != extent.size) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+
+        extents.push_back({extent.data_offset, file.get()});
+        files.push_back(std::move(file));
+    }
+
+    metadata = std::move(cached_metadata);
+    data_extents = std::move(extents);
+    cached_files = std::move(files);
+    current_data_offset = cache_header.data_size;
+
+    LOG_INFO(Service_FS, "LayeredFS loaded rebuilt metadata from {}", cache_path);
+    return true;
+}
+
+void LayeredFS::SaveMetadataCache(u64 key) const {
+    std::vector<u8> data;
+    const auto write = [&data](const void* src, std::size_t size) {
+        const auto* bytes = static_cast<const u8*>(src);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+
+    MetadataCacheHeader cache_header{};
+    cache_header.magic = METADATA_CACHE_MAGIC;
+    cache_header.version = METADATA_CACHE_VERSION;
+    cache_header.key = key;
+    cache_header.metadata_size = metadata.size();
+    cache_header.data_size = current_data_offset;
+    cache_header.extent_count = data_extents.size();
+    write(&cache_header, sizeof(cache_header));
+    write(metadata.data(), metadata.size());
+
+    for (const auto& [offset, file] : data_extents) {
+        const auto& relocation = file->relocation;
+        const auto& source_path =
+            relocation.type == 1 ? relocation.replace_file_path : relocation.patch_file_path;
+
+        MetadataCacheExtent extent{};
+        extent.data_offset = offset;
+        extent.original_offset = relocation.original_offset;
+        extent.original_size = relocation.original_size;
+        extent.size = relocation.size;
+        extent.type = relocation.type;
+        extent.source_path_length = static_cast<u32>(source_path.size());
+        extent.path_length = static_cast<u32>(file->path.size());
+        write(&extent, sizeof(extent));
+        write(source_path.data(), source_path.size());
+        write(file->path.data(), file->path.size());
+    }
+
+    const auto cache_path = GetMetadataCachePath();
+    if (!FileUtil::CreateFullPath(cache_path)) {
+        LOG_ERROR(Service_FS, "LayeredFS could not create directory for {}", cache_path);
+        return;
+    }
+
+    // Write to a temporary file first, so that an interrupted write never leaves a truncated cache
+    const std::string temp_path = cache_path + ".tmp";
+    bool written = false;
+    {
+        FileUtil::IOFile cache_file(temp_path, "wb");
+        written = cache_file.IsOpen() &&
+                  cache_file.WriteBytes(data.data(), data.size()) == data.size();
+    }
+    if (written) {
+        FileUtil::Delete(cache_path);
+        written = FileUtil::Rename(temp_path, cache_path);
+    }
+    if (!written) {
+        LOG_ERROR(Service_FS, "LayeredFS could not write metadata cache {}", cache_path);
+        FileUtil::Delete(temp_path);
+    }
+}
+
 static std::size_t GetNameSize(const std::string& name) {
     std::u16string u16name = Common::UTF8ToUTF16(name);
     return Common::AlignUp(u16name.size() * 2, 4);
@@ -402,7 +652,7 @@ void LayeredFS::BuildFiles() {
         metadata.file_data_length = file->relocation.size;
         current_data_offset += Common::AlignUp(metadata.file_data_length, 16);
         if (metadata.file_data_length != 0) {
-            data_offset_map.emplace(metadata.file_data_offset, file);
+            data_extents.push_back({metadata.file_data_offset, file});
         }
 
         const auto bucket =
@@ -501,34 +751,34 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
         offset -= metadata.size();
     }
 
-    // Read files
-    auto current = (--data_offset_map.upper_bound(offset));
+    // Read files. Extents are assigned in increasing offset order, find the one containing offset.
+    auto current = std::prev(std::upper_bound(
+        data_extents.begin(), data_extents.end(), offset,
+        [](u64 value, const DataExtent& extent) { return value < extent.offset; }));
     while (read_size < length) {
-        const auto relative_offset = offset - current->first;
+        const auto relative_offset = offset - current->offset;
+        auto& file = *current->file;
         std::size_t to_read{};
-        if (current->second->relocation.size > relative_offset) {
-            to_read = std::min<std::size_t>(current->second->relocation.size - relative_offset,
+        if (file.relocation.size > relative_offset) {
+            to_read = std::min<std::size_t>(file.relocation.size - relative_offset,
                                             length - read_size);
         }
         const auto alignment =
-            std::min<std::size_t>(Common::AlignUp(current->second->relocation.size, 16) -
-                                      relative_offset,
+            std::min<std::size_t>(Common::AlignUp(file.relocation.size, 16) - relative_offset,
                                   length - read_size) -
             to_read;
 
         // Read the file in different ways depending on relocation type
-        auto& relocation = current->second->relocation;
+        auto& relocation = file.relocation;
         if (relocation.type == 0) { // none
             romfs->ReadFile(relocation.original_offset + relative_offset, to_read,
                             buffer + read_size);
         } else if (relocation.type == 1) { // replace
-            FileUtil::IOFile replace_file(relocation.replace_file_path, "rb");
-            if (replace_file) {
-                replace_file.Seek(relative_offset, SEEK_SET);
-                replace_file.ReadBytes(buffer + read_size, to_read);
+            std::scoped_lock lock{replace_file_mutex};
+            if (auto* replace_file = GetReplaceFile(file)) {
+                replace_file->ReadAtBytes(buffer + read_size, to_read, relative_offset);
             } else {
-                LOG_ERROR(Service_FS, "Could not open replacement file for {}",
-                          current->second->path);
+                LOG_ERROR(Service_FS, "Could not open replacement file for {}", file.path);
             }
         } else if (relocation.type == 2) { // patch
             std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
@@ -547,6 +797,18 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
     return read_size;
 }
 
+FileUtil::IOFile* LayeredFS::GetReplaceFile(File& file) {
+    auto [cached, handle] = replace_file_handles.request(&file);
+    // A slot that was not cached may still hold the handle of the evicted file
+    if (!cached || !handle) {
+        handle = std::make_unique<FileUtil::IOFile>(file.relocation.replace_file_path, "rb");
+        if (!handle->IsOpen()) {
+            handle.reset();
+        }
+    }
+    return handle.get();
+}
+
 bool LayeredFS::ExtractDirectory(Directory& current, const std::string& target_path) {
     if (!FileUtil::CreateFullPath(target_path + current.path)) {
         LOG_ERROR(Service_FS, "Could not create path {}", target_path + current.path);
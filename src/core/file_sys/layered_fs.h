@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -14,6 +14,8 @@
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/string.hpp>
 #include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/static_lru_cache.h"
 #include "common/swap.h"
 #include "core/file_sys/romfs_reader.h"
 
@@ -41,11 +43,17 @@ static_assert(sizeof(RomFSHeader) == 0x28, "Size of RomFSHeader is not correct")
  * patch_ext_path: Path for RomFS extensions. Files present in this path:
  *  - When with an extension of ".stub", remove the corresponding file in the RomFS.
  *  - When with an extension of ".ips" or ".bps", patch the file in the RomFS.
+ *
+ * Building the RomFS with relocations requires walking both the base RomFS tree and the patch
+ * directories, so the result is cached on disk, in a file per title and set of patch directories.
+ * The cache is keyed by the base RomFS metadata and the path, size and modification time of every
+ * entry of the patch directories.
  */
 class LayeredFS : public RomFSReader {
 public:
     explicit LayeredFS(std::shared_ptr<RomFSReader> romfs, std::string patch_path,
-                       std::string patch_ext_path, bool load_relocations = true);
+                       std::string patch_ext_path, bool load_relocations = true,
+                       u64 title_id = 0);
     ~LayeredFS() override;
 
     std::size_t GetSize() const override;
@@ -71,6 +79,11 @@ private:
         Directory* parent;
     };
 
+    struct DataExtent {
+        u64 offset; // assigned data offset
+        File* file;
+    };
+
     std::string ReadName(u32 offset, u32 name_length);
 
     // Loads the current directory, then its children.
@@ -108,18 +121,44 @@ private:
 
     void Load();
 
+    // Returns an open handle to the replacement file of file, or nullptr if it cannot be opened
+    FileUtil::IOFile* GetReplaceFile(File& file);
+
+    // Applies the patch in patch_file_path to the original data of file, returns true on success
+    bool PatchFile(File& file, const std::string& patch_file_path, std::size_t original_size);
+
+    // Returns the key identifying the base RomFS metadata and the state of the patch directories
+    u64 GetMetadataCacheKey();
+
+    std::string GetMetadataCachePath() const;
+
+    // Loads the rebuilt metadata and data layout from the cache, returns false if it is not valid
+    bool LoadMetadataCache(u64 key);
+
+    void SaveMetadataCache(u64 key) const;
+
     std::shared_ptr<RomFSReader> romfs;
     std::string patch_path;
     std::string patch_ext_path;
     bool load_relocations;
+    u64 title_id; // Title of the RomFS, to keep the metadata caches of a game and its update apart
 
     RomFSHeader header;
     Directory root;
     std::unordered_map<std::string, File*> file_path_map;
     std::unordered_map<std::string, Directory*> directory_path_map;
-    std::map<u64, File*> data_offset_map; // assigned data offset -> file
+    std::vector<DataExtent> data_extents; // files with data, sorted by assigned data offset
     std::vector<u8> metadata;             // Includes header, hash table and metadata
 
+    // Files referenced by data_extents when the layout was loaded from the metadata cache
+    std::vector<std::unique_ptr<File>> cached_files;
+
+    // Handles of the most recently read replacement files, kept open across reads
+    static constexpr std::size_t replace_file_handle_count = 16;
+    Common::StaticLRUCache<File*, std::unique_ptr<FileUtil::IOFile>, replace_file_handle_count>
+        replace_file_handles;
+    std::mutex replace_file_mutex;
+
     // Used for rebuilding header
     std::vector<u32_le> directory_hash_table;
     std::vector<u32_le> file_hash_table;
@@ -145,6 +184,7 @@ private:
         ar & patch_path;
         ar & patch_ext_path;
         ar & load_relocations;
+        ar & title_id;
         if (Archive::is_loading::value) {
             Load();
         }
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <vector>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
@@ -109,7 +110,7 @@ std::vector<std::pair<std::size_t, std::size_t>> DirectRomFSReader::BreakupRead(
 
 ArticRomFSReader::ArticRomFSReader(std::shared_ptr<Network::ArticBase::Client>& cli,
                                    bool is_update_romfs)
-    : client(cli), cache(cli) {
+    : client(cli), is_update_romfs(is_update_romfs), cache(cli) {
     auto req = client->NewRequest("FSUSER_OpenFileDirectly");
 
     FileSys::Path archive(FileSys::LowPathType::Empty, {});
@@ -196,6 +197,11 @@ bool ArticRomFSReader::CacheReady(std::size_t file_offset, std::size_t length) {
     return cache.CacheReady(file_offset, length);
 }
 
+void ArticRomFSReader::EnableDiskCache(u64 title_id) {
+    std::array<u64, 2> key{title_id, is_update_romfs ? 1ULL : 0ULL};
+    cache.EnableDiskCache({reinterpret_cast<const u8*>(key.data()), sizeof(key)});
+}
+
 void ArticRomFSReader::CloseFile() {
     if (romfs_handle != -1) {
         auto req = client->NewRequest("FSFILE_Close");
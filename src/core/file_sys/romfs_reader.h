@@ -123,10 +123,14 @@ public:
 
     void CloseFile();
 
+    /// Backs the reads with the persistent disk cache, keyed by the title ID of the RomFS owner.
+    void EnableDiskCache(u64 title_id);
+
 private:
     std::shared_ptr<Network::ArticBase::Client> client;
     size_t data_size = 0;
     s32 romfs_handle = -1;
+    bool is_update_romfs = false;
     Loader::ResultStatus load_status;
 
     ArticCache cache;
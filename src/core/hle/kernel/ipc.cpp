@@ -31,9 +31,11 @@ Result TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySystem
     auto dst_process = dst_thread->owner_process.lock();
     ASSERT(src_process && dst_process);
 
-    IPC::Header header;
+    std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
+
     // TODO(Subv): Replace by Memory::Read32 when possible.
-    memory.ReadBlock(*src_process, src_address, &header.raw, sizeof(header.raw));
+    memory.ReadBlock(*src_process, src_address, cmd_buf.data(), sizeof(u32));
+    const IPC::Header header{cmd_buf[0]};
 
     std::size_t untranslated_size = 1u + header.normal_params_size;
     std::size_t command_size = untranslated_size + header.translate_params_size;
@@ -41,8 +43,9 @@ Result TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySystem
     // Note: The real kernel does not check that the command length fits into the IPC buffer area.
     ASSERT(command_size <= IPC::COMMAND_BUFFER_LENGTH);
 
-    std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
-    memory.ReadBlock(*src_process, src_address, cmd_buf.data(), command_size * sizeof(u32));
+    // The header has already been read, only fetch the remaining parameters.
+    memory.ReadBlock(*src_process, src_address + sizeof(u32), cmd_buf.data() + 1,
+                     (command_size - 1) * sizeof(u32));
 
     const bool should_record = kernel.GetIPCRecorder().IsEnabled();
 
@@ -103,9 +106,7 @@ Result TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySystem
         case IPC::DescriptorType::StaticBuffer: {
             IPC::StaticBufferDescInfo bufferInfo{descriptor};
             VAddr static_buffer_src_address = cmd_buf[i];
-
-            std::vector<u8> data(bufferInfo.size);
-            memory.ReadBlock(*src_process, static_buffer_src_address, data.data(), data.size());
+            const u32 static_buffer_size = bufferInfo.size;
 
             // Grab the address that the target thread set up to receive the response static buffer
             // and write our data there. The static buffers area is located right after the command
@@ -126,10 +127,25 @@ Result TranslateCommandBuffer(Kernel::KernelSystem& kernel, Memory::MemorySystem
 
             // Note: The real kernel doesn't seem to have any error recovery mechanisms for this
             // case.
-            ASSERT_MSG(target_buffer.descriptor.size >= data.size(),
+            ASSERT_MSG(target_buffer.descriptor.size >= static_buffer_size,
                        "Static buffer data is too big");
 
-            memory.WriteBlock(*dst_process, target_buffer.address, data.data(), data.size());
+            // Copy straight from the source process into the target buffer, without staging the
+            // data in an intermediate host buffer. CopyBlock copies forwards page by page, so
+            // overlapping buffers within one process still go through a temporary copy.
+            const u64 src_end = u64{static_buffer_src_address} + static_buffer_size;
+            const u64 dst_end = u64{target_buffer.address} + static_buffer_size;
+            const bool overlaps = src_process == dst_process && target_buffer.address < src_end &&
+                                  static_buffer_src_address < dst_end;
+            if (overlaps) {
+                std::vector<u8> data(static_buffer_size);
+                memory.ReadBlock(*src_process, static_buffer_src_address, data.data(),
+                                 data.size());
+                memory.WriteBlock(*dst_process, target_buffer.address, data.data(), data.size());
+            } else {
+                memory.CopyBlock(*dst_process, *src_process, target_buffer.address,
+                                 static_buffer_src_address, static_buffer_size);
+            }
 
             cmd_buf[i++] = target_buffer.address;
             break;
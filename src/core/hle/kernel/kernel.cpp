@@ -6,6 +6,7 @@
 #include <boost/serialization/unordered_map.hpp>
 #include <boost/serialization/vector.hpp>
 #include "common/archives.h"
+#include "common/microprofile.h"
 #include "common/serialization/atomic.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/config_mem.h"
@@ -143,6 +144,18 @@ ConfigMem::Handler& KernelSystem::GetConfigMemHandler() {
     return *config_mem_handler;
 }
 
+MICROPROFILE_DEFINE(Kernel_HLELockWait, "Kernel", "HLE Lock Wait", MP_RGB(200, 70, 70));
+
+std::unique_lock<std::recursive_mutex> KernelSystem::AcquireHLELock() {
+    std::unique_lock lock{hle_lock, std::try_to_lock};
+    if (!lock.owns_lock()) {
+        // Only the contended path is profiled, so the uncontended case stays cheap.
+        MICROPROFILE_SCOPE(Kernel_HLELockWait);
+        lock.lock();
+    }
+    return lock;
+}
+
 IPCDebugger::Recorder& KernelSystem::GetIPCRecorder() {
     return *ipc_recorder;
 }
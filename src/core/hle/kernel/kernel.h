@@ -335,6 +335,12 @@ public:
         return hle_lock;
     }
 
+    /**
+     * Acquires the HLE lock. Time spent waiting for another host thread to release it is reported
+     * to microprofile, so that lock contention shows up in profiles.
+     */
+    [[nodiscard]] std::unique_lock<std::recursive_mutex> AcquireHLELock();
+
     /// Map of named ports managed by the kernel, which can be retrieved using the ConnectToPort
     std::unordered_map<std::string, std::shared_ptr<ClientPort>> named_ports;
 
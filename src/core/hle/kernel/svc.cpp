@@ -2391,7 +2391,7 @@ void SVC::CallSVC(u32 immediate) {
     system.perf_stats->BeginSVCProcessing();
 
     // Lock the kernel mutex when we enter the kernel HLE.
-    std::scoped_lock lock{kernel.GetHLELock()};
+    const auto lock = kernel.AcquireHLELock();
 
     DEBUG_ASSERT_MSG(kernel.GetCurrentProcess()->status == ProcessStatus::Running,
                      "Running threads from exiting processes is unimplemented");
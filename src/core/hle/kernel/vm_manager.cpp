@@ -53,7 +53,8 @@ void VirtualMemoryArea::serialize(Archive& ar, const unsigned int) {
 SERIALIZE_IMPL(VirtualMemoryArea)
 
 VMManager::VMManager(Memory::MemorySystem& memory, Kernel::Process& proc)
-    : page_table(std::make_shared<Memory::PageTable>()), memory(memory), process(proc) {
+    : page_table(std::make_shared<Memory::PageTable>()), memory(memory), process(proc),
+      last_found_vma(vma_map.end()) {
     Reset();
 }
 
@@ -63,6 +64,7 @@ void VMManager::Reset() {
     ASSERT(!is_locked);
 
     vma_map.clear();
+    last_found_vma = vma_map.end();
 
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
@@ -77,17 +79,26 @@ void VMManager::Reset() {
 VMManager::VMAHandle VMManager::FindVMA(VAddr target) const {
     if (target >= MAX_ADDRESS) {
         return vma_map.end();
-    } else {
-        return std::prev(vma_map.upper_bound(target));
     }
+
+    if (last_found_vma != vma_map.end()) {
+        const VirtualMemoryArea& vma = last_found_vma->second;
+        if (target >= vma.base && target - vma.base < vma.size) {
+            return last_found_vma;
+        }
+    }
+
+    last_found_vma = std::prev(vma_map.upper_bound(target));
+    return last_found_vma;
 }
 
 ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size, MemoryRef memory,
                                                    u32 size, MemoryState state) {
     ASSERT(!is_locked);
 
-    // Find the first Free VMA.
-    VMAHandle vma_handle = std::find_if(vma_map.begin(), vma_map.end(), [&](const auto& vma) {
+    // Find the first Free VMA. Areas ending before the base can never match, so the search starts
+    // at the area containing it.
+    VMAHandle vma_handle = std::find_if(FindVMA(base), vma_map.cend(), [&](const auto& vma) {
         if (vma.second.type != VMAType::Free)
             return false;
 
@@ -95,11 +106,15 @@ ResultVal<VAddr> VMManager::MapBackingMemoryToBase(VAddr base, u32 region_size,
         return vma_end > base && vma_end >= base + size;
     });
 
-    VAddr target = std::max(base, vma_handle->second.base);
-
     // Do not try to allocate the block if there are no available addresses within the desired
     // region.
-    if (vma_handle == vma_map.end() || target + size > base + region_size) {
+    if (vma_handle == vma_map.end()) {
+        return Result(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
+                      ErrorSummary::OutOfResource, ErrorLevel::Permanent);
+    }
+
+    VAddr target = std::max(base, vma_handle->second.base);
+    if (target + size > base + region_size) {
         return Result(ErrorDescription::OutOfMemory, ErrorModule::Kernel,
                       ErrorSummary::OutOfResource, ErrorLevel::Permanent);
     }
@@ -191,12 +206,15 @@ Result VMManager::UnmapRange(VAddr target, u32 size) {
     CASCADE_RESULT(VMAIter vma, CarveVMARange(target, size));
     const VAddr target_end = target + size;
 
-    const VMAIter end = vma_map.end();
-    // The comparison against the end of the range must be done using addresses since VMAs can be
-    // merged during this process, causing invalidation of the iterators.
-    while (vma != end && vma->second.base < target_end) {
-        vma = std::next(Unmap(vma));
+    // Every area in the range ends up free, so collapse them into the first one and unmap it in a
+    // single pass, instead of unmapping and merging each area separately.
+    const VMAIter range_end = vma_map.lower_bound(target_end);
+    for (VMAIter next = std::next(vma); next != range_end;) {
+        const VMAIter erased = next++;
+        EraseVMA(erased);
     }
+    vma->second.size = size;
+    Unmap(vma);
 
     ASSERT(FindVMA(target)->second.size >= size);
     return ResultSuccess;
@@ -252,6 +270,13 @@ VMManager::VMAIter VMManager::StripIterConstness(const VMAHandle& iter) {
     return vma_map.erase(iter, iter); // Erases an empty range of elements
 }
 
+void VMManager::EraseVMA(VMAIter vma) {
+    if (last_found_vma == vma) {
+        last_found_vma = vma_map.end();
+    }
+    vma_map.erase(vma);
+}
+
 ResultVal<VMManager::VMAIter> VMManager::CarveVMA(VAddr base, u32 size) {
     ASSERT_MSG((size & Memory::CITRA_PAGE_MASK) == 0, "non-page aligned size: {:#10X}", size);
     ASSERT_MSG((base & Memory::CITRA_PAGE_MASK) == 0, "non-page aligned base: {:#010X}", base);
@@ -346,14 +371,14 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
     const VMAIter next_vma = std::next(iter);
     if (next_vma != vma_map.end() && iter->second.CanBeMergedWith(next_vma->second)) {
         iter->second.size += next_vma->second.size;
-        vma_map.erase(next_vma);
+        EraseVMA(next_vma);
     }
 
     if (iter != vma_map.begin()) {
         VMAIter prev_vma = std::prev(iter);
         if (prev_vma->second.CanBeMergedWith(iter->second)) {
             prev_vma->second.size += iter->second.size;
-            vma_map.erase(iter);
+            EraseVMA(iter);
             iter = prev_vma;
         }
     }
@@ -402,6 +427,7 @@ void VMManager::serialize(Archive& ar, const unsigned int) {
     ar & vma_map;
     ar & page_table;
     if (Archive::is_loading::value) {
+        last_found_vma = vma_map.end();
         is_locked = true;
     }
 }
@@ -221,9 +221,20 @@ private:
     /// Updates the pages corresponding to this VMA so they match the VMA's attributes.
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
+    /// Erases the given VMA from the map, keeping the lookup cache consistent.
+    void EraseVMA(VMAIter vma);
+
     Memory::MemorySystem& memory;
     Kernel::Process& process;
 
+    /**
+     * The VMA returned by the last FindVMA call. Lookups tend to hit the same area repeatedly
+     * (mapped buffer accesses, svcQueryMemory loops), so this avoids a tree traversal for them.
+     * Only erasing the VMA invalidates the iterator; splits and merges just change its extents,
+     * which are re-checked on every lookup.
+     */
+    mutable VMAHandle last_found_vma;
+
     // When locked, ChangeMemoryState calls will be ignored, other modification calls will hit an
     // assert. VMManager locks itself after deserialization.
     bool is_locked{};
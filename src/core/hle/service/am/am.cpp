@@ -5,6 +5,9 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <fmt/format.h>
@@ -16,6 +19,7 @@
 #include "common/hacks/hack_manager.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/threadsafe_queue.h"
 #include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/file_sys/certificate.h"
@@ -1050,6 +1054,42 @@ void ContentFile::Cancel(FS::MediaType media_type, u64 title_id) {
     FileUtil::Delete(path);
 }
 
+namespace {
+
+/// Size of the chunks the installed CIA file is read in.
+constexpr std::size_t CIA_INSTALL_CHUNK_SIZE = 4 * 1024 * 1024;
+/// Chunks in flight between the reader thread and the installing thread.
+constexpr std::size_t CIA_INSTALL_CHUNK_COUNT = 4;
+/// Maximum amount of CIAs installed at the same time by InstallCIAs.
+constexpr std::size_t MAX_CONCURRENT_CIA_INSTALLS = 4;
+
+struct CIAInstallChunk {
+    std::vector<u8> data;
+    std::size_t size = 0;
+};
+
+/// Serializes the loader checks of installed contents, loaders may touch the global key slots.
+std::mutex installed_content_check_mutex;
+
+std::unique_ptr<FileUtil::IOFile> OpenCIAFile(const std::string& path) {
+    auto in_file = std::make_unique<FileUtil::IOFile>(path, "rb");
+    if (FileUtil::Z3DSReadIOFile::GetUnderlyingFileMagic(in_file.get()) != std::nullopt) {
+        in_file = std::make_unique<FileUtil::Z3DSReadIOFile>(std::move(in_file));
+    }
+    return in_file;
+}
+
+std::optional<u64> GetCIATitleID(const std::string& path) {
+    auto in_file = OpenCIAFile(path);
+    FileSys::CIAContainer container;
+    if (container.Load(in_file.get()) != Loader::ResultStatus::Success) {
+        return std::nullopt;
+    }
+    return container.GetTitleMetadata().GetTitleID();
+}
+
+} // Anonymous namespace
+
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback) {
     LOG_INFO(Service_AM, "Installing {}...", path);
@@ -1059,12 +1099,7 @@ InstallStatus InstallCIA(const std::string& path,
         return InstallStatus::ErrorFileNotFound;
     }
 
-    std::unique_ptr<FileUtil::IOFile> in_file = std::make_unique<FileUtil::IOFile>(path, "rb");
-    bool is_compressed =
-        FileUtil::Z3DSReadIOFile::GetUnderlyingFileMagic(in_file.get()) != std::nullopt;
-    if (is_compressed) {
-        in_file = std::make_unique<FileUtil::Z3DSReadIOFile>(std::move(in_file));
-    }
+    std::unique_ptr<FileUtil::IOFile> in_file = OpenCIAFile(path);
 
     FileSys::CIAContainer container;
     if (container.Load(in_file.get()) == Loader::ResultStatus::Success) {
@@ -1078,14 +1113,43 @@ InstallStatus InstallCIA(const std::string& path,
             return InstallStatus::ErrorEncrypted;
         }
 
-        std::vector<u8> buffer;
-        buffer.resize(0x10000);
-        auto file_size = in_file->GetSize();
+        // Reading (and decompressing) the source runs on its own thread, overlapped with the
+        // installation of the previous chunks. Chunks are handed back to the reader once written.
+        Common::SPSCQueue<CIAInstallChunk, true> free_chunks;
+        Common::SPSCQueue<CIAInstallChunk, true> read_chunks;
+        for (std::size_t i = 0; i < CIA_INSTALL_CHUNK_COUNT; i++) {
+            free_chunks.Push(CIAInstallChunk{std::vector<u8>(CIA_INSTALL_CHUNK_SIZE)});
+        }
+
+        const auto file_size = in_file->GetSize();
+        std::jthread reader_thread([&](std::stop_token stop_token) {
+            std::size_t remaining = file_size;
+            while (remaining != 0) {
+                auto chunk = free_chunks.PopWait(stop_token);
+                if (stop_token.stop_requested()) {
+                    return;
+                }
+                chunk.size = in_file->ReadBytes(chunk.data.data(),
+                                                std::min(remaining, chunk.data.size()));
+                remaining -= chunk.size;
+                const bool failed = chunk.size == 0;
+                read_chunks.Push(std::move(chunk));
+                if (failed) {
+                    return;
+                }
+            }
+        });
+
         std::size_t total_bytes_read = 0;
         while (total_bytes_read != file_size) {
-            std::size_t bytes_read = in_file->ReadBytes(buffer.data(), buffer.size());
-            auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            false, static_cast<u8*>(buffer.data()));
+            auto chunk = read_chunks.PopWait();
+            if (chunk.size == 0) {
+                LOG_ERROR(Service_AM, "Could not read from CIA file {}", path);
+                return InstallStatus::ErrorAborted;
+            }
+
+            auto result = installFile.Write(static_cast<u64>(total_bytes_read), chunk.size, false,
+                                            false, chunk.data.data());
 
             if (update_callback) {
                 update_callback(total_bytes_read, file_size);
@@ -1095,11 +1159,14 @@ InstallStatus InstallCIA(const std::string& path,
                           result.Code().raw);
                 return InstallStatus::ErrorAborted;
             }
-            total_bytes_read += bytes_read;
+            total_bytes_read += chunk.size;
+            free_chunks.Push(std::move(chunk));
         }
+        reader_thread.join();
         installFile.Close();
 
         InstallStatus install_res = InstallStatus::Success;
+        std::scoped_lock lock{installed_content_check_mutex};
         for (auto result : installFile.GetInstallResults()) {
             if (result.type != CIAFile::InstallResult::Type::APP || result.result.IsError()) {
                 continue;
@@ -1128,6 +1195,69 @@ InstallStatus InstallCIA(const std::string& path,
     return InstallStatus::ErrorInvalid;
 }
 
+void InstallCIAs(const std::vector<std::string>& paths,
+                 std::function<ProgressCallback>&& update_callback,
+                 std::function<InstallReportCallback>&& report_callback) {
+    // CIAs of the same title write to the same directories, so each title is handled by a single
+    // worker. Files that cannot be parsed get a group of their own and fail in InstallCIA.
+    std::vector<std::vector<std::size_t>> groups;
+    std::unordered_map<u64, std::size_t> title_groups;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        const auto title_id = GetCIATitleID(paths[i]);
+        if (title_id) {
+            const auto [it, inserted] = title_groups.try_emplace(*title_id, groups.size());
+            if (!inserted) {
+                groups[it->second].push_back(i);
+                continue;
+            }
+        }
+        groups.push_back({i});
+    }
+
+    // Progress of every file, files that have not started yet use their size on disk as total
+    std::mutex callback_mutex;
+    std::vector<std::pair<std::size_t, std::size_t>> progress(paths.size());
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        progress[i].second = FileUtil::GetSize(paths[i]);
+    }
+    const auto update_progress = [&](std::size_t index, std::size_t written, std::size_t total) {
+        std::scoped_lock lock{callback_mutex};
+        progress[index] = {written, total};
+        if (update_callback) {
+            std::size_t all_written = 0;
+            std::size_t all_total = 0;
+            for (const auto& [file_written, file_total] : progress) {
+                all_written += file_written;
+                all_total += file_total;
+            }
+            update_callback(all_written, all_total);
+        }
+    };
+
+    std::atomic<std::size_t> next_group{0};
+    const auto worker = [&] {
+        for (auto group = next_group++; group < groups.size(); group = next_group++) {
+            for (const auto index : groups[group]) {
+                const auto status =
+                    InstallCIA(paths[index], [&](std::size_t written, std::size_t total) {
+                        update_progress(index, written, total);
+                    });
+                const auto total = progress[index].second;
+                update_progress(index, total, total);
+                if (report_callback) {
+                    std::scoped_lock lock{callback_mutex};
+                    report_callback(paths[index], status);
+                }
+            }
+        }
+    };
+
+    std::vector<std::jthread> workers(std::min(groups.size(), MAX_CONCURRENT_CIA_INSTALLS));
+    for (auto& thread : workers) {
+        thread = std::jthread(worker);
+    }
+}
+
 InstallStatus CheckCIAToInstall(const std::string& path, bool& is_compressed,
                                 bool check_encryption) {
     if (!FileUtil::Exists(path)) {
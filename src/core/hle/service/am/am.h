@@ -122,6 +122,9 @@ constexpr u64 TWL_TITLE_ID_FLAG = 0x0000800000000000ULL;
 // Progress callback for InstallCIA, receives bytes written and total bytes
 using ProgressCallback = void(std::size_t, std::size_t);
 
+// Report callback for InstallCIAs, receives the path and result of each installed file
+using InstallReportCallback = void(const std::string&, InstallStatus);
+
 class NCCHCryptoFile final {
 public:
     NCCHCryptoFile(const std::string& out_file, bool encrypted_content);
@@ -368,6 +371,17 @@ private:
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback = nullptr);
 
+/**
+ * Installs several CIA files, installing CIAs of different titles concurrently. CIAs of the same
+ * title are installed one after another in the given order.
+ * @param paths file paths of the CIA files to install
+ * @param update_callback callback function called with the combined progress of all files
+ * @param report_callback callback function called when the installation of each file finishes
+ */
+void InstallCIAs(const std::vector<std::string>& paths,
+                 std::function<ProgressCallback>&& update_callback = nullptr,
+                 std::function<InstallReportCallback>&& report_callback = nullptr);
+
 /**
  * Checks if the provided path is a valid CIA file
  * that can be installed.
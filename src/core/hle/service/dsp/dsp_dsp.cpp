@@ -396,7 +396,7 @@ DSP_DSP::DSP_DSP(Core::System& system)
         [this]() { this->system.DSP().SetSemaphore(preset_semaphore); });
 
     system.DSP().SetInterruptHandler([dsp_ref = this, &system](InterruptType type, DspPipe pipe) {
-        std::scoped_lock lock{system.Kernel().GetHLELock()};
+        const auto lock = system.Kernel().AcquireHLELock();
         if (dsp_ref) {
             dsp_ref->SignalInterrupt(type, pipe);
         }
@@ -13,6 +13,7 @@
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/core.h"
+#include "core/file_sys/artic_disk_cache.h"
 #include "core/file_sys/certificate.h"
 #include "core/file_sys/ncch_container.h"
 #include "core/file_sys/otp.h"
@@ -777,12 +778,23 @@ ResultStatus Apploader_Artic::ReadExtdataId(u64& out_extdata_id) {
 
 ResultStatus Apploader_Artic::ReadRomFS(std::shared_ptr<FileSys::RomFSReader>& romfs_file) {
     main_romfs_reader = romfs_file = std::make_shared<FileSys::ArticRomFSReader>(client, false);
-    return static_cast<FileSys::ArticRomFSReader*>(romfs_file.get())->OpenStatus();
+    return OpenArticRomFS(romfs_file);
 }
 
 ResultStatus Apploader_Artic::ReadUpdateRomFS(std::shared_ptr<FileSys::RomFSReader>& romfs_file) {
     update_romfs_reader = romfs_file = std::make_shared<FileSys::ArticRomFSReader>(client, true);
-    return static_cast<FileSys::ArticRomFSReader*>(romfs_file.get())->OpenStatus();
+    return OpenArticRomFS(romfs_file);
+}
+
+ResultStatus Apploader_Artic::OpenArticRomFS(std::shared_ptr<FileSys::RomFSReader>& romfs_file) {
+    auto reader = static_cast<FileSys::ArticRomFSReader*>(romfs_file.get());
+    const auto status = reader->OpenStatus();
+    u64 program_id;
+    if (status == ResultStatus::Success && FileSys::ArticDiskCache::IsEnabled() &&
+        ReadProgramId(program_id) == ResultStatus::Success) {
+        reader->EnableDiskCache(program_id);
+    }
+    return status;
 }
 
 ResultStatus Apploader_Artic::DumpRomFS(const std::string& target_path) {
@@ -115,6 +115,9 @@ private:
 
     void EnsureClientConnected();
 
+    /// Returns the open status of an Artic RomFS reader, enabling its disk cache if requested.
+    ResultStatus OpenArticRomFS(std::shared_ptr<FileSys::RomFSReader>& romfs_file);
+
     ExHeader_Header program_exheader{};
     bool program_exheader_loaded = false;
     bool is_initial_setup = false;
@@ -0,0 +1,309 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/swap.h"
+#include "common/zstd_compression.h"
+#include "core/loader/smdh.h"
+#include "core/loader/title_index.h"
+
+namespace Loader {
+
+namespace {
+
+constexpr u32 TITLE_INDEX_MAGIC = MakeMagic('T', 'I', 'D', 'X');
+constexpr u32 TITLE_INDEX_VERSION = 2;
+
+struct TitleIndexHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le entry_count;
+    u64_le build_hash; ///< Hash of the revision that wrote the index, as loaders change over time
+};
+static_assert(sizeof(TitleIndexHeader) == 0x18, "TitleIndexHeader has incorrect size.");
+
+u64 GetBuildHash() {
+    return Common::ComputeHash64(Common::g_scm_rev, std::strlen(Common::g_scm_rev));
+}
+
+/// Fixed part of a stored entry, followed by the path and the SMDH.
+struct StoredTitleIndexEntry {
+    u64_le size;
+    u64_le modification_time;
+    u64_le program_id;
+    u64_le extdata_id;
+    u32_le file_type;
+    u32_le flags;
+    u32_le path_length;
+    u32_le smdh_length;
+};
+static_assert(sizeof(StoredTitleIndexEntry) == 0x30, "StoredTitleIndexEntry has incorrect size.");
+
+enum StoredTitleIndexFlags : u32 {
+    Compressed = 1 << 0,
+    Executable = 1 << 1,
+    Encrypted = 1 << 2,
+    HasProgramId = 1 << 3,
+};
+
+} // Anonymous namespace
+
+TitleIndex::TitleIndex(std::string database_path_) : database_path(std::move(database_path_)) {
+    Load();
+}
+
+TitleIndex::~TitleIndex() {
+    Save();
+}
+
+std::string TitleIndex::GetDefaultPath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "title_index.bin";
+}
+
+std::optional<TitleIndexEntry> TitleIndex::Get(const std::string& path) {
+    const u64 size = FileUtil::GetSize(path);
+    const u64 modification_time = FileUtil::GetModificationTime(path);
+    {
+        std::scoped_lock lock{mutex};
+        seen_paths.insert(path);
+        const auto it = entries.find(path);
+        if (it != entries.end() && it->second.size == size &&
+            it->second.modification_time == modification_time) {
+            if (it->second.file_type == FileType::Error) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+    }
+
+    auto entry = ReadEntry(path, size, modification_time);
+
+    std::scoped_lock lock{mutex};
+    if (entry && entry->is_encrypted) {
+        // Read it again next time, the keys to decrypt it may have been added by then
+        entries.erase(path);
+    } else if (entry) {
+        entries.insert_or_assign(path, *entry);
+    } else {
+        entries.insert_or_assign(path, TitleIndexEntry{.size = size,
+                                                       .modification_time = modification_time,
+                                                       .file_type = FileType::Error});
+    }
+    dirty = true;
+    return entry;
+}
+
+std::vector<std::optional<TitleIndexEntry>> TitleIndex::Get(std::span<const std::string> paths,
+                                                            const std::atomic_bool* stop_flag) {
+    std::vector<std::optional<TitleIndexEntry>> results(paths.size());
+    std::atomic<std::size_t> next_path{0};
+    const auto worker = [&] {
+        for (auto i = next_path++; i < paths.size(); i = next_path++) {
+            if (stop_flag && *stop_flag) {
+                return;
+            }
+            results[i] = Get(paths[i]);
+        }
+    };
+
+    // Most of the time is spent waiting on the files, use every core for the files that changed
+    const std::size_t thread_count =
+        std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), paths.size());
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 1; i < thread_count; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    threads.clear();
+
+    return results;
+}
+
+std::optional<TitleIndexEntry> TitleIndex::ReadEntry(const std::string& path, u64 size,
+                                                     u64 modification_time) {
+    std::unique_ptr<AppLoader> loader = GetLoader(path);
+    if (!loader) {
+        return std::nullopt;
+    }
+
+    TitleIndexEntry entry;
+    entry.size = size;
+    entry.modification_time = modification_time;
+    entry.file_type = loader->GetFileType();
+    entry.is_compressed = loader->IsFileCompressed();
+
+    const auto result = loader->IsExecutable(entry.is_executable);
+    entry.is_encrypted = result == ResultStatus::ErrorEncrypted;
+
+    entry.has_program_id = loader->ReadProgramId(entry.program_id) == ResultStatus::Success;
+    loader->ReadExtdataId(entry.extdata_id);
+
+    if (loader->ReadIcon(entry.smdh) == ResultStatus::ErrorEncrypted) {
+        entry.is_encrypted = true;
+    }
+    if (!IsValidSMDH(entry.smdh)) {
+        entry.smdh.clear();
+    }
+
+    return entry;
+}
+
+void TitleIndex::Load() {
+    FileUtil::IOFile file(database_path, "rb");
+    if (!file) {
+        return;
+    }
+
+    TitleIndexHeader header;
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != TITLE_INDEX_MAGIC || header.version != TITLE_INDEX_VERSION) {
+        LOG_WARNING(Loader, "Ignoring invalid title index {}", database_path);
+        return;
+    }
+    if (header.build_hash != GetBuildHash()) {
+        LOG_INFO(Loader, "Title index {} was written by another build, rebuilding it",
+                 database_path);
+        return;
+    }
+
+    std::vector<u8> compressed(file.GetSize() - sizeof(header));
+    if (file.ReadBytes(compressed.data(), compressed.size()) != compressed.size()) {
+        LOG_WARNING(Loader, "Could not read title index {}", database_path);
+        return;
+    }
+    const auto data = Common::Compression::DecompressDataZSTD(compressed);
+
+    std::size_t position = 0;
+    const auto read = [&data, &position](void* dest, std::size_t size) {
+        if (data.size() - position < size) {
+            return false;
+        }
+        std::memcpy(dest, data.data() + position, size);
+        position += size;
+        return true;
+    };
+
+    std::unordered_map<std::string, TitleIndexEntry> loaded_entries;
+    for (u64 i = 0; i < header.entry_count; i++) {
+        StoredTitleIndexEntry stored;
+        std::string path;
+        TitleIndexEntry entry;
+        if (!read(&stored, sizeof(stored)) || stored.path_length > data.size() ||
+            stored.smdh_length > data.size()) {
+            LOG_WARNING(Loader, "Ignoring truncated title index {}", database_path);
+            return;
+        }
+
+        path.resize(stored.path_length);
+        entry.smdh.resize(stored.smdh_length);
+        if (!read(path.data(), path.size()) || !read(entry.smdh.data(), entry.smdh.size())) {
+            LOG_WARNING(Loader, "Ignoring truncated title index {}", database_path);
+            return;
+        }
+
+        entry.size = stored.size;
+        entry.modification_time = stored.modification_time;
+        entry.file_type = static_cast<FileType>(static_cast<u32>(stored.file_type));
+        entry.is_compressed = (stored.flags & StoredTitleIndexFlags::Compressed) != 0;
+        entry.is_executable = (stored.flags & StoredTitleIndexFlags::Executable) != 0;
+        entry.is_encrypted = (stored.flags & StoredTitleIndexFlags::Encrypted) != 0;
+        entry.has_program_id = (stored.flags & StoredTitleIndexFlags::HasProgramId) != 0;
+        entry.program_id = stored.program_id;
+        entry.extdata_id = stored.extdata_id;
+        loaded_entries.insert_or_assign(std::move(path), std::move(entry));
+    }
+
+    std::scoped_lock lock{mutex};
+    entries = std::move(loaded_entries);
+    LOG_INFO(Loader, "Loaded {} entries from title index", entries.size());
+}
+
+void TitleIndex::RemoveUnseen() {
+    std::scoped_lock lock{mutex};
+    const auto removed = std::erase_if(
+        entries, [this](const auto& item) { return !seen_paths.contains(item.first); });
+    if (removed > 0) {
+        dirty = true;
+    }
+    seen_paths.clear();
+}
+
+void TitleIndex::Save() {
+    std::scoped_lock lock{mutex};
+    if (!dirty) {
+        return;
+    }
+
+    std::vector<u8> data;
+    const auto write = [&data](const void* src, std::size_t size) {
+        const auto* bytes = static_cast<const u8*>(src);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+
+    u64 entry_count = 0;
+    for (const auto& [path, entry] : entries) {
+        if (entry.file_type == FileType::Error) {
+            continue;
+        }
+        entry_count++;
+
+        StoredTitleIndexEntry stored{};
+        stored.size = entry.size;
+        stored.modification_time = entry.modification_time;
+        stored.program_id = entry.program_id;
+        stored.extdata_id = entry.extdata_id;
+        stored.file_type = static_cast<u32>(entry.file_type);
+        stored.flags = (entry.is_compressed ? StoredTitleIndexFlags::Compressed : 0) |
+                       (entry.is_executable ? StoredTitleIndexFlags::Executable : 0) |
+                       (entry.is_encrypted ? StoredTitleIndexFlags::Encrypted : 0) |
+                       (entry.has_program_id ? StoredTitleIndexFlags::HasProgramId : 0);
+        stored.path_length = static_cast<u32>(path.size());
+        stored.smdh_length = static_cast<u32>(entry.smdh.size());
+        write(&stored, sizeof(stored));
+        write(path.data(), path.size());
+        write(entry.smdh.data(), entry.smdh.size());
+    }
+
+    // SMDHs are mostly padding and compress very well
+    const auto compressed = Common::Compression::CompressDataZSTDDefault(data);
+
+    TitleIndexHeader header{};
+    header.magic = TITLE_INDEX_MAGIC;
+    header.version = TITLE_INDEX_VERSION;
+    header.entry_count = entry_count;
+    header.build_hash = GetBuildHash();
+
+    if (!FileUtil::CreateFullPath(database_path)) {
+        LOG_ERROR(Loader, "Could not create directory for title index {}", database_path);
+        return;
+    }
+
+    // Write to a temporary file first, so that an interrupted save never leaves a truncated index
+    const std::string temp_path = database_path + ".tmp";
+    bool written = false;
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        written = file.IsOpen() && file.WriteBytes(&header, sizeof(header)) == sizeof(header) &&
+                  file.WriteBytes(compressed.data(), compressed.size()) == compressed.size();
+    }
+    if (written) {
+        FileUtil::Delete(database_path);
+        written = FileUtil::Rename(temp_path, database_path);
+    }
+    if (!written) {
+        LOG_ERROR(Loader, "Could not write title index {}", database_path);
+        FileUtil::Delete(temp_path);
+        return;
+    }
+    dirty = false;
+}
+
+} // namespace Loader
@@ -0,0 +1,94 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "common/common_types.h"
+#include "core/loader/loader.h"
+
+namespace Loader {
+
+/// Metadata of a title file as read through its loader, everything a game list shows about it.
+struct TitleIndexEntry {
+    u64 size = 0;              ///< Size of the file on disk
+    u64 modification_time = 0; ///< Last modification time of the file
+    FileType file_type = FileType::Unknown;
+    bool is_compressed = false;
+    bool is_executable = false;
+    bool is_encrypted = false; ///< Whether the loader failed to read the file due to encryption
+    bool has_program_id = false;
+    u64 program_id = 0;
+    u64 extdata_id = 0;
+    std::vector<u8> smdh; ///< SMDH of the file itself, it also holds the region lockout
+};
+
+/**
+ * Persistent index of the metadata of title files, which lets game lists be populated without
+ * opening and parsing every file on each scan. Entries are keyed by file path and read again when
+ * the size or modification time of the file changes, or when the emulator build changes.
+ * Encrypted files are never indexed, as their metadata depends on the keys available. All methods
+ * are thread-safe.
+ */
+class TitleIndex {
+public:
+    /// Loads the index stored at database_path, starting empty if it is missing or invalid.
+    explicit TitleIndex(std::string database_path = GetDefaultPath());
+    ~TitleIndex();
+
+    TitleIndex(const TitleIndex&) = delete;
+    TitleIndex& operator=(const TitleIndex&) = delete;
+
+    /// Returns the path of the index shared by all the frontends, in the cache directory.
+    static std::string GetDefaultPath();
+
+    /**
+     * Returns the metadata of the file at path. The file is only opened if it is not indexed yet
+     * or it changed since it was indexed.
+     * @returns The metadata, or std::nullopt if there is no loader for the file.
+     */
+    std::optional<TitleIndexEntry> Get(const std::string& path);
+
+    /**
+     * Returns the metadata of several files, indexing the ones that changed in parallel.
+     * @param stop_flag Optional stop flag, the remaining files are skipped once it becomes true
+     * @returns The metadata of each file in the order of paths, as returned by Get.
+     */
+    std::vector<std::optional<TitleIndexEntry>> Get(std::span<const std::string> paths,
+                                                    const std::atomic_bool* stop_flag = nullptr);
+
+    /**
+     * Removes the entries of the files that were not looked up since the index was loaded or
+     * this was last called. Meant to be called after a complete scan, to forget removed files.
+     */
+    void RemoveUnseen();
+
+    /// Writes the index to disk if it changed since it was loaded or last saved.
+    void Save();
+
+private:
+    /// Reads the metadata of the file at path through its loader, without touching the index.
+    static std::optional<TitleIndexEntry> ReadEntry(const std::string& path, u64 size,
+                                                    u64 modification_time);
+
+    void Load();
+
+    std::string database_path;
+
+    std::mutex mutex;
+    // Files without a loader are kept with FileType::Error to avoid probing them again, but they
+    // are not saved as a later build may be able to load them
+    std::unordered_map<std::string, TitleIndexEntry> entries;
+    std::unordered_set<std::string> seen_paths; ///< Paths looked up since the last RemoveUnseen
+    bool dirty = false;
+};
+
+} // namespace Loader
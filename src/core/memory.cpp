@@ -30,6 +30,9 @@ SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::N3DS>
 
 namespace Memory {
 
+/// Size of the host address space reserved for each fastmem arena, the full guest address space.
+constexpr std::size_t FASTMEM_ARENA_SIZE = std::size_t{1} << 32;
+
 void PageTable::Clear() {
     pointers.raw.fill(nullptr);
     pointers.refs.fill(MemoryRef());
@@ -44,6 +47,12 @@ public:
             *p = cached;
     }
 
+    void MarkRange(VAddr addr, u32 size, bool cached) {
+        for (VAddr end = addr + size; addr < end; addr += CITRA_PAGE_SIZE) {
+            Mark(addr, cached);
+        }
+    }
+
     bool IsCached(VAddr addr) {
         bool* p = At(addr);
         if (p)
@@ -86,11 +95,15 @@ private:
 
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time
-    // if they are std::array which would exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    // All the emulated RAM lives in a single host allocation, so that it can be mirrored into the
+    // fastmem arenas of the page tables.
+    Common::HostMemory host_memory{FCRAM_N3DS_SIZE + VRAM_SIZE + N3DS_EXTRA_RAM_SIZE};
+    u8* const fcram = host_memory.BackingBasePointer();
+    u8* const vram = fcram + FCRAM_N3DS_SIZE;
+    u8* const n3ds_extra_ram = vram + VRAM_SIZE;
+
+    /// Whether page tables get a fastmem arena, see PageTable::fastmem_arena.
+    bool fastmem_enabled = false;
 
     Core::System& system;
     std::shared_ptr<PageTable> current_page_table = nullptr;
@@ -109,13 +122,13 @@ public:
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -124,13 +137,13 @@ public:
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -155,102 +168,84 @@ public:
         return system.GetRunningCore().GetPC();
     }
 
+    /// Calls Memory::ForEachPageRun with the rasterizer cache pointers of this memory system.
+    template <typename Func>
+    void ForEachPageRun(PageTable& page_table, VAddr vaddr, std::size_t size, Func&& func) {
+        Memory::ForEachPageRun(
+            page_table, vaddr, size,
+            [this](VAddr page_vaddr) { return GetPointerForRasterizerCache(page_vaddr).GetPtr(); },
+            std::forward<Func>(func));
+    }
+
     template <bool UNSAFE>
     void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
                        const std::size_t size) {
         auto& page_table = *process.vm_manager.page_table;
+        u8* dest = static_cast<u8*>(dest_buffer);
 
-        std::size_t remaining_size = size;
-        std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-        std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-            const VAddr current_vaddr =
-                static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-            switch (page_table.attributes[page_index]) {
+        ForEachPageRun(page_table, src_addr, size, [&](PageType type, VAddr run_vaddr, u8* src_ptr,
+                                                       std::size_t run_size) {
+            switch (type) {
             case PageType::Unmapped: {
-                LOG_ERROR(
-                    HW_Memory,
-                    "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                    "0x{:08X}",
-                    current_vaddr, src_addr, size, GetPC());
-                std::memset(dest_buffer, 0, copy_amount);
+                LOG_ERROR(HW_Memory,
+                          "unmapped ReadBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at "
+                          "PC 0x{:08X}",
+                          run_vaddr, src_addr, size, GetPC());
+                std::memset(dest, 0, run_size);
                 break;
             }
             case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
+                std::memcpy(dest, src_ptr, run_size);
                 break;
             }
             case PageType::RasterizerCachedMemory: {
                 if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
+                    RasterizerFlushVirtualRegion(run_vaddr, static_cast<u32>(run_size),
                                                  FlushMode::Flush);
                 }
-                std::memcpy(dest_buffer, GetPointerForRasterizerCache(current_vaddr), copy_amount);
+                std::memcpy(dest, src_ptr, run_size);
                 break;
             }
             default:
                 UNREACHABLE();
             }
-
-            page_index++;
-            page_offset = 0;
-            dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+            dest += run_size;
+        });
     }
 
     template <bool UNSAFE>
     void WriteBlockImpl(const Kernel::Process& process, const VAddr dest_addr,
                         const void* src_buffer, const std::size_t size) {
         auto& page_table = *process.vm_manager.page_table;
-        std::size_t remaining_size = size;
-        std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
-        std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
-
-        while (remaining_size > 0) {
-            const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-            const VAddr current_vaddr =
-                static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+        const u8* src = static_cast<const u8*>(src_buffer);
 
-            switch (page_table.attributes[page_index]) {
+        ForEachPageRun(page_table, dest_addr, size, [&](PageType type, VAddr run_vaddr,
+                                                        u8* dest_ptr, std::size_t run_size) {
+            switch (type) {
             case PageType::Unmapped: {
-                LOG_ERROR(
-                    HW_Memory,
-                    "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                    "0x{:08X}",
-                    current_vaddr, dest_addr, size, GetPC());
+                LOG_ERROR(HW_Memory,
+                          "unmapped WriteBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at "
+                          "PC 0x{:08X}",
+                          run_vaddr, dest_addr, size, GetPC());
                 break;
             }
             case PageType::Memory: {
-                DEBUG_ASSERT(page_table.pointers[page_index]);
-
-                u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
+                std::memcpy(dest_ptr, src, run_size);
                 break;
             }
             case PageType::RasterizerCachedMemory: {
                 if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
+                    RasterizerFlushVirtualRegion(run_vaddr, static_cast<u32>(run_size),
                                                  FlushMode::Invalidate);
                 }
-                std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
+                std::memcpy(dest_ptr, src, run_size);
                 break;
             }
             default:
                 UNREACHABLE();
             }
-
-            page_index++;
-            page_offset = 0;
-            src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
-            remaining_size -= copy_amount;
-        }
+            src += run_size;
+        });
     }
 
     MemoryRef GetPointerForRasterizerCache(VAddr addr) const {
@@ -284,22 +279,21 @@ public:
                 return;
             }
 
-            auto& renderer = system.GPU().Renderer();
+            auto& gpu = system.GPU();
             VAddr overlap_start = std::max(start, region_start);
             VAddr overlap_end = std::min(end, region_end);
             PAddr physical_start = paddr_region_start + (overlap_start - region_start);
             u32 overlap_size = overlap_end - overlap_start;
 
-            auto* rasterizer = renderer.Rasterizer();
             switch (mode) {
             case FlushMode::Flush:
-                rasterizer->FlushRegion(physical_start, overlap_size);
+                gpu.FlushRegion(physical_start, overlap_size);
                 break;
             case FlushMode::Invalidate:
-                rasterizer->InvalidateRegion(physical_start, overlap_size);
+                gpu.InvalidateRegion(physical_start, overlap_size);
                 break;
             case FlushMode::FlushAndInvalidate:
-                rasterizer->FlushAndInvalidateRegion(physical_start, overlap_size);
+                gpu.FlushAndInvalidateRegion(physical_start, overlap_size);
                 break;
             }
         };
@@ -313,19 +307,136 @@ public:
         }
     }
 
+    /**
+     * Calls func(vaddr, size) for every virtual range the physical range [start, end) is visible
+     * at for the rasterizer. This mirrors PhysicalToVirtualAddressForRasterizer, but works on
+     * whole ranges at once.
+     */
+    template <typename Func>
+    void ForEachRasterizerVirtualRange(PAddr start, PAddr end, Func&& func) {
+        PAddr fb_start = 0;
+        PAddr fb_end = 0;
+        if (auto plg_ldr = Service::PLGLDR::GetService(system); plg_ldr) {
+            fb_start = plg_ldr->GetPluginFBAddr();
+            fb_end = fb_start ? fb_start + PLUGIN_3GX_FB_SIZE : 0;
+        }
+        // The plugin framebuffer lives in FCRAM, but it is only visible at its own mapping.
+        const auto clip_to_fb = [&](PAddr addr, PAddr range_end) {
+            return fb_start > addr ? std::min(range_end, fb_start) : range_end;
+        };
+
+        PAddr addr = start;
+        while (addr < end) {
+            PAddr next;
+            if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END) {
+                next = std::min<PAddr>(end, VRAM_PADDR_END);
+                func(addr - VRAM_PADDR + VRAM_VADDR, next - addr);
+            } else if (addr >= fb_start && addr < fb_end) {
+                next = std::min(end, fb_end);
+                func(addr - fb_start + PLUGIN_3GX_FB_VADDR, next - addr);
+            } else if (addr >= FCRAM_PADDR && addr < FCRAM_PADDR_END) {
+                next = clip_to_fb(addr, std::min<PAddr>(end, FCRAM_PADDR_END));
+                func(addr - FCRAM_PADDR + LINEAR_HEAP_VADDR, next - addr);
+                func(addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR, next - addr);
+            } else if (addr >= FCRAM_PADDR_END && addr < FCRAM_N3DS_PADDR_END) {
+                next = clip_to_fb(addr, std::min<PAddr>(end, FCRAM_N3DS_PADDR_END));
+                func(addr - FCRAM_PADDR + NEW_LINEAR_HEAP_VADDR, next - addr);
+            } else {
+                // While the physical <-> virtual mapping is 1:1 for the regions supported by the
+                // cache, some games (like Pokemon Super Mystery Dungeon) will try to use textures
+                // that go beyond the end address of VRAM.
+                LOG_ERROR(HW_Memory,
+                          "Trying to use invalid physical address for rasterizer: {:08X} at PC "
+                          "0x{:08X}",
+                          addr, GetPC());
+                next = end;
+                for (const PAddr region_start : {PAddr{VRAM_PADDR}, fb_start, PAddr{FCRAM_PADDR}}) {
+                    if (region_start > addr && region_start < next) {
+                        next = region_start;
+                    }
+                }
+            }
+            addr = next;
+        }
+    }
+
+    void CreateFastmemArena(PageTable& page_table) {
+        if (!fastmem_enabled) {
+            return;
+        }
+        page_table.fastmem_arena =
+            std::make_unique<Common::VirtualArena>(host_memory, FASTMEM_ARENA_SIZE);
+        if (!page_table.fastmem_arena->IsValid()) {
+            LOG_WARNING(HW_Memory, "Failed to create fastmem arena, fastmem is disabled");
+            page_table.fastmem_arena.reset();
+            fastmem_enabled = false;
+            return;
+        }
+        SyncFastmemArena(page_table, 0, PAGE_TABLE_NUM_ENTRIES);
+    }
+
+    /// Updates the fastmem arena of the page table to reflect the pages [base, base + size).
+    void SyncFastmemArena(PageTable& page_table, u32 base, u32 size) {
+        auto* arena = page_table.fastmem_arena.get();
+        if (!arena || arena->IsDisabled()) {
+            return;
+        }
+
+        const auto& pointers = page_table.GetPointerArray();
+        const u8* backing_begin = host_memory.BackingBasePointer();
+        const u8* backing_end = backing_begin + host_memory.BackingSize();
+        const auto is_mappable = [&](const u8* ptr) {
+            return ptr >= backing_begin && ptr < backing_end;
+        };
+
+        // Pages are handled in runs that are either contiguous in the backing memory or all
+        // unmappable, so that large mappings only take a few host calls.
+        const u32 end = base + size;
+        while (base != end) {
+            const u8* ptr = pointers[base];
+            const bool mappable = is_mappable(ptr);
+            u32 run_end = base + 1;
+            while (run_end != end && is_mappable(pointers[run_end]) == mappable &&
+                   (!mappable ||
+                    pointers[run_end] == ptr + (run_end - base) * std::size_t{CITRA_PAGE_SIZE})) {
+                ++run_end;
+            }
+
+            const std::size_t offset = std::size_t{base} << CITRA_PAGE_BITS;
+            const std::size_t length = std::size_t{run_end - base} << CITRA_PAGE_BITS;
+            // Ranges that can't be mapped are left inaccessible, so that the JIT takes the slow
+            // path for them. If even that fails the arena can't be trusted anymore, and the whole
+            // process falls back to the slow path.
+            if ((!mappable || !arena->Map(offset, ptr - backing_begin, length)) &&
+                !arena->Unmap(offset, length)) {
+                LOG_ERROR(HW_Memory, "Failed to update the fastmem arena, disabling fastmem");
+                if (!arena->Disable()) {
+                    LOG_CRITICAL(HW_Memory, "Failed to disable the fastmem arena");
+                }
+                return;
+            }
+            base = run_end;
+        }
+    }
+
 private:
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
         ar & save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
+        ar& boost::serialization::make_binary_object(vram, Memory::VRAM_SIZE);
         ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+            fcram, save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
         ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+            n3ds_extra_ram, save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
         ar & cache_marker;
         ar & page_table_list;
+        if (Archive::is_loading::value) {
+            for (auto& page_table : page_table_list) {
+                CreateFastmemArena(*page_table);
+            }
+        }
         // dsp is set from Core::System at startup
         ar & current_page_table;
         ar & fcram_mem;
@@ -366,7 +477,11 @@ MemorySystem::Impl::Impl(Core::System& system_)
     : system{system_}, fcram_mem(std::make_shared<BackingMemImpl<Region::FCRAM>>(*this)),
       vram_mem(std::make_shared<BackingMemImpl<Region::VRAM>>(*this)),
       n3ds_extra_ram_mem(std::make_shared<BackingMemImpl<Region::N3DS>>(*this)),
-      dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {}
+      dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {
+    fastmem_enabled = Settings::values.use_cpu_jit.GetValue() &&
+                      Settings::values.use_fastmem.GetValue() && host_memory.IsShareable() &&
+                      Common::VirtualArena::SupportsPageSize(CITRA_PAGE_SIZE);
+}
 
 MemorySystem::MemorySystem(Core::System& system) : impl(std::make_unique<Impl>(system)) {}
 MemorySystem::~MemorySystem() = default;
@@ -417,6 +532,8 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
         if (memory != nullptr && memory.GetSize() > CITRA_PAGE_SIZE)
             memory += CITRA_PAGE_SIZE;
     }
+
+    impl->SyncFastmemArena(page_table, end - size, size);
 }
 
 void MemorySystem::MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, MemoryRef target) {
@@ -437,6 +554,9 @@ MemoryRef MemorySystem::GetPointerForRasterizerCache(VAddr addr) const {
 }
 
 void MemorySystem::RegisterPageTable(std::shared_ptr<PageTable> page_table) {
+    if (!page_table->fastmem_arena) {
+        impl->CreateFastmemArena(*page_table);
+    }
     impl->page_table_list.push_back(page_table);
 }
 
@@ -643,10 +763,8 @@ u8* MemorySystem::GetPhysicalPointer(PAddr address) {
 }
 
 MemoryRef MemorySystem::GetPhysicalRef(PAddr address) {
-    if (address == physical_ptr_cache.first) {
-        return physical_ptr_cache.second;
-    }
-
+    // This is called from both the emulation and the GPU thread, so it keeps no lookup cache: the
+    // lookup is only a few comparisons, and returning the reference copies it either way.
     constexpr std::array memory_areas = {
         std::make_pair(VRAM_PADDR, VRAM_SIZE),
         std::make_pair(DSP_RAM_PADDR, DSP_RAM_SIZE),
@@ -663,8 +781,7 @@ MemoryRef MemorySystem::GetPhysicalRef(PAddr address) {
     if (area == memory_areas.end()) [[unlikely]] {
         LOG_ERROR(HW_Memory, "Unknown GetPhysicalPointer @ {:#08X} at PC {:#08X}", address,
                   impl->GetPC());
-        physical_ptr_cache = {address, {nullptr}};
-        return physical_ptr_cache.second;
+        return {nullptr};
     }
 
     u32 offset_into_region = address - area->first;
@@ -687,12 +804,10 @@ MemoryRef MemorySystem::GetPhysicalRef(PAddr address) {
         UNREACHABLE();
     }
     if (offset_into_region > target_mem->GetSize()) [[unlikely]] {
-        physical_ptr_cache = {address, {nullptr}};
-        return physical_ptr_cache.second;
+        return {nullptr};
     }
 
-    physical_ptr_cache = {address, {target_mem, offset_into_region}};
-    return physical_ptr_cache.second;
+    return {target_mem, offset_into_region};
 }
 
 std::vector<VAddr> MemorySystem::PhysicalToVirtualAddressForRasterizer(PAddr addr) {
@@ -724,53 +839,47 @@ std::vector<VAddr> MemorySystem::PhysicalToVirtualAddressForRasterizer(PAddr add
 }
 
 void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached) {
-    if (start == 0) {
+    if (start == 0 || size == 0) {
         return;
     }
 
-    u32 num_pages = ((start + size - 1) >> CITRA_PAGE_BITS) - (start >> CITRA_PAGE_BITS) + 1;
-    PAddr paddr = start;
-
-    for (unsigned i = 0; i < num_pages; ++i, paddr += CITRA_PAGE_SIZE) {
-        for (VAddr vaddr : PhysicalToVirtualAddressForRasterizer(paddr)) {
-            impl->cache_marker.Mark(vaddr, cached);
-            for (auto& page_table : impl->page_table_list) {
-                PageType& page_type = page_table->attributes[vaddr >> CITRA_PAGE_BITS];
-
+    const PAddr aligned_start = start & ~CITRA_PAGE_MASK;
+    const PAddr aligned_end = (start + size - 1 + CITRA_PAGE_SIZE) & ~CITRA_PAGE_MASK;
+    impl->ForEachRasterizerVirtualRange(aligned_start, aligned_end, [&](VAddr vaddr, u32 length) {
+        const u32 first_page = vaddr >> CITRA_PAGE_BITS;
+        const u32 num_pages = length >> CITRA_PAGE_BITS;
+        impl->cache_marker.MarkRange(vaddr, length, cached);
+
+        // Uncached pages point back into the region, so the reference is only computed once.
+        const MemoryRef region_ref = cached ? MemoryRef{} : GetPointerForRasterizerCache(vaddr);
+
+        for (auto& page_table : impl->page_table_list) {
+            bool changed = false;
+            for (u32 i = 0; i < num_pages; ++i) {
+                PageType& page_type = page_table->attributes[first_page + i];
+                // It is not necessary for a process to have this region mapped into its address
+                // space, for example, a system module need not have a VRAM mapping.
+                if (page_type == PageType::Unmapped) {
+                    continue;
+                }
                 if (cached) {
                     // Switch page type to cached if now cached
-                    switch (page_type) {
-                    case PageType::Unmapped:
-                        // It is not necessary for a process to have this region mapped into its
-                        // address space, for example, a system module need not have a VRAM mapping.
-                        break;
-                    case PageType::Memory:
-                        page_type = PageType::RasterizerCachedMemory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] = nullptr;
-                        break;
-                    default:
-                        UNREACHABLE();
-                    }
+                    ASSERT(page_type == PageType::Memory);
+                    page_type = PageType::RasterizerCachedMemory;
+                    page_table->pointers[first_page + i] = nullptr;
                 } else {
                     // Switch page type to uncached if now uncached
-                    switch (page_type) {
-                    case PageType::Unmapped:
-                        // It is not necessary for a process to have this region mapped into its
-                        // address space, for example, a system module need not have a VRAM mapping.
-                        break;
-                    case PageType::RasterizerCachedMemory: {
-                        page_type = PageType::Memory;
-                        page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
-                            GetPointerForRasterizerCache(vaddr & ~CITRA_PAGE_MASK);
-                        break;
-                    }
-                    default:
-                        UNREACHABLE();
-                    }
+                    ASSERT(page_type == PageType::RasterizerCachedMemory);
+                    page_type = PageType::Memory;
+                    page_table->pointers[first_page + i] = region_ref + i * CITRA_PAGE_SIZE;
                 }
+                changed = true;
+            }
+            if (changed) {
+                impl->SyncFastmemArena(*page_table, first_page, num_pages);
             }
         }
-    }
+    });
 }
 
 u8 MemorySystem::Read8(const VAddr addr) {
@@ -877,44 +986,31 @@ void MemorySystem::WriteBlock(const VAddr dest_addr, const void* src_buffer,
 void MemorySystem::ZeroBlock(const Kernel::Process& process, const VAddr dest_addr,
                              const std::size_t size) {
     auto& page_table = *process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = dest_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = dest_addr & CITRA_PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                      "0x{:08X}",
-                      current_vaddr, dest_addr, size, impl->GetPC());
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-
-            u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-            std::memset(dest_ptr, 0, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Invalidate);
-            std::memset(GetPointerForRasterizerCache(current_vaddr), 0, copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        remaining_size -= copy_amount;
-    }
+    impl->ForEachPageRun(
+        page_table, dest_addr, size,
+        [&](PageType type, VAddr run_vaddr, u8* dest_ptr, std::size_t run_size) {
+            switch (type) {
+            case PageType::Unmapped: {
+                LOG_ERROR(HW_Memory,
+                          "unmapped ZeroBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at "
+                          "PC 0x{:08X}",
+                          run_vaddr, dest_addr, size, impl->GetPC());
+                break;
+            }
+            case PageType::Memory: {
+                std::memset(dest_ptr, 0, run_size);
+                break;
+            }
+            case PageType::RasterizerCachedMemory: {
+                RasterizerFlushVirtualRegion(run_vaddr, static_cast<u32>(run_size),
+                                             FlushMode::Invalidate);
+                std::memset(dest_ptr, 0, run_size);
+                break;
+            }
+            default:
+                UNREACHABLE();
+            }
+        });
 }
 
 void MemorySystem::CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
@@ -926,62 +1022,48 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
                              const Kernel::Process& src_process, VAddr dest_addr, VAddr src_addr,
                              std::size_t size) {
     auto& page_table = *src_process.vm_manager.page_table;
-    std::size_t remaining_size = size;
-    std::size_t page_index = src_addr >> CITRA_PAGE_BITS;
-    std::size_t page_offset = src_addr & CITRA_PAGE_MASK;
-
-    while (remaining_size > 0) {
-        const std::size_t copy_amount = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
-        const VAddr current_vaddr =
-            static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
-
-        switch (page_table.attributes[page_index]) {
-        case PageType::Unmapped: {
-            LOG_ERROR(HW_Memory,
-                      "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at PC "
-                      "0x{:08X}",
-                      current_vaddr, src_addr, size, impl->GetPC());
-            ZeroBlock(dest_process, dest_addr, copy_amount);
-            break;
-        }
-        case PageType::Memory: {
-            DEBUG_ASSERT(page_table.pointers[page_index]);
-            const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-            WriteBlock(dest_process, dest_addr, src_ptr, copy_amount);
-            break;
-        }
-        case PageType::RasterizerCachedMemory: {
-            RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                         FlushMode::Flush);
-            WriteBlock(dest_process, dest_addr, GetPointerForRasterizerCache(current_vaddr),
-                       copy_amount);
-            break;
-        }
-        default:
-            UNREACHABLE();
-        }
-
-        page_index++;
-        page_offset = 0;
-        dest_addr += static_cast<VAddr>(copy_amount);
-        src_addr += static_cast<VAddr>(copy_amount);
-        remaining_size -= copy_amount;
-    }
+    impl->ForEachPageRun(
+        page_table, src_addr, size,
+        [&](PageType type, VAddr run_vaddr, u8* src_ptr, std::size_t run_size) {
+            switch (type) {
+            case PageType::Unmapped: {
+                LOG_ERROR(HW_Memory,
+                          "unmapped CopyBlock @ 0x{:08X} (start address = 0x{:08X}, size = {}) at "
+                          "PC 0x{:08X}",
+                          run_vaddr, src_addr, size, impl->GetPC());
+                ZeroBlock(dest_process, dest_addr, run_size);
+                break;
+            }
+            case PageType::Memory: {
+                WriteBlock(dest_process, dest_addr, src_ptr, run_size);
+                break;
+            }
+            case PageType::RasterizerCachedMemory: {
+                RasterizerFlushVirtualRegion(run_vaddr, static_cast<u32>(run_size),
+                                             FlushMode::Flush);
+                WriteBlock(dest_process, dest_addr, src_ptr, run_size);
+                break;
+            }
+            default:
+                UNREACHABLE();
+            }
+            dest_addr += static_cast<VAddr>(run_size);
+        });
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram && pointer <= impl->fcram + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram);
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
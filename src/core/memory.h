@@ -3,12 +3,15 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
+#include "common/host_memory.h"
 #include "common/memory_ref.h"
 
 namespace Kernel {
@@ -96,10 +99,21 @@ struct PageTable {
      */
     std::array<PageType, PAGE_TABLE_NUM_ENTRIES> attributes;
 
+    /**
+     * Host address space mirroring the guest one, which lets the JIT access memory without going
+     * through this table. Only pages of type `Memory` backed by emulated RAM are mapped, accessing
+     * any other page faults. Null when fastmem is disabled or unsupported by the host.
+     */
+    std::unique_ptr<Common::VirtualArena> fastmem_arena;
+
     std::array<u8*, PAGE_TABLE_NUM_ENTRIES>& GetPointerArray() {
         return pointers.raw;
     }
 
+    u8* GetFastmemPointer() const {
+        return fastmem_arena ? fastmem_arena->VirtualBasePointer() : nullptr;
+    }
+
     void Clear();
 
 private:
@@ -114,6 +128,54 @@ private:
     friend class boost::serialization::access;
 };
 
+/**
+ * Splits [vaddr, vaddr + size) of page_table into runs of pages that have the same type and, unless
+ * unmapped, are contiguous in host memory, and calls func(type, run_vaddr, host_ptr, run_size) for
+ * each of them. This lets block operations flush and copy whole runs at once.
+ * @param get_rasterizer_ptr Returns the host pointer of a rasterizer cached page from its address
+ */
+template <typename GetRasterizerPointer, typename Func>
+void ForEachPageRun(PageTable& page_table, VAddr vaddr, std::size_t size,
+                    GetRasterizerPointer&& get_rasterizer_ptr, Func&& func) {
+    const auto get_host_ptr = [&](std::size_t page_index, PageType type) -> u8* {
+        switch (type) {
+        case PageType::Memory:
+            return page_table.pointers[page_index];
+        case PageType::RasterizerCachedMemory:
+            return get_rasterizer_ptr(static_cast<VAddr>(page_index << CITRA_PAGE_BITS));
+        default:
+            return nullptr;
+        }
+    };
+
+    std::size_t page_index = vaddr >> CITRA_PAGE_BITS;
+    std::size_t page_offset = vaddr & CITRA_PAGE_MASK;
+    std::size_t remaining_size = size;
+
+    while (remaining_size > 0) {
+        const PageType type = page_table.attributes[page_index];
+        u8* const run_ptr = get_host_ptr(page_index, type);
+        std::size_t run_size = std::min(CITRA_PAGE_SIZE - page_offset, remaining_size);
+
+        // Extend the run while the following pages are of the same type and follow in memory
+        std::size_t next_page = page_index + 1;
+        while (run_size < remaining_size && next_page < PAGE_TABLE_NUM_ENTRIES &&
+               page_table.attributes[next_page] == type &&
+               (type == PageType::Unmapped ||
+                get_host_ptr(next_page, type) == run_ptr + page_offset + run_size)) {
+            run_size += std::min<std::size_t>(CITRA_PAGE_SIZE, remaining_size - run_size);
+            ++next_page;
+        }
+
+        const VAddr run_vaddr = static_cast<VAddr>((page_index << CITRA_PAGE_BITS) + page_offset);
+        func(type, run_vaddr, run_ptr ? run_ptr + page_offset : nullptr, run_size);
+
+        page_index = next_page;
+        page_offset = 0;
+        remaining_size -= run_size;
+    }
+}
+
 /// Physical memory regions as seen from the ARM11
 enum : PAddr {
     /// IO register area
@@ -665,8 +727,6 @@ private:
 
     void MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef memory, PageType type);
 
-    std::pair<PAddr, MemoryRef> physical_ptr_cache;
-
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
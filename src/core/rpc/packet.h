@@ -17,6 +17,10 @@ enum class PacketType : u32 {
     WriteMemory = 2,
     ProcessList = 3,
     SetGetProcess = 4,
+    ReadMemoryBatch = 5,
+    Subscribe = 6,
+    Unsubscribe = 7,
+    SubscriptionUpdate = 8,
 };
 
 struct PacketHeader {
@@ -35,12 +39,46 @@ struct ProcessInfo {
 static_assert(sizeof(ProcessInfo) == 0x14, "Incorrect ProcessInfo size");
 #pragma pack(pop)
 
+struct MemoryRange {
+    u32 address;
+    u32 size;
+};
+static_assert(sizeof(MemoryRange) == 0x8, "Incorrect MemoryRange size");
+
+/// Header of the data of a SubscriptionUpdate packet pushed by the server.
+struct SubscriptionUpdateHeader {
+    u32 subscription_id;
+    /// Incremented on every update sent, allows the client to detect lost updates.
+    u32 sequence;
+    /// One of the SubscriptionEncoding values.
+    u32 encoding;
+};
+static_assert(sizeof(SubscriptionUpdateHeader) == 0xC, "Incorrect SubscriptionUpdateHeader size");
+
+enum class SubscriptionEncoding : u32 {
+    /// The update contains the contents of all the watched ranges, back to back.
+    Full = 0,
+    /// The update contains only the changed bytes as a list of DeltaRun, each one followed by
+    /// its data. Offsets refer to the contents of all the watched ranges, back to back.
+    Delta = 1,
+};
+
+#pragma pack(push, 1)
+struct DeltaRun {
+    u16 offset;
+    u16 size;
+};
+static_assert(sizeof(DeltaRun) == 0x4, "Incorrect DeltaRun size");
+#pragma pack(pop)
+
 constexpr u32 CURRENT_VERSION = 1;
 constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
 constexpr u32 MAX_PACKET_DATA_SIZE = 1024;
 constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_PROCESSES_IN_LIST = (MAX_PACKET_DATA_SIZE - sizeof(u32)) / sizeof(ProcessInfo);
+constexpr u32 MAX_RANGES_IN_BATCH = (MAX_PACKET_DATA_SIZE - sizeof(u32) * 2) / sizeof(MemoryRange);
+constexpr u32 MAX_SUBSCRIPTION_SIZE = MAX_PACKET_DATA_SIZE - sizeof(SubscriptionUpdateHeader);
 
 class Packet {
 public:
@@ -76,6 +114,10 @@ public:
         header.packet_size = size;
     }
 
+    void SetPacketType(PacketType type) {
+        header.packet_type = type;
+    }
+
     void SendReply() {
         send_reply_callback(*this);
     }
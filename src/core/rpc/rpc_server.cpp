@@ -2,22 +2,115 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <optional>
 #include "common/logging/log.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
+#include "video_core/gpu.h"
 
 namespace Core::RPC {
 
+namespace {
+
+constexpr std::size_t MAX_SUBSCRIPTIONS = 16;
+
+/// Amount of updates of a subscription after which a full update is sent regardless of the
+/// changes, so that a client that lost an update eventually catches up.
+constexpr u32 SUBSCRIPTION_KEYFRAME_INTERVAL = 60;
+
+/**
+ * Parses the list of ranges following the two arguments of a batched request.
+ * @returns The ranges, or std::nullopt if they are malformed or their total size exceeds max_size.
+ */
+std::optional<std::vector<MemoryRange>> ParseRanges(Packet& packet, u32 count, u32 max_size) {
+    constexpr u32 ranges_offset = sizeof(u32) * 2;
+    if (count == 0 || count > MAX_RANGES_IN_BATCH ||
+        packet.GetPacketDataSize() < ranges_offset + count * sizeof(MemoryRange)) {
+        return std::nullopt;
+    }
+
+    std::vector<MemoryRange> ranges(count);
+    std::memcpy(ranges.data(), packet.GetPacketData().data() + ranges_offset,
+                count * sizeof(MemoryRange));
+
+    u32 total_size = 0;
+    for (const auto& range : ranges) {
+        if (range.size == 0 || range.size > max_size - total_size) {
+            return std::nullopt;
+        }
+        total_size += range.size;
+    }
+    return ranges;
+}
+
+/**
+ * Encodes the bytes of current that differ from previous as a list of DeltaRun into out, which
+ * must be at least current.size() bytes long.
+ * @returns The encoded size, zero if nothing changed, or std::nullopt if the encoding would not be
+ * smaller than current itself.
+ */
+std::optional<u32> EncodeDelta(std::span<const u8> previous, std::span<const u8> current,
+                               u8* out) {
+    const u32 size = static_cast<u32>(current.size());
+    u32 written = 0;
+    u32 offset = 0;
+    while (offset < size) {
+        if (previous[offset] == current[offset]) {
+            offset++;
+            continue;
+        }
+
+        // Unchanged gaps that are not longer than a run header are cheaper to send as part of
+        // the run than to start a new one.
+        u32 last_changed = offset;
+        for (u32 i = offset + 1; i < size && i - last_changed <= sizeof(DeltaRun); i++) {
+            if (previous[i] != current[i]) {
+                last_changed = i;
+            }
+        }
+
+        const u32 run_size = last_changed + 1 - offset;
+        if (written + sizeof(DeltaRun) + run_size >= size) {
+            return std::nullopt;
+        }
+        const DeltaRun run{static_cast<u16>(offset), static_cast<u16>(run_size)};
+        std::memcpy(out + written, &run, sizeof(run));
+        written += sizeof(run);
+        std::memcpy(out + written, current.data() + offset, run_size);
+        written += run_size;
+        offset = last_changed + 1;
+    }
+    return written;
+}
+
+} // Anonymous namespace
+
 RPCServer::RPCServer(Core::System& system_) : system{system_} {
     LOG_INFO(RPC_Server, "Starting RPC server.");
+    frame_event = system.CoreTiming().RegisterEvent(
+        "RPC::FrameEvent", [this](std::uintptr_t user_data, s64 cycles_late) {
+            FrameCallback(user_data, cycles_late);
+        });
+    ScheduleFrameEvent();
     request_handler_thread =
         std::jthread([this](std::stop_token stop_token) { HandleRequestsLoop(stop_token); });
 }
 
-RPCServer::~RPCServer() = default;
+RPCServer::~RPCServer() {
+    if (system.IsPoweredOn()) {
+        system.CoreTiming().UnscheduleEvent(frame_event, 0);
+    }
+}
+
+void RPCServer::ScheduleFrameEvent() {
+    system.CoreTiming().RemoveEvent(frame_event);
+    system.CoreTiming().ScheduleEvent(VideoCore::FRAME_TICKS, frame_event);
+}
 
 void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
     if (data_size > MAX_READ_SIZE) {
@@ -104,8 +197,9 @@ void RPCServer::HandleSetGetProcess(Packet& packet, u32 operation, u32 process_i
 
     if (operation == 0) {
         // Get
-        memcpy(out_data + written_bytes, &selected_pid, sizeof(selected_pid));
-        written_bytes += sizeof(selected_pid);
+        const u32 pid = selected_pid;
+        memcpy(out_data + written_bytes, &pid, sizeof(pid));
+        written_bytes += sizeof(pid);
     } else {
         // Set
         selected_pid = process_id;
@@ -115,6 +209,176 @@ void RPCServer::HandleSetGetProcess(Packet& packet, u32 operation, u32 process_i
     packet.SendReply();
 }
 
+bool RPCServer::ReadRanges(std::span<const MemoryRange> ranges, u8* out) {
+    std::shared_ptr<Kernel::Process> process;
+    if (const u32 pid = selected_pid; pid != 0xFFFFFFFF) {
+        process = system.Kernel().GetProcessById(pid);
+        if (!process) {
+            LOG_ERROR(RPC_Server, "Selected process does not exist.");
+            return false;
+        }
+    }
+
+    for (const auto& range : ranges) {
+        if (process) {
+            system.Memory().ReadBlock(*process, range.address, out, range.size);
+        } else {
+            system.Memory().ReadBlock(range.address, out, range.size);
+        }
+        out += range.size;
+    }
+    return true;
+}
+
+void RPCServer::HandleReadMemoryBatch(Packet& packet, std::span<const MemoryRange> ranges) {
+    u32 read_size = 0;
+    if (ReadRanges(ranges, packet.GetPacketData().data())) {
+        for (const auto& range : ranges) {
+            read_size += range.size;
+        }
+    }
+
+    packet.SetPacketDataSize(read_size);
+    packet.SendReply();
+}
+
+void RPCServer::HandleSubscribe(std::unique_ptr<Packet> packet, u32 interval_frames,
+                                std::span<const MemoryRange> ranges) {
+    u32 total_size = 0;
+    for (const auto& range : ranges) {
+        total_size += range.size;
+    }
+
+    Subscription subscription{
+        .packet = std::move(packet),
+        .ranges = {ranges.begin(), ranges.end()},
+        .last_sent = std::vector<u8>(total_size),
+        .id = next_subscription_id++,
+        .interval_frames = interval_frames,
+        // Send the initial contents right away
+        .frames_until_update = 0,
+    };
+
+    std::memcpy(subscription.packet->GetPacketData().data(), &subscription.id,
+                sizeof(subscription.id));
+    subscription.packet->SetPacketDataSize(sizeof(subscription.id));
+    subscription.packet->SendReply();
+
+    // Updates are sent with the id of the request that created the subscription
+    subscription.packet->SetPacketType(PacketType::SubscriptionUpdate);
+    subscriptions.push_back(std::move(subscription));
+}
+
+void RPCServer::HandleUnsubscribe(Packet& packet, u32 subscription_id) {
+    std::erase_if(subscriptions, [subscription_id](const Subscription& subscription) {
+        return subscription.id == subscription_id;
+    });
+
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+void RPCServer::SendSubscriptionUpdate(Subscription& subscription) {
+    std::array<u8, MAX_SUBSCRIPTION_SIZE> contents;
+    if (!ReadRanges(subscription.ranges, contents.data())) {
+        return;
+    }
+    const std::span<const u8> current{contents.data(), subscription.last_sent.size()};
+
+    Packet& packet = *subscription.packet;
+    u8* out_data = packet.GetPacketData().data();
+    u8* update_data = out_data + sizeof(SubscriptionUpdateHeader);
+
+    SubscriptionUpdateHeader header{
+        .subscription_id = subscription.id,
+        .sequence = subscription.sequence,
+        .encoding = static_cast<u32>(SubscriptionEncoding::Full),
+    };
+    u32 update_size = static_cast<u32>(current.size());
+
+    std::optional<u32> delta_size;
+    if (subscription.updates_until_keyframe > 0) {
+        delta_size = EncodeDelta(subscription.last_sent, current, update_data);
+    }
+    if (delta_size) {
+        if (*delta_size == 0) {
+            // Nothing changed since the last update
+            return;
+        }
+        header.encoding = static_cast<u32>(SubscriptionEncoding::Delta);
+        update_size = *delta_size;
+        subscription.updates_until_keyframe--;
+    } else {
+        std::memcpy(update_data, current.data(), current.size());
+        subscription.updates_until_keyframe = SUBSCRIPTION_KEYFRAME_INTERVAL;
+    }
+
+    std::memcpy(out_data, &header, sizeof(header));
+    std::memcpy(subscription.last_sent.data(), current.data(), current.size());
+    subscription.sequence++;
+
+    packet.SetPacketDataSize(sizeof(header) + update_size);
+    packet.SendReply();
+}
+
+void RPCServer::HandleFrameRequest(std::unique_ptr<Packet> request_packet) {
+    bool success = false;
+    const auto packet_data = request_packet->GetPacketData();
+
+    u32 arg1 = 0;
+    u32 arg2 = 0;
+    std::memcpy(&arg1, packet_data.data(), sizeof(arg1));
+    std::memcpy(&arg2, packet_data.data() + sizeof(arg1), sizeof(arg2));
+
+    switch (request_packet->GetPacketType()) {
+    case PacketType::ReadMemoryBatch:
+        if (const auto ranges = ParseRanges(*request_packet, arg1, MAX_READ_SIZE)) {
+            HandleReadMemoryBatch(*request_packet, *ranges);
+            success = true;
+        }
+        break;
+    case PacketType::Subscribe:
+        if (arg1 > 0 && subscriptions.size() < MAX_SUBSCRIPTIONS) {
+            if (const auto ranges = ParseRanges(*request_packet, arg2, MAX_SUBSCRIPTION_SIZE)) {
+                HandleSubscribe(std::move(request_packet), arg1, *ranges);
+                return;
+            }
+        }
+        break;
+    case PacketType::Unsubscribe:
+        HandleUnsubscribe(*request_packet, arg1);
+        success = true;
+        break;
+    default:
+        break;
+    }
+
+    if (!success) {
+        // Send an empty reply, so as not to hang the client
+        request_packet->SetPacketDataSize(0);
+        request_packet->SendReply();
+    }
+}
+
+void RPCServer::FrameCallback([[maybe_unused]] std::uintptr_t user_data, s64 cycles_late) {
+    // The guest is not running while timing events are processed, so everything read here is
+    // consistent with a single point in emulated time.
+    std::unique_ptr<Packet> request_packet;
+    while (frame_request_queue.Pop(request_packet)) {
+        HandleFrameRequest(std::move(request_packet));
+    }
+
+    for (auto& subscription : subscriptions) {
+        if (subscription.frames_until_update == 0) {
+            SendSubscriptionUpdate(subscription);
+            subscription.frames_until_update = subscription.interval_frames;
+        }
+        subscription.frames_until_update--;
+    }
+
+    system.CoreTiming().ScheduleEvent(VideoCore::FRAME_TICKS - cycles_late, frame_event);
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
@@ -122,6 +386,9 @@ bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
         case PacketType::WriteMemory:
         case PacketType::ProcessList:
         case PacketType::SetGetProcess:
+        case PacketType::ReadMemoryBatch:
+        case PacketType::Subscribe:
+        case PacketType::Unsubscribe:
             if (packet_header.packet_size >= (sizeof(u32) * 2)) {
                 return true;
             }
@@ -166,6 +433,12 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
             HandleSetGetProcess(*request_packet, arg1, arg2);
             success = true;
             break;
+        case PacketType::ReadMemoryBatch:
+        case PacketType::Subscribe:
+        case PacketType::Unsubscribe:
+            // Served by the emulation thread at the next frame boundary
+            frame_request_queue.Push(std::move(request_packet));
+            return;
         default:
             break;
         }
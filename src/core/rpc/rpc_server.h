@@ -4,20 +4,29 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <span>
+#include <vector>
+#include "common/common_types.h"
 #include "common/polyfill_thread.h"
 #include "common/threadsafe_queue.h"
 
 namespace Core {
 class System;
+struct TimingEventType;
+} // namespace Core
+
+namespace Kernel {
+class Process;
 }
 
 namespace Core::RPC {
 
 class Packet;
 struct PacketHeader;
+struct MemoryRange;
 
 class RPCServer {
 public:
@@ -26,11 +35,34 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /// Schedules the per-frame event that serves batched reads and subscriptions. Needs to be
+    /// called again after loading a save state.
+    void ScheduleFrameEvent();
+
 private:
+    struct Subscription {
+        std::unique_ptr<Packet> packet;
+        std::vector<MemoryRange> ranges;
+        std::vector<u8> last_sent;
+        u32 id;
+        u32 interval_frames;
+        u32 frames_until_update;
+        u32 updates_until_keyframe = 0;
+        u32 sequence = 0;
+    };
+
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, std::span<const u8> data);
     void HandleProcessList(Packet& packet, u32 start_index, u32 max_amount);
     void HandleSetGetProcess(Packet& packet, u32 operation, u32 process_id);
+    void HandleReadMemoryBatch(Packet& packet, std::span<const MemoryRange> ranges);
+    void HandleSubscribe(std::unique_ptr<Packet> packet, u32 interval_frames,
+                         std::span<const MemoryRange> ranges);
+    void HandleUnsubscribe(Packet& packet, u32 subscription_id);
+    void HandleFrameRequest(std::unique_ptr<Packet> request);
+    void SendSubscriptionUpdate(Subscription& subscription);
+    bool ReadRanges(std::span<const MemoryRange> ranges, u8* out);
+    void FrameCallback(std::uintptr_t user_data, s64 cycles_late);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop(std::stop_token stop_token);
@@ -39,7 +71,13 @@ private:
     Core::System& system;
     Common::SPSCQueue<std::unique_ptr<Packet>, true> request_queue;
     std::jthread request_handler_thread;
-    u32 selected_pid = 0xFFFFFFFF;
+    std::atomic<u32> selected_pid = 0xFFFFFFFF;
+
+    // Requests that must be served at a frame boundary, handled on the emulation thread.
+    Common::SPSCQueue<std::unique_ptr<Packet>> frame_request_queue;
+    std::vector<Subscription> subscriptions;
+    u32 next_subscription_id = 0;
+    Core::TimingEventType* frame_event;
 };
 
 } // namespace Core::RPC
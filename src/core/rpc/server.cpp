@@ -27,6 +27,10 @@ Server::~Server() {
     NewRequestCallback(nullptr); // Notify the RPC server to end
 }
 
+void Server::OnStateLoaded() {
+    rpc_server.ScheduleFrameEvent();
+}
+
 void Server::NewRequestCallback(std::unique_ptr<RPC::Packet> new_request) {
     if (new_request) {
         LOG_INFO(RPC_Server, "Received request version={} id={} type={} size={}",
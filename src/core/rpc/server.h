@@ -23,6 +23,9 @@ public:
 
     void NewRequestCallback(std::unique_ptr<Packet> new_request);
 
+    /// Reschedules the per-frame event of the RPC server after a save state has been loaded.
+    void OnStateLoaded();
+
 private:
     RPCServer rpc_server;
     std::unique_ptr<UDPServer> udp_server;
@@ -447,28 +447,55 @@ std::optional<std::pair<void*, size_t>> Client::Response::GetResponseBuffer(u32
 }
 
 std::optional<Client::Response> Client::Send(Request& request) {
+    return FinishRequest(BeginRequest(request));
+}
+
+void Client::SendMultiple(std::span<Request> requests, const ResponseCallback& on_response) {
+    std::vector<std::unique_ptr<PendingResponse>> pending(requests.size());
+
+    const size_t window = GetMaxInFlightRequests();
+    size_t next_to_send = 0;
+    for (size_t i = 0; i < requests.size(); i++) {
+        // Keep the pipeline full before blocking on the oldest outstanding request.
+        while (next_to_send < requests.size() && next_to_send < i + window) {
+            pending[next_to_send] = BeginRequest(requests[next_to_send]);
+            next_to_send++;
+        }
+        auto response = FinishRequest(std::move(pending[i]));
+        on_response(i, response);
+    }
+}
+
+std::unique_ptr<Client::PendingResponse> Client::BeginRequest(Request& request) {
     if (stopped)
-        return std::nullopt;
+        return nullptr;
 
     request.request_packet.parameterCount = static_cast<u32>(request.parameters.size());
-    PendingResponse resp(request);
+    std::unique_ptr<PendingResponse> resp(new PendingResponse(request));
 
     {
         std::scoped_lock l(recv_map_mutex);
-        pending_responses[request.request_packet.requestID] = &resp;
+        pending_responses[request.request_packet.requestID] = resp.get();
     }
 
     auto respPacket = SendRequestPacket(request.request_packet, false, request.parameters);
     if (stopped || !respPacket.has_value()) {
         std::scoped_lock l(recv_map_mutex);
         pending_responses.erase(request.request_packet.requestID);
-        return std::nullopt;
+        return nullptr;
     }
 
-    std::unique_lock cv_lk(resp.cv_mutex);
-    resp.cv.wait(cv_lk, [&resp]() { return resp.is_done; });
+    return resp;
+}
+
+std::optional<Client::Response> Client::FinishRequest(std::unique_ptr<PendingResponse> pending) {
+    if (!pending)
+        return std::nullopt;
+
+    std::unique_lock cv_lk(pending->cv_mutex);
+    pending->cv.wait(cv_lk, [&pending]() { return pending->is_done; });
 
-    return std::optional<Client::Response>(std::move(resp.response));
+    return std::optional<Client::Response>(std::move(pending->response));
 }
 
 void Client::LogOnServer(ArticBaseCommon::LogOnServerType log_type, const std::string& message) {
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include "algorithm"
 #include "condition_variable"
 #include "cstring"
 #include "functional"
@@ -10,6 +11,7 @@
 #include "memory"
 #include "mutex"
 #include "optional"
+#include "span"
 #include "string"
 #include "thread"
 #include "utility"
@@ -165,6 +167,21 @@ public:
         ping_enabled = enable;
     }
 
+    /**
+     * Sets how many requests SendMultiple keeps in flight at once. A value of 0 uses one request
+     * per server worker connection.
+     */
+    void SetMaxInFlightRequests(size_t count) {
+        max_in_flight_requests = count;
+    }
+
+    size_t GetMaxInFlightRequests() const {
+        if (max_in_flight_requests != 0) {
+            return max_in_flight_requests;
+        }
+        return std::max<size_t>(handlers.size(), 1);
+    }
+
     void LogOnServer(ArticBaseCommon::LogOnServerType log_type, const std::string& message);
 
 private:
@@ -343,6 +360,15 @@ public:
 
     std::optional<Response> Send(Request& request);
 
+    using ResponseCallback = std::function<void(size_t index, std::optional<Response>& response)>;
+
+    /**
+     * Sends several requests without waiting for each response before issuing the next one.
+     * Up to GetMaxInFlightRequests() requests are outstanding at any time. on_response is called
+     * once per request, in request order, as soon as its response is available.
+     */
+    void SendMultiple(std::span<Request> requests, const ResponseCallback& on_response);
+
 private:
     class PendingResponse {
     public:
@@ -360,9 +386,16 @@ private:
         Response response{};
     };
 
+    /// Writes the request to the server and registers it as pending. Returns nullptr on failure.
+    std::unique_ptr<PendingResponse> BeginRequest(Request& request);
+    /// Waits until the response for a request started with BeginRequest arrives.
+    std::optional<Response> FinishRequest(std::unique_ptr<PendingResponse> pending);
+
     std::mutex recv_map_mutex;
     std::map<u32, PendingResponse*> pending_responses;
 
+    size_t max_in_flight_requests = 0;
+
     std::vector<Handler*> handlers;
     std::atomic<size_t> running_handlers;
     void OnAllHandlersFinished();
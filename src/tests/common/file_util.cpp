@@ -3,7 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <filesystem>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -24,3 +27,36 @@ TEST_CASE("SplitFilename83 Sanity", "[common]") {
     REQUIRE(std::memcmp(short_name.data(), expected_short_name.data(), short_name.size()) == 0);
     REQUIRE(std::memcmp(extension.data(), expected_extension.data(), extension.size()) == 0);
 }
+
+TEST_CASE("IOFile positional reads and writes", "[common]") {
+    const auto path =
+        (std::filesystem::temp_directory_path() / "citra_test_positional_io.bin").string();
+    constexpr std::size_t block_size = 0x1000;
+    constexpr std::size_t block_count = 8;
+    {
+        FileUtil::IOFile file(path, "w+b");
+        REQUIRE(file.IsOpen());
+        REQUIRE(file.Resize(block_size * block_count));
+
+        // Writers to different blocks don't share the file pointer, so they can run at once
+        std::vector<std::thread> writers;
+        for (std::size_t i = 0; i < block_count; i++) {
+            writers.emplace_back([&file, i] {
+                const std::vector<u8> block(block_size, static_cast<u8>(i + 1));
+                file.WriteAtBytes(block.data(), block.size(), i * block_size);
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        REQUIRE(file.IsGood());
+        REQUIRE(file.Tell() == 0);
+
+        std::vector<u8> block(block_size);
+        for (std::size_t i = block_count; i-- > 0;) {
+            REQUIRE(file.ReadAtBytes(block.data(), block.size(), i * block_size) == block_size);
+            REQUIRE(block == std::vector<u8>(block_size, static_cast<u8>(i + 1)));
+        }
+    }
+    FileUtil::Delete(path);
+}
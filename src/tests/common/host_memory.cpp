@@ -0,0 +1,49 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include "common/host_memory.h"
+
+namespace Common {
+
+constexpr std::size_t TEST_PAGE_SIZE = 0x1000;
+
+TEST_CASE("HostMemory mirrors backing pages", "[common]") {
+    HostMemory backing(4 * TEST_PAGE_SIZE);
+    VirtualArena arena(backing, 16 * TEST_PAGE_SIZE);
+    if (!arena.IsValid() || !VirtualArena::SupportsPageSize(TEST_PAGE_SIZE)) {
+        SKIP("Host memory mirroring is not supported on this host");
+    }
+
+    u8* const base = backing.BackingBasePointer();
+    u8* const mirror = arena.VirtualBasePointer();
+
+    // Map backing pages 1-2 at arena pages 8-9
+    REQUIRE(arena.Map(8 * TEST_PAGE_SIZE, TEST_PAGE_SIZE, 2 * TEST_PAGE_SIZE));
+
+    SECTION("writes to the backing are visible in the arena") {
+        base[TEST_PAGE_SIZE + 5] = 0xAB;
+        REQUIRE(mirror[8 * TEST_PAGE_SIZE + 5] == 0xAB);
+    }
+
+    SECTION("writes to the arena are visible in the backing") {
+        mirror[9 * TEST_PAGE_SIZE + 7] = 0xCD;
+        REQUIRE(base[2 * TEST_PAGE_SIZE + 7] == 0xCD);
+    }
+
+    SECTION("remapping a page keeps the backing data") {
+        base[2 * TEST_PAGE_SIZE] = 0xEF;
+        REQUIRE(arena.Unmap(8 * TEST_PAGE_SIZE, 2 * TEST_PAGE_SIZE));
+        REQUIRE(arena.Map(3 * TEST_PAGE_SIZE, 2 * TEST_PAGE_SIZE, TEST_PAGE_SIZE));
+        REQUIRE(mirror[3 * TEST_PAGE_SIZE] == 0xEF);
+    }
+
+    SECTION("a disabled arena rejects mappings") {
+        REQUIRE(arena.Disable());
+        REQUIRE(arena.IsDisabled());
+        REQUIRE_FALSE(arena.Map(0, 0, TEST_PAGE_SIZE));
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,102 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include "core/cheats/gateway_cheat.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+namespace Cheats {
+
+namespace {
+
+/// Writes num_writes values to VRAM followed by a conditional write.
+GatewayCheat MakeCheat(std::size_t num_writes) {
+    // Addresses only have 28 bits, so VRAM is reached through the offset register
+    std::string code = fmt::format("D3000000 {:08X}\n", static_cast<u32>(Memory::VRAM_VADDR));
+    for (u32 i = 0; i < num_writes; i++) {
+        code += fmt::format("{:08X} {:08X}\n", i * 4, i + 1);
+    }
+    // Write 0xDEADBEEF after the values only if the first one was written
+    code += "50000000 00000001\n";
+    code += fmt::format("{:08X} DEADBEEF\n", num_writes * 4);
+    code += "D0000000 00000000\n";
+    return GatewayCheat("test", code, "");
+}
+
+} // Anonymous namespace
+
+TEST_CASE("GatewayCheat", "[core][cheats]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+
+    SECTION("writes and conditionals are applied") {
+        const auto cheat = MakeCheat(16);
+        cheat.Execute(system, memory, *process);
+        for (u32 i = 0; i < 16; i++) {
+            CHECK(memory.Read32(*process, Memory::VRAM_VADDR + i * 4) == i + 1);
+        }
+        CHECK(memory.Read32(*process, Memory::VRAM_VADDR + 16 * 4) == 0xDEADBEEF);
+    }
+
+    SECTION("patches write the following lines and skip over them") {
+        std::string code = fmt::format("D3000000 {:08X}\n", static_cast<u32>(Memory::VRAM_VADDR));
+        code += "E0000010 0000000A\n";
+        code += "11223344 55667788\n";
+        code += "99AABBCC DDEEFF00\n";
+        code += "00000020 12345678\n";
+        GatewayCheat("patch", code, "").Execute(system, memory, *process);
+        CHECK(memory.Read32(*process, Memory::VRAM_VADDR + 0x10) == 0x11223344);
+        CHECK(memory.Read32(*process, Memory::VRAM_VADDR + 0x14) == 0x55667788);
+        CHECK(memory.Read16(*process, Memory::VRAM_VADDR + 0x18) == 0xBBCC);
+        CHECK(memory.Read16(*process, Memory::VRAM_VADDR + 0x1A) == 0);
+        CHECK(memory.Read32(*process, Memory::VRAM_VADDR + 0x20) == 0x12345678);
+    }
+
+    SECTION("masked 16-bit conditionals") {
+        memory.Write16(*process, Memory::VRAM_VADDR, 0x12F0);
+        std::string code = fmt::format("D3000000 {:08X}\n", static_cast<u32>(Memory::VRAM_VADDR));
+        // (not 0xFF0F) & 0x12F0 == 0x00F0
+        code += "90000000 FF0F00F0\n";
+        code += "00000010 00000001\n";
+        code += "D0000000 00000000\n";
+        code += "90000000 FF0F00F1\n";
+        code += "00000014 00000001\n";
+        code += "D0000000 00000000\n";
+        GatewayCheat("compare", code, "").Execute(system, memory, *process);
+        CHECK(memory.Read32(*process, Memory::VRAM_VADDR + 0x10) == 1);
+        CHECK(memory.Read32(*process, Memory::VRAM_VADDR + 0x14) == 0);
+    }
+}
+
+TEST_CASE("GatewayCheat benchmark", "[core][cheats][!benchmark]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+
+    const auto large_cheat = MakeCheat(512);
+    BENCHMARK("execute 512 cheat lines") {
+        large_cheat.Execute(system, memory, *process);
+    };
+}
+
+} // namespace Cheats
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -10,8 +11,10 @@
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/ipc.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/thread.h"
 
 namespace Kernel {
 
@@ -402,4 +405,71 @@ TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
     }
 }
 
+TEST_CASE("TranslateCommandBuffer", "[core][kernel][!benchmark]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+
+    // Each process gets a thread whose TLS lives in the first page of its mapping, and a static
+    // buffer in the second page.
+    constexpr VAddr tls_address = 0x10000000;
+    constexpr VAddr buffer_address = tls_address + Memory::CITRA_PAGE_SIZE;
+    const auto make_thread = [&](std::shared_ptr<Process> process) {
+        auto mem = std::make_shared<BufferMem>(2 * Memory::CITRA_PAGE_SIZE);
+        MemoryRef backing{mem};
+        std::fill(backing.GetPtr(), backing.GetPtr() + backing.GetSize(), 0);
+        REQUIRE(process->vm_manager
+                    .MapBackingMemory(tls_address, backing, static_cast<u32>(backing.GetSize()),
+                                      MemoryState::Private)
+                    .Code() == ResultSuccess);
+
+        auto thread = std::make_shared<Thread>(kernel, 0);
+        thread->owner_process = process;
+        thread->tls_address = tls_address;
+        return thread;
+    };
+
+    auto client_process = kernel.CreateProcess(kernel.CreateCodeSet("client", 0));
+    auto server_process = kernel.CreateProcess(kernel.CreateCodeSet("server", 0));
+    auto client_thread = make_thread(client_process);
+    auto server_thread = make_thread(server_process);
+
+    const std::vector<u8> input_buffer(0x100, 0xAB);
+    memory.WriteBlock(*client_process, buffer_address, input_buffer.data(), input_buffer.size());
+
+    const u32_le request[]{
+        IPC::MakeHeader(0x1234, 2, 2),
+        0x12345678,
+        0x21122112,
+        IPC::StaticBufferDesc(0x100, 0),
+        buffer_address,
+    };
+    memory.WriteBlock(*client_process, client_thread->GetCommandBufferAddress(), request,
+                      sizeof(request));
+
+    // The receiving thread sets up its static buffer right after the command buffer
+    const u32_le static_buffer[]{IPC::StaticBufferDesc(0x100, 0), buffer_address};
+    memory.WriteBlock(*server_process,
+                      server_thread->GetCommandBufferAddress() +
+                          IPC::COMMAND_BUFFER_LENGTH * sizeof(u32),
+                      static_buffer, sizeof(static_buffer));
+
+    std::vector<MappedBufferContext> mapped_buffer_context;
+    BENCHMARK("translate request with static buffer") {
+        return TranslateCommandBuffer(kernel, memory, client_thread, server_thread,
+                                      client_thread->GetCommandBufferAddress(),
+                                      server_thread->GetCommandBufferAddress(),
+                                      mapped_buffer_context, false);
+    };
+
+    std::vector<u8> output_buffer(input_buffer.size());
+    memory.ReadBlock(*server_process, buffer_address, output_buffer.data(), output_buffer.size());
+    CHECK(output_buffer == input_buffer);
+    const VAddr translated_command = server_thread->GetCommandBufferAddress();
+    CHECK(memory.Read32(*server_process, translated_command + 4 * sizeof(u32)) == buffer_address);
+}
+
 } // namespace Kernel
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -55,3 +57,183 @@ TEST_CASE("memory.IsValidVirtualAddress", "[core][memory]") {
         CHECK(memory.IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("memory.RasterizerMarkRegionCached", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+    auto& page_table = *process->vm_manager.page_table;
+
+    // A 400x240 RGBA8 framebuffer, not page aligned, with mapped VRAM pages around it
+    constexpr u32 fb_offset = Memory::CITRA_PAGE_SIZE + 0x100;
+    constexpr u32 fb_size = 400 * 240 * 4;
+    constexpr PAddr fb_paddr = Memory::VRAM_PADDR + fb_offset;
+    const u32 first_page = (Memory::VRAM_VADDR + fb_offset) >> Memory::CITRA_PAGE_BITS;
+    const u32 last_page = (Memory::VRAM_VADDR + fb_offset + fb_size - 1) >> Memory::CITRA_PAGE_BITS;
+
+    SECTION("pages covering the region change type") {
+        memory.RasterizerMarkRegionCached(fb_paddr, fb_size, true);
+        CHECK(page_table.attributes[first_page - 1] == Memory::PageType::Memory);
+        CHECK(page_table.attributes[first_page] == Memory::PageType::RasterizerCachedMemory);
+        CHECK(page_table.attributes[last_page] == Memory::PageType::RasterizerCachedMemory);
+        CHECK(page_table.attributes[last_page + 1] == Memory::PageType::Memory);
+        CHECK(page_table.pointers[last_page] == nullptr);
+
+        memory.RasterizerMarkRegionCached(fb_paddr, fb_size, false);
+        CHECK(page_table.attributes[first_page] == Memory::PageType::Memory);
+        CHECK(page_table.attributes[last_page] == Memory::PageType::Memory);
+        CHECK(page_table.pointers[last_page] ==
+              memory.GetPhysicalPointer(Memory::VRAM_PADDR +
+                                        (last_page << Memory::CITRA_PAGE_BITS) -
+                                        Memory::VRAM_VADDR));
+    }
+}
+
+TEST_CASE("memory.RasterizerMarkRegionCached benchmark", "[core][memory][!benchmark]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+
+    constexpr PAddr fb_paddr = Memory::VRAM_PADDR + 0x100;
+    constexpr u32 fb_size = 400 * 240 * 4;
+    BENCHMARK("mark a framebuffer cached and uncached") {
+        memory.RasterizerMarkRegionCached(fb_paddr, fb_size, true);
+        memory.RasterizerMarkRegionCached(fb_paddr, fb_size, false);
+    };
+}
+
+TEST_CASE("memory.BlockOperations", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+
+    constexpr std::size_t block_size = 3 * Memory::CITRA_PAGE_SIZE + 0x123;
+    constexpr VAddr src_addr = Memory::VRAM_VADDR + 0x80;
+    constexpr VAddr dest_addr = Memory::VRAM_VADDR + 0x10000 + 0x40;
+    std::vector<u8> data(block_size);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>(i * 7);
+    }
+
+    SECTION("blocks crossing pages round trip") {
+        memory.WriteBlock(*process, src_addr, data.data(), data.size());
+        std::vector<u8> result(block_size);
+        memory.ReadBlock(*process, src_addr, result.data(), result.size());
+        CHECK(result == data);
+    }
+
+    SECTION("copied blocks match the source") {
+        memory.WriteBlock(*process, src_addr, data.data(), data.size());
+        memory.CopyBlock(*process, dest_addr, src_addr, block_size);
+        std::vector<u8> result(block_size);
+        memory.ReadBlock(*process, dest_addr, result.data(), result.size());
+        CHECK(result == data);
+    }
+}
+
+TEST_CASE("memory.ForEachPageRun", "[core][memory]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+    auto& page_table = *process->vm_manager.page_table;
+
+    // VRAM pages 2-4 are rasterizer cached, the pages around them are regular memory
+    constexpr u32 page_size = Memory::CITRA_PAGE_SIZE;
+    memory.RasterizerMarkRegionCached(Memory::VRAM_PADDR + 2 * page_size, 3 * page_size, true);
+
+    struct Run {
+        Memory::PageType type;
+        VAddr vaddr;
+        u8* ptr;
+        std::size_t size;
+    };
+    // Cached VRAM pages are accessed through their physical address by the rasterizer
+    const auto get_rasterizer_ptr = [&](VAddr page_vaddr) {
+        return memory.GetPhysicalPointer(Memory::VRAM_PADDR + (page_vaddr - Memory::VRAM_VADDR));
+    };
+    const auto get_runs = [&](VAddr vaddr, std::size_t size) {
+        std::vector<Run> runs;
+        Memory::ForEachPageRun(
+            page_table, vaddr, size, get_rasterizer_ptr,
+            [&](Memory::PageType type, VAddr run_vaddr, u8* ptr, std::size_t run_size) {
+                runs.push_back({type, run_vaddr, ptr, run_size});
+            });
+        return runs;
+    };
+
+    SECTION("cached pages are coalesced into a single run") {
+        const auto runs = get_runs(Memory::VRAM_VADDR + 2 * page_size, 3 * page_size);
+        REQUIRE(runs.size() == 1);
+        CHECK(runs[0].type == Memory::PageType::RasterizerCachedMemory);
+        CHECK(runs[0].vaddr == Memory::VRAM_VADDR + 2 * page_size);
+        CHECK(runs[0].size == 3 * page_size);
+        CHECK(runs[0].ptr == memory.GetPhysicalPointer(Memory::VRAM_PADDR + 2 * page_size));
+    }
+
+    SECTION("runs start and end in the middle of pages") {
+        const auto runs = get_runs(Memory::VRAM_VADDR + page_size + 0x800, 4 * page_size);
+        REQUIRE(runs.size() == 3);
+        CHECK(runs[0].type == Memory::PageType::Memory);
+        CHECK(runs[0].vaddr == Memory::VRAM_VADDR + page_size + 0x800);
+        CHECK(runs[0].size == 0x800);
+        CHECK(runs[0].ptr == memory.GetPhysicalPointer(Memory::VRAM_PADDR + page_size + 0x800));
+        CHECK(runs[1].type == Memory::PageType::RasterizerCachedMemory);
+        CHECK(runs[1].vaddr == Memory::VRAM_VADDR + 2 * page_size);
+        CHECK(runs[1].size == 3 * page_size);
+        CHECK(runs[2].type == Memory::PageType::Memory);
+        CHECK(runs[2].vaddr == Memory::VRAM_VADDR + 5 * page_size);
+        CHECK(runs[2].size == 0x800);
+    }
+
+    SECTION("a range inside a cached page is a single partial run") {
+        const auto runs = get_runs(Memory::VRAM_VADDR + 3 * page_size + 0x10, 0x20);
+        REQUIRE(runs.size() == 1);
+        CHECK(runs[0].type == Memory::PageType::RasterizerCachedMemory);
+        CHECK(runs[0].vaddr == Memory::VRAM_VADDR + 3 * page_size + 0x10);
+        CHECK(runs[0].size == 0x20);
+        CHECK(runs[0].ptr == memory.GetPhysicalPointer(Memory::VRAM_PADDR + 3 * page_size + 0x10));
+    }
+
+    memory.RasterizerMarkRegionCached(Memory::VRAM_PADDR + 2 * page_size, 3 * page_size, false);
+}
+
+TEST_CASE("memory.BlockOperations benchmark", "[core][memory][!benchmark]") {
+    Core::Timing timing(1, 100);
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel(
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    kernel.HandleSpecialMapping(process->vm_manager,
+                                {Memory::VRAM_VADDR, Memory::VRAM_SIZE, false, false});
+
+    std::vector<u8> large_block(1024 * 1024);
+    BENCHMARK("read 1 MiB") {
+        memory.ReadBlock(*process, Memory::VRAM_VADDR, large_block.data(), large_block.size());
+    };
+}
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -152,3 +153,85 @@ TEST_CASE("Memory Basics", "[kernel][memory]") {
         REQUIRE(code == ResultSuccess);
     }
 }
+
+namespace {
+
+constexpr u32 num_blocks = 64;
+constexpr u32 range_size = num_blocks * Memory::CITRA_PAGE_SIZE;
+
+/// Manager with num_blocks pages that can be mapped at HEAP_VADDR as separate areas.
+struct MemoryRangesFixture {
+    Core::Timing timing{1, 100};
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Kernel::KernelSystem kernel{
+        memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+        Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy}};
+    Kernel::Process process{kernel};
+    // Because of the PageTable, Kernel::VMManager is too big to be created on the stack.
+    std::unique_ptr<Kernel::VMManager> manager =
+        std::make_unique<Kernel::VMManager>(memory, process);
+    std::vector<MemoryRef> blocks;
+
+    MemoryRangesFixture() {
+        // Separate allocations, so that adjacent mappings can never be merged together.
+        for (u32 i = 0; i < num_blocks; ++i) {
+            blocks.emplace_back(std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE));
+        }
+    }
+
+    void MapBlocks() {
+        for (u32 i = 0; i < num_blocks; ++i) {
+            auto result =
+                manager->MapBackingMemory(Memory::HEAP_VADDR + i * Memory::CITRA_PAGE_SIZE,
+                                          blocks[i], Memory::CITRA_PAGE_SIZE,
+                                          Kernel::MemoryState::Private);
+            REQUIRE(result.Code() == ResultSuccess);
+        }
+    }
+};
+
+} // Anonymous namespace
+
+TEST_CASE("Memory ranges", "[kernel][memory]") {
+    auto fixture = std::make_unique<MemoryRangesFixture>();
+    auto& manager = fixture->manager;
+
+    SECTION("unmapping a range spanning multiple areas") {
+        fixture->MapBlocks();
+
+        auto vma = manager->FindVMA(Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE);
+        CHECK(vma->second.base == Memory::HEAP_VADDR + Memory::CITRA_PAGE_SIZE);
+        CHECK(vma->second.backing_memory.GetPtr() == fixture->blocks[1].GetPtr());
+
+        Result code = manager->UnmapRange(Memory::HEAP_VADDR, range_size);
+        REQUIRE(code == ResultSuccess);
+
+        vma = manager->FindVMA(Memory::HEAP_VADDR + range_size / 2);
+        CHECK(vma->second.type == Kernel::VMAType::Free);
+        CHECK(vma->second.base <= Memory::HEAP_VADDR);
+        CHECK(vma->second.base + vma->second.size >= Memory::HEAP_VADDR + range_size);
+        CHECK(manager->vma_map.size() == 1);
+    }
+}
+
+TEST_CASE("Memory ranges benchmark", "[kernel][memory][!benchmark]") {
+    auto fixture = std::make_unique<MemoryRangesFixture>();
+    auto& manager = fixture->manager;
+
+    BENCHMARK("map and unmap small areas") {
+        fixture->MapBlocks();
+        return manager->UnmapRange(Memory::HEAP_VADDR, range_size);
+    };
+
+    fixture->MapBlocks();
+    BENCHMARK("address lookup") {
+        u32 num_mapped = 0;
+        for (u32 offset = 0; offset < range_size; offset += 0x100) {
+            const auto vma = manager->FindVMA(Memory::HEAP_VADDR + offset);
+            num_mapped += vma->second.type == Kernel::VMAType::BackingMemory;
+        }
+        return num_mapped;
+    };
+    REQUIRE(manager->UnmapRange(Memory::HEAP_VADDR, range_size) == ResultSuccess);
+}
@@ -7,7 +7,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <memory>
+#include <random>
 #include <span>
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_template_test_macros.hpp>
@@ -15,6 +17,7 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <fmt/format.h>
 #include <nihstro/inline_assembly.h>
+#include "video_core/pica/regs_shader.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/pica/shader_unit.h"
 #include "video_core/shader/shader_interpreter.h"
@@ -133,6 +136,7 @@ public:
             shader_unit.input[i].w = Pica::f24::FromFloat32(input.w);
         }
         shader_unit.temporary.fill(Common::Vec4<Pica::f24>::AssignToAll(Pica::f24::Zero()));
+        shader_interpreter.SetupBatch(*shader_setup, 0);
         shader_interpreter.Run(*shader_setup, shader_unit);
     }
 
@@ -800,4 +804,143 @@ SHADER_TEST_CASE("Source Swizzle", "[video_core][shader]") {
             Common::Vec4f(iota_vec.y, iota_vec.y, iota_vec.y, iota_vec.y));
 }
 
+/**
+ * Fills the setup with a random program of arithmetic, MAD and flow control instructions with
+ * random operands. Jumps, calls and conditionals only go forward and loops are bounded by the
+ * integer uniforms, so the program always ends.
+ */
+static void MakeRandomProgram(Pica::ShaderSetup& setup, std::mt19937& rng, u32 length) {
+    static constexpr std::array arithmetic_ops = {
+        OpCode::Id::ADD,  OpCode::Id::DP3,  OpCode::Id::DP4,  OpCode::Id::DPH,  OpCode::Id::DST,
+        OpCode::Id::EX2,  OpCode::Id::LG2,  OpCode::Id::MUL,  OpCode::Id::SGE,  OpCode::Id::SLT,
+        OpCode::Id::FLR,  OpCode::Id::MAX,  OpCode::Id::MIN,  OpCode::Id::RCP,  OpCode::Id::RSQ,
+        OpCode::Id::MOVA, OpCode::Id::MOV,  OpCode::Id::DPHI, OpCode::Id::SGEI, OpCode::Id::SLTI,
+        OpCode::Id::CMP,
+    };
+    static constexpr std::array flow_control_ops = {
+        OpCode::Id::BREAK, OpCode::Id::NOP,  OpCode::Id::END, OpCode::Id::BREAKC,
+        OpCode::Id::CALL,  OpCode::Id::CALLC, OpCode::Id::CALLU, OpCode::Id::IFU,
+        OpCode::Id::IFC,   OpCode::Id::LOOP, OpCode::Id::JMPC, OpCode::Id::JMPU,
+    };
+    const auto random = [&rng](u32 max) { return static_cast<u32>(rng() % max); };
+
+    std::generate(setup.swizzle_data.begin(), setup.swizzle_data.end(),
+                  [&rng] { return static_cast<u32>(rng()); });
+    nihstro::Instruction end = {};
+    end.opcode = nihstro::OpCode(OpCode::Id::END);
+    setup.program_code.fill(end.hex);
+
+    for (u32 offset = 0; offset < length; ++offset) {
+        nihstro::Instruction instr = {};
+        instr.hex = rng();
+        const u32 kind = random(10);
+        if (kind < 6) {
+            instr.opcode = nihstro::OpCode(arithmetic_ops[random(arithmetic_ops.size())]);
+            instr.common.operand_desc_id = random(16);
+        } else if (kind < 7) {
+            // MAD and MADI take the low bits of the opcode for their destination
+            instr.opcode = nihstro::OpCode(
+                static_cast<OpCode::Id>(static_cast<u32>(OpCode::Id::MADI) + random(16)));
+            instr.mad.operand_desc_id = random(16);
+        } else {
+            instr.opcode = nihstro::OpCode(flow_control_ops[random(flow_control_ops.size())]);
+            instr.flow_control.dest_offset = offset + 1 + random(length - offset + 1);
+            instr.flow_control.num_instructions = random(4);
+        }
+        setup.program_code[offset] = instr.hex;
+    }
+    setup.MarkProgramCodeDirty();
+    setup.MarkSwizzleDataDirty();
+}
+
+/// Rebuilds the register state at the end of a run from the per-instruction debug records.
+static void ReplayDebugData(const Pica::ShaderSetup& setup,
+                            const Pica::Shader::DebugData<true>& debug_data,
+                            Pica::ShaderUnit& state) {
+    using Record = Pica::Shader::DebugDataRecord;
+    for (const Record& record : debug_data.records) {
+        const nihstro::Instruction instr = {setup.program_code[record.instruction_offset]};
+        if (record.mask & Record::DEST_OUT) {
+            const DestRegister dest =
+                instr.opcode.Value().GetInfo().type == OpCode::Type::MultiplyAdd
+                    ? instr.mad.dest.Value()
+                    : instr.common.dest.Value();
+            auto& reg = dest < 0x10 ? state.output[dest.GetIndex()]
+                                    : state.temporary[dest.GetIndex()];
+            reg = record.dest_out;
+        }
+        if (record.mask & Record::ADDR_REG_OUT) {
+            state.address_registers[0] = record.address_registers[0];
+            state.address_registers[1] = record.address_registers[1];
+        }
+        if (record.mask & Record::CMP_RESULT) {
+            state.conditional_code[0] = record.conditional_code[0];
+            state.conditional_code[1] = record.conditional_code[1];
+        }
+    }
+}
+
+TEST_CASE("Interpreter Random Programs", "[video_core][shader]") {
+    // The per-step interpreter behind ProduceDebugInfo is the reference for the pre-decoded one.
+    std::mt19937 rng{1234};
+    const auto random_float = [&rng] {
+        static constexpr std::array specials = {0.0f, -0.0f, 1.0f, -1.0f,
+                                                INFINITY, -INFINITY, NAN, 0.5f};
+        if (rng() % 6 == 0) {
+            return Pica::f24::FromFloat32(specials[rng() % specials.size()]);
+        }
+        return Pica::f24::FromFloat32(static_cast<float>(static_cast<int>(rng() % 2000) - 1000) /
+                                      37.0f);
+    };
+    const auto random_vec4 = [&random_float] {
+        return Common::Vec4<Pica::f24>{random_float(), random_float(), random_float(),
+                                       random_float()};
+    };
+
+    Pica::ShaderRegs config{};
+    config.max_input_attribute_index.Assign(15);
+    config.input_attribute_to_register_map_low = 0x76543210;
+    config.input_attribute_to_register_map_high = 0xFEDCBA98;
+
+    for (u32 program = 0; program < 2000; ++program) {
+        CAPTURE(program);
+
+        ShaderInterpreter shader_interpreter;
+        auto shader_setup = std::make_unique<Pica::ShaderSetup>();
+        MakeRandomProgram(*shader_setup, rng, 2 + static_cast<u32>(rng() % 30));
+        for (auto& uniform : shader_setup->uniforms.f) {
+            uniform = random_vec4();
+        }
+        for (auto& uniform : shader_setup->uniforms.b) {
+            uniform = rng() % 2;
+        }
+        for (auto& uniform : shader_setup->uniforms.i) {
+            uniform = {static_cast<u8>(rng() % 4), static_cast<u8>(rng()),
+                       static_cast<u8>(rng()), 0};
+        }
+        Pica::AttributeBuffer input;
+        std::generate(input.begin(), input.end(), random_vec4);
+
+        shader_interpreter.SetupBatch(*shader_setup, static_cast<u32>(rng() % 3));
+        Pica::ShaderUnit decoded;
+        decoded.LoadInput(config, input);
+        shader_interpreter.Run(*shader_setup, decoded);
+
+        Pica::ShaderUnit reference;
+        reference.LoadInput(config, input);
+        ReplayDebugData(*shader_setup,
+                        shader_interpreter.ProduceDebugInfo(*shader_setup, input, config),
+                        reference);
+
+        REQUIRE(std::memcmp(decoded.output.data(), reference.output.data(),
+                            sizeof(decoded.output)) == 0);
+        REQUIRE(std::memcmp(decoded.temporary.data(), reference.temporary.data(),
+                            sizeof(decoded.temporary)) == 0);
+        REQUIRE(decoded.address_registers[0] == reference.address_registers[0]);
+        REQUIRE(decoded.address_registers[1] == reference.address_registers[1]);
+        REQUIRE(decoded.conditional_code[0] == reference.conditional_code[0]);
+        REQUIRE(decoded.conditional_code[1] == reference.conditional_code[1]);
+    }
+}
+
 #endif // CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
@@ -0,0 +1,253 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "common/color.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "video_core/pica/regs_external.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_software/sw_blitter.h"
+#include "video_core/utils.h"
+
+namespace {
+
+class NullRasterizer final : public VideoCore::RasterizerInterface {
+public:
+    void AddTriangle(const Pica::OutputVertex&, const Pica::OutputVertex&,
+                     const Pica::OutputVertex&) override {}
+    void DrawTriangles() override {}
+    void FlushAll() override {}
+    void FlushRegion(PAddr addr, u32 size) override {}
+    void InvalidateRegion(PAddr addr, u32 size) override {}
+    void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
+    void ClearAll(bool flush) override {}
+};
+
+constexpr PAddr SRC_ADDR = Memory::VRAM_PADDR;
+constexpr PAddr DST_ADDR = Memory::VRAM_PADDR + 0x200000;
+
+Common::Vec4<u8> Decode(Pica::PixelFormat format, const u8* pixel) {
+    switch (format) {
+    case Pica::PixelFormat::RGBA8:
+        return Common::Color::DecodeRGBA8(pixel);
+    case Pica::PixelFormat::RGB8:
+        return Common::Color::DecodeRGB8(pixel);
+    case Pica::PixelFormat::RGB565:
+        return Common::Color::DecodeRGB565(pixel);
+    case Pica::PixelFormat::RGB5A1:
+        return Common::Color::DecodeRGB5A1(pixel);
+    default:
+        return Common::Color::DecodeRGBA4(pixel);
+    }
+}
+
+void Encode(Pica::PixelFormat format, const Common::Vec4<u8>& color, u8* pixel) {
+    switch (format) {
+    case Pica::PixelFormat::RGBA8:
+        return Common::Color::EncodeRGBA8(color, pixel);
+    case Pica::PixelFormat::RGB8:
+        return Common::Color::EncodeRGB8(color, pixel);
+    case Pica::PixelFormat::RGB565:
+        return Common::Color::EncodeRGB565(color, pixel);
+    case Pica::PixelFormat::RGB5A1:
+        return Common::Color::EncodeRGB5A1(color, pixel);
+    default:
+        return Common::Color::EncodeRGBA4(color, pixel);
+    }
+}
+
+/// Pixel by pixel display transfer, following the layouts selected by the config.
+std::vector<u8> ReferenceTransfer(const Pica::DisplayTransferConfig& config, const u8* src) {
+    const u32 horizontal_scale = config.scaling != config.NoScale ? 1 : 0;
+    const u32 vertical_scale = config.scaling == config.ScaleXY ? 1 : 0;
+    const u32 width = config.output_width >> horizontal_scale;
+    const u32 height = config.output_height >> vertical_scale;
+    const u32 src_bpp = Pica::BytesPerPixel(config.input_format);
+    const u32 dst_bpp = Pica::BytesPerPixel(config.output_format);
+    const bool input_tiled = !config.input_linear;
+    const bool output_tiled = config.input_linear != config.dont_swizzle;
+
+    std::vector<u8> dst(width * height * dst_bpp);
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            const u32 input_x = x << horizontal_scale;
+            const u32 input_y = y << vertical_scale;
+            const u32 output_y = config.flip_vertically ? height - y - 1 : y;
+            const u32 src_offset =
+                input_tiled ? VideoCore::GetMortonOffset(input_x, input_y, src_bpp) +
+                                  (input_y & ~7) * config.input_width * src_bpp
+                            : (input_x + input_y * config.input_width) * src_bpp;
+            const u32 dst_offset = output_tiled
+                                       ? VideoCore::GetMortonOffset(x, output_y, dst_bpp) +
+                                             (output_y & ~7) * width * dst_bpp
+                                       : (x + output_y * width) * dst_bpp;
+            const u8* src_pixel = src + src_offset;
+
+            auto color = Decode(config.input_format, src_pixel).Cast<u32>();
+            const u32 group = 1 << (horizontal_scale + vertical_scale);
+            for (u32 i = 1; i < group; ++i) {
+                color += Decode(config.input_format, src_pixel + i * src_bpp).Cast<u32>();
+            }
+            Encode(config.output_format, (color / group).Cast<u8>(), dst.data() + dst_offset);
+        }
+    }
+    return dst;
+}
+
+Pica::DisplayTransferConfig MakeConfig(u32 width, u32 height, Pica::PixelFormat input_format,
+                                       Pica::PixelFormat output_format,
+                                       Pica::DisplayTransferConfig::ScalingMode scaling) {
+    Pica::DisplayTransferConfig config{};
+    config.input_address = SRC_ADDR >> 3;
+    config.output_address = DST_ADDR >> 3;
+    config.input_width.Assign(width);
+    config.input_height.Assign(height);
+    config.output_width.Assign(width);
+    config.output_height.Assign(height);
+    config.input_format.Assign(input_format);
+    config.output_format.Assign(output_format);
+    config.scaling.Assign(scaling);
+    return config;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("SwBlitter::DisplayTransfer", "[video_core][sw_blitter]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    NullRasterizer rasterizer;
+    SwRenderer::SwBlitter blitter{memory, &rasterizer};
+
+    std::mt19937 rng{0};
+    u8* src = memory.GetPhysicalPointer(SRC_ADDR);
+    for (u32 i = 0; i < 240 * 400 * 4; ++i) {
+        src[i] = static_cast<u8>(rng());
+    }
+
+    using Format = Pica::PixelFormat;
+    using Config = Pica::DisplayTransferConfig;
+    const auto check = [&](Config config) {
+        blitter.DisplayTransfer(config);
+        const auto expected = ReferenceTransfer(config, src);
+        REQUIRE(std::memcmp(memory.GetPhysicalPointer(DST_ADDR), expected.data(),
+                            expected.size()) == 0);
+    };
+
+    SECTION("RGBA8 to RGB8") {
+        check(MakeConfig(240, 400, Format::RGBA8, Format::RGB8, Config::NoScale));
+    }
+    SECTION("RGB565 to RGB565 flipped") {
+        auto config = MakeConfig(240, 400, Format::RGB565, Format::RGB565, Config::NoScale);
+        config.flip_vertically.Assign(1);
+        check(config);
+    }
+    SECTION("RGBA8 to RGB565 with X scaling") {
+        check(MakeConfig(240, 400, Format::RGBA8, Format::RGB565, Config::ScaleX));
+    }
+    SECTION("RGBA4 to RGBA8 with XY scaling") {
+        check(MakeConfig(240, 400, Format::RGBA4, Format::RGBA8, Config::ScaleXY));
+    }
+    SECTION("Linear RGBA8 to tiled RGB565") {
+        auto config = MakeConfig(240, 400, Format::RGBA8, Format::RGB565, Config::NoScale);
+        config.input_linear.Assign(1);
+        check(config);
+    }
+    SECTION("Linear RGB8 to tiled RGB8 flipped") {
+        auto config = MakeConfig(240, 400, Format::RGB8, Format::RGB8, Config::NoScale);
+        config.input_linear.Assign(1);
+        config.flip_vertically.Assign(1);
+        check(config);
+    }
+    SECTION("Tiled RGBA8 to tiled RGB5A1 cropped") {
+        auto config = MakeConfig(240, 400, Format::RGBA8, Format::RGB5A1, Config::NoScale);
+        config.output_width.Assign(200);
+        config.output_height.Assign(320);
+        config.crop_input_lines.Assign(1);
+        config.dont_swizzle.Assign(1);
+        check(config);
+    }
+    SECTION("Tiled RGB565 to tiled RGBA8 with XY scaling") {
+        auto config = MakeConfig(240, 400, Format::RGB565, Format::RGBA8, Config::ScaleXY);
+        config.dont_swizzle.Assign(1);
+        check(config);
+    }
+    SECTION("Tiled RGBA8 to tiled RGBA8 cropped with X scaling") {
+        auto config = MakeConfig(240, 400, Format::RGBA8, Format::RGBA8, Config::ScaleX);
+        config.output_width.Assign(224);
+        config.crop_input_lines.Assign(1);
+        config.dont_swizzle.Assign(1);
+        check(config);
+    }
+}
+
+TEST_CASE("SwBlitter::DisplayTransfer benchmark", "[video_core][sw_blitter][!benchmark]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    NullRasterizer rasterizer;
+    SwRenderer::SwBlitter blitter{memory, &rasterizer};
+
+    using Format = Pica::PixelFormat;
+    using Config = Pica::DisplayTransferConfig;
+    BENCHMARK("RGBA8 to RGB8 240x400") {
+        blitter.DisplayTransfer(MakeConfig(240, 400, Format::RGBA8, Format::RGB8, Config::NoScale));
+    };
+    BENCHMARK("RGB565 to RGB565 240x400") {
+        blitter.DisplayTransfer(
+            MakeConfig(240, 400, Format::RGB565, Format::RGB565, Config::NoScale));
+    };
+}
+
+TEST_CASE("SwBlitter::MemoryFill", "[video_core][sw_blitter]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    NullRasterizer rasterizer;
+    SwRenderer::SwBlitter blitter{memory, &rasterizer};
+
+    Pica::MemoryFillConfig config{};
+    config.address_start = DST_ADDR >> 3;
+    config.address_end = (DST_ADDR + 0x60) >> 3;
+    const u8* dst = memory.GetPhysicalPointer(DST_ADDR);
+
+    SECTION("24-bit") {
+        config.fill_24bit.Assign(1);
+        config.value_24bit_r.Assign(0x11);
+        config.value_24bit_g.Assign(0x22);
+        config.value_24bit_b.Assign(0x33);
+        blitter.MemoryFill(config);
+        for (u32 i = 0; i < 0x60; i += 3) {
+            REQUIRE((dst[i] == 0x11 && dst[i + 1] == 0x22 && dst[i + 2] == 0x33));
+        }
+    }
+    SECTION("32-bit") {
+        config.fill_32bit.Assign(1);
+        config.value_32bit = 0xAABBCCDD;
+        blitter.MemoryFill(config);
+        for (u32 i = 0; i < 0x60; i += 4) {
+            u32 value;
+            std::memcpy(&value, dst + i, sizeof(u32));
+            REQUIRE(value == 0xAABBCCDD);
+        }
+    }
+}
+
+TEST_CASE("SwBlitter::MemoryFill benchmark", "[video_core][sw_blitter][!benchmark]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    NullRasterizer rasterizer;
+    SwRenderer::SwBlitter blitter{memory, &rasterizer};
+
+    Pica::MemoryFillConfig config{};
+    config.address_start = DST_ADDR >> 3;
+    config.address_end = (DST_ADDR + 240 * 400 * 3) >> 3;
+    config.fill_24bit.Assign(1);
+
+    BENCHMARK("24-bit fill 240x400") {
+        blitter.MemoryFill(config);
+    };
+}
@@ -0,0 +1,243 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/pica/regs_texturing.h"
+#include "video_core/renderer_software/sw_tev.h"
+#include "video_core/renderer_software/sw_texturing.h"
+
+namespace {
+
+using Pica::TexturingRegs;
+using TevStageConfig = TexturingRegs::TevStageConfig;
+using Source = TevStageConfig::Source;
+using ColorModifier = TevStageConfig::ColorModifier;
+using AlphaModifier = TevStageConfig::AlphaModifier;
+using Operation = TevStageConfig::Operation;
+
+constexpr std::array VALID_SOURCES = {
+    Source::PrimaryColor,
+    Source::PrimaryFragmentColor,
+    Source::SecondaryFragmentColor,
+    Source::Texture0,
+    Source::Texture1,
+    Source::Texture2,
+    Source::Texture3,
+    Source::PreviousBuffer,
+    Source::Constant,
+    Source::Previous,
+};
+
+constexpr std::array VALID_COLOR_MODIFIERS = {
+    ColorModifier::SourceColor,
+    ColorModifier::OneMinusSourceColor,
+    ColorModifier::SourceAlpha,
+    ColorModifier::OneMinusSourceAlpha,
+    ColorModifier::SourceRed,
+    ColorModifier::OneMinusSourceRed,
+    ColorModifier::SourceGreen,
+    ColorModifier::OneMinusSourceGreen,
+    ColorModifier::SourceBlue,
+    ColorModifier::OneMinusSourceBlue,
+};
+
+/// Decodes the combiner registers for every fragment, like the rasterizer did before the TEV was
+/// turned into a program. The modifier and combiner routines themselves are shared.
+Common::Vec4<u8> ReferenceTev(const TexturingRegs& regs,
+                              std::span<const Common::Vec4<u8>, 4> texture_color,
+                              Common::Vec4<u8> primary_color,
+                              Common::Vec4<u8> primary_fragment_color,
+                              Common::Vec4<u8> secondary_fragment_color) {
+    using namespace SwRenderer;
+
+    const auto tev_stages = regs.GetTevStages();
+    Common::Vec4<u8> combiner_output = {0, 0, 0, 0};
+    Common::Vec4<u8> combiner_buffer = {0, 0, 0, 0};
+    Common::Vec4<u8> next_combiner_buffer =
+        Common::MakeVec(regs.tev_combiner_buffer_color.r.Value(),
+                        regs.tev_combiner_buffer_color.g.Value(),
+                        regs.tev_combiner_buffer_color.b.Value(),
+                        regs.tev_combiner_buffer_color.a.Value())
+            .Cast<u8>();
+
+    for (u32 tev_stage_index = 0; tev_stage_index < tev_stages.size(); ++tev_stage_index) {
+        const auto& tev_stage = tev_stages[tev_stage_index];
+
+        auto get_source = [&](Source source) -> Common::Vec4<u8> {
+            switch (source) {
+            case Source::PrimaryColor:
+                return primary_color;
+            case Source::PrimaryFragmentColor:
+                return primary_fragment_color;
+            case Source::SecondaryFragmentColor:
+                return secondary_fragment_color;
+            case Source::Texture0:
+                return texture_color[0];
+            case Source::Texture1:
+                return texture_color[1];
+            case Source::Texture2:
+                return texture_color[2];
+            case Source::Texture3:
+                return texture_color[3];
+            case Source::PreviousBuffer:
+                return combiner_buffer;
+            case Source::Constant:
+                return Common::MakeVec(tev_stage.const_r.Value(), tev_stage.const_g.Value(),
+                                       tev_stage.const_b.Value(), tev_stage.const_a.Value())
+                    .Cast<u8>();
+            case Source::Previous:
+                return combiner_output;
+            default:
+                return {0, 0, 0, 0};
+            }
+        };
+
+        const auto source1 = tev_stage_index == 0 && tev_stage.color_source1 == Source::Previous
+                                 ? tev_stage.color_source3.Value()
+                                 : tev_stage.color_source1.Value();
+        const auto source2 = tev_stage_index == 0 && tev_stage.color_source2 == Source::Previous
+                                 ? tev_stage.color_source3.Value()
+                                 : tev_stage.color_source2.Value();
+        const std::array<Common::Vec3<u8>, 3> color_result = {
+            GetColorModifier(tev_stage.color_modifier1)(get_source(source1)),
+            GetColorModifier(tev_stage.color_modifier2)(get_source(source2)),
+            GetColorModifier(tev_stage.color_modifier3)(get_source(tev_stage.color_source3)),
+        };
+        const Common::Vec3<u8> color_output = GetColorCombine(tev_stage.color_op)(color_result);
+
+        u8 alpha_output;
+        if (tev_stage.color_op == Operation::Dot3_RGBA) {
+            alpha_output = color_output.x;
+        } else {
+            const std::array<u8, 3> alpha_result = {{
+                GetAlphaModifier(tev_stage.alpha_modifier1)(get_source(tev_stage.alpha_source1)),
+                GetAlphaModifier(tev_stage.alpha_modifier2)(get_source(tev_stage.alpha_source2)),
+                GetAlphaModifier(tev_stage.alpha_modifier3)(get_source(tev_stage.alpha_source3)),
+            }};
+            alpha_output = GetAlphaCombine(tev_stage.alpha_op)(alpha_result);
+        }
+
+        combiner_output[0] = std::min(255U, color_output.r() * tev_stage.GetColorMultiplier());
+        combiner_output[1] = std::min(255U, color_output.g() * tev_stage.GetColorMultiplier());
+        combiner_output[2] = std::min(255U, color_output.b() * tev_stage.GetColorMultiplier());
+        combiner_output[3] = std::min(255U, alpha_output * tev_stage.GetAlphaMultiplier());
+
+        combiner_buffer = next_combiner_buffer;
+
+        if (regs.tev_combiner_buffer_input.TevStageUpdatesCombinerBufferColor(tev_stage_index)) {
+            next_combiner_buffer.r() = combiner_output.r();
+            next_combiner_buffer.g() = combiner_output.g();
+            next_combiner_buffer.b() = combiner_output.b();
+        }
+
+        if (regs.tev_combiner_buffer_input.TevStageUpdatesCombinerBufferAlpha(tev_stage_index)) {
+            next_combiner_buffer.a() = combiner_output.a();
+        }
+    }
+
+    return combiner_output;
+}
+
+/// Fills a stage with a random valid configuration.
+void MakeRandomStage(TevStageConfig& stage, std::mt19937& rng) {
+    const auto random = [&rng](std::size_t n) { return static_cast<u32>(rng() % n); };
+    const auto source = [&] { return VALID_SOURCES[random(VALID_SOURCES.size())]; };
+    const auto color_modifier = [&] {
+        return VALID_COLOR_MODIFIERS[random(VALID_COLOR_MODIFIERS.size())];
+    };
+    const auto alpha_modifier = [&] { return static_cast<AlphaModifier>(random(8)); };
+
+    stage.color_source1.Assign(source());
+    stage.color_source2.Assign(source());
+    stage.color_source3.Assign(source());
+    stage.alpha_source1.Assign(source());
+    stage.alpha_source2.Assign(source());
+    stage.alpha_source3.Assign(source());
+    stage.color_modifier1.Assign(color_modifier());
+    stage.color_modifier2.Assign(color_modifier());
+    stage.color_modifier3.Assign(color_modifier());
+    stage.alpha_modifier1.Assign(alpha_modifier());
+    stage.alpha_modifier2.Assign(alpha_modifier());
+    stage.alpha_modifier3.Assign(alpha_modifier());
+    stage.color_op.Assign(static_cast<Operation>(random(10)));
+    // The alpha combiner has no dot product operations
+    Operation alpha_op;
+    do {
+        alpha_op = static_cast<Operation>(random(10));
+    } while (alpha_op == Operation::Dot3_RGB || alpha_op == Operation::Dot3_RGBA);
+    stage.alpha_op.Assign(alpha_op);
+    stage.const_color = static_cast<u32>(rng());
+    stage.color_scale.Assign(random(4));
+    stage.alpha_scale.Assign(random(4));
+}
+
+/// Makes a stage pass the previous output through, while leaving the unused fields random.
+void MakePassthroughStage(TevStageConfig& stage) {
+    stage.color_source1.Assign(Source::Previous);
+    stage.alpha_source1.Assign(Source::Previous);
+    stage.color_modifier1.Assign(ColorModifier::SourceColor);
+    stage.alpha_modifier1.Assign(AlphaModifier::SourceAlpha);
+    stage.color_op.Assign(Operation::Replace);
+    stage.alpha_op.Assign(Operation::Replace);
+    stage.color_scale.Assign(0);
+    stage.alpha_scale.Assign(0);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("TevProgram Random Configurations", "[video_core][sw_renderer]") {
+    std::mt19937 rng{1234};
+    const auto random_color = [&rng] {
+        const u32 value = static_cast<u32>(rng());
+        return Common::MakeVec(value, value >> 8, value >> 16, value >> 24).Cast<u8>();
+    };
+
+    // The program is reused across configurations to also cover rebuilding it.
+    SwRenderer::TevProgram program;
+    for (u32 config = 0; config < 2000; ++config) {
+        CAPTURE(config);
+
+        TexturingRegs regs{};
+        std::array<TevStageConfig*, 6> stages = {&regs.tev_stage0, &regs.tev_stage1,
+                                                 &regs.tev_stage2, &regs.tev_stage3,
+                                                 &regs.tev_stage4, &regs.tev_stage5};
+        // Let some configurations end in stages that can be dropped, including the first one.
+        const std::size_t first_passthrough = rng() % 2 ? stages.size() : rng() % stages.size();
+        for (std::size_t i = 0; i < stages.size(); ++i) {
+            MakeRandomStage(*stages[i], rng);
+            if (i >= first_passthrough || rng() % 8 == 0) {
+                MakePassthroughStage(*stages[i]);
+                // A scale of 3 also multiplies by one, the others make the stage change the output
+                if (rng() % 4 == 0) {
+                    stages[i]->color_scale.Assign(rng() % 4);
+                    stages[i]->alpha_scale.Assign(rng() % 4);
+                }
+            }
+        }
+        regs.tev_combiner_buffer_input.update_mask_rgb.Assign(rng() % 16);
+        regs.tev_combiner_buffer_input.update_mask_a.Assign(rng() % 16);
+        regs.tev_combiner_buffer_color.raw = static_cast<u32>(rng());
+
+        program.Configure(regs);
+        for (u32 fragment = 0; fragment < 32; ++fragment) {
+            CAPTURE(fragment);
+
+            std::array<Common::Vec4<u8>, 4> texture_color;
+            std::generate(texture_color.begin(), texture_color.end(), random_color);
+            const auto primary_color = random_color();
+            const auto primary_fragment_color = random_color();
+            const auto secondary_fragment_color = random_color();
+
+            const auto expected = ReferenceTev(regs, texture_color, primary_color,
+                                               primary_fragment_color, secondary_fragment_color);
+            const auto result = program.Run(texture_color, primary_color, primary_fragment_color,
+                                            secondary_fragment_color);
+            REQUIRE(result == expected);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "core/tracer/recorder.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/debug_utils/trace_player.h"
+#include "video_core/gpu.h"
+#include "video_core/pica/pica_core.h"
+
+TEST_CASE("CiTrace record and replay", "[video_core][tracer]") {
+    Core::System system;
+    Memory::MemorySystem memory{system};
+    Pica::PicaCore pica{memory, nullptr};
+
+    constexpr PAddr load_addr = Memory::VRAM_PADDR + 0x1000;
+    constexpr PAddr fill_start = Memory::VRAM_PADDR;
+    constexpr PAddr fill_end = Memory::VRAM_PADDR + 0x40;
+    constexpr u32 fill_value = 0xAABBCCDD;
+    const std::array<u8, 4> loaded_data{1, 2, 3, 4};
+
+    const auto write_reg = [&](CiTrace::Recorder& recorder, u32 index, u32 value) {
+        recorder.RegisterWritten(VideoCore::PADDR_GPU + index * sizeof(u32), value);
+    };
+
+    // A 32-bit memory fill whose trigger is followed by a memory load, like the GPU records them.
+    const auto recorder = Pica::DebugUtils::CreateTraceRecorder(pica);
+    write_reg(*recorder, GPU_REG_INDEX(memory_fill_config[0].address_start), fill_start >> 3);
+    write_reg(*recorder, GPU_REG_INDEX(memory_fill_config[0].address_end), fill_end >> 3);
+    write_reg(*recorder, GPU_REG_INDEX(memory_fill_config[0].value_32bit), fill_value);
+    write_reg(*recorder, GPU_REG_INDEX(memory_fill_config[0].control), 0x201);
+    recorder->MemoryAccessed(loaded_data.data(), loaded_data.size(), load_addr);
+    recorder->FrameFinished();
+
+    const auto path = (std::filesystem::temp_directory_path() / "citra_test_trace.ctf").string();
+    recorder->Finish(path);
+
+    CiTrace::Player player{memory, false};
+    REQUIRE(player.Load(path));
+    const auto frames = player.Play();
+    FileUtil::Delete(path);
+
+    REQUIRE(frames.size() == 1);
+    u32 value;
+    std::memcpy(&value, memory.GetPhysicalPointer(fill_end - sizeof(u32)), sizeof(u32));
+    REQUIRE(value == fill_value);
+    REQUIRE(std::memcmp(memory.GetPhysicalPointer(load_addr), loaded_data.data(),
+                        loaded_data.size()) == 0);
+}
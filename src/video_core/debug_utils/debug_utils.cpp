@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <cstring>
 #include <fstream>
+#include <span>
 #include <stdexcept>
 #include <nihstro/bit_field.h>
 #include <nihstro/float24.h>
@@ -13,8 +14,10 @@
 #include "common/bit_field.h"
 #include "common/vector_math.h"
 #include "core/core.h"
+#include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
+#include "video_core/pica/pica_core.h"
 #include "video_core/pica/regs_shader.h"
 #include "video_core/pica/shader_setup.h"
 #include "video_core/renderer_base.h"
@@ -296,6 +299,39 @@ std::unique_ptr<PicaTrace> FinishPicaTracing() {
     return ret;
 }
 
+std::shared_ptr<CiTrace::Recorder> CreateTraceRecorder(const PicaCore& pica) {
+    CiTrace::Recorder::InitialState state;
+
+    const auto copy = [](std::vector<u32>& dest, const auto& data) {
+        static_assert(sizeof(data) % sizeof(u32) == 0);
+        dest.resize(sizeof(data) / sizeof(u32));
+        std::memcpy(dest.data(), std::addressof(data), sizeof(data));
+    };
+
+    // Encode floating point numbers to 24-bit values
+    // TODO: Drop this explicit conversion once we store float24 values bit-correctly internally.
+    const auto encode = [](std::vector<u32>& dest, std::span<const Common::Vec4<f24>> data) {
+        dest.resize(data.size() * 4);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            for (u32 comp = 0; comp < 4; ++comp) {
+                dest[4 * i + comp] = nihstro::to_float24(data[i][comp].ToFloat32());
+            }
+        }
+    };
+
+    copy(state.lcd_registers, pica.regs_lcd);
+    copy(state.pica_registers, pica.regs.reg_array);
+    encode(state.default_attributes, pica.input_default_attributes);
+    copy(state.vs_program_binary, pica.vs_setup.program_code);
+    copy(state.vs_swizzle_data, pica.vs_setup.swizzle_data);
+    encode(state.vs_float_uniforms, pica.vs_setup.uniforms.f);
+    copy(state.gs_program_binary, pica.gs_setup.program_code);
+    copy(state.gs_swizzle_data, pica.gs_setup.swizzle_data);
+    encode(state.gs_float_uniforms, pica.gs_setup.uniforms.f);
+
+    return std::make_shared<CiTrace::Recorder>(state);
+}
+
 } // namespace DebugUtils
 
 } // namespace Pica
@@ -21,6 +21,7 @@ class Recorder;
 
 namespace Pica {
 
+class PicaCore;
 struct ShaderRegs;
 struct ShaderSetup;
 
@@ -196,6 +197,9 @@ inline bool IsPicaTracing() {
 void OnPicaRegWrite(u16 cmd_id, u16 mask, u32 value);
 std::unique_ptr<PicaTrace> FinishPicaTracing();
 
+/// Creates a CiTrace recorder whose initial state is the current state of the given PICA GPU.
+std::shared_ptr<CiTrace::Recorder> CreateTraceRecorder(const PicaCore& pica);
+
 } // namespace DebugUtils
 
 } // namespace Pica
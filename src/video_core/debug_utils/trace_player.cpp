@@ -0,0 +1,330 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <utility>
+#include "common/assert.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "core/memory.h"
+#include "video_core/debug_utils/trace_player.h"
+#include "video_core/gpu.h"
+#include "video_core/pica/pica_core.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_software/sw_blitter.h"
+#include "video_core/renderer_software/sw_rasterizer.h"
+#include "video_core/shader/shader.h"
+
+namespace CiTrace {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using FrameStats = Player::FrameStats;
+
+/// Forwards to another shader engine, accumulating the time spent in it.
+class TimedShaderEngine final : public Pica::ShaderEngine {
+public:
+    TimedShaderEngine(std::unique_ptr<Pica::ShaderEngine> engine_, FrameStats& stats_)
+        : engine{std::move(engine_)}, stats{stats_} {}
+
+    void SetupBatch(Pica::ShaderSetup& setup, u32 entry_point) override {
+        const auto start = Clock::now();
+        engine->SetupBatch(setup, entry_point);
+        stats.vertex_shading += Clock::now() - start;
+    }
+
+    void Run(const Pica::ShaderSetup& setup, Pica::ShaderUnit& state) const override {
+        const auto start = Clock::now();
+        engine->Run(setup, state);
+        stats.vertex_shading += Clock::now() - start;
+    }
+
+private:
+    std::unique_ptr<Pica::ShaderEngine> engine;
+    FrameStats& stats;
+};
+
+/// Software rasterizer that accumulates the time spent drawing triangles.
+class TimedRasterizer final : public SwRenderer::RasterizerSoftware {
+public:
+    TimedRasterizer(Memory::MemorySystem& memory, Pica::PicaCore& pica, FrameStats& stats_)
+        : RasterizerSoftware{memory, pica}, stats{stats_} {}
+
+    void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
+                     const Pica::OutputVertex& v2) override {
+        const auto start = Clock::now();
+        RasterizerSoftware::AddTriangle(v0, v1, v2);
+        stats.rasterization += Clock::now() - start;
+        stats.triangles++;
+    }
+
+private:
+    FrameStats& stats;
+};
+
+/// Rasterizer that only counts the triangles it receives.
+class NullRasterizer final : public VideoCore::RasterizerInterface {
+public:
+    explicit NullRasterizer(FrameStats& stats_) : stats{stats_} {}
+
+    void AddTriangle(const Pica::OutputVertex&, const Pica::OutputVertex&,
+                     const Pica::OutputVertex&) override {
+        stats.triangles++;
+    }
+    void DrawTriangles() override {}
+    void FlushAll() override {}
+    void FlushRegion(PAddr addr, u32 size) override {}
+    void InvalidateRegion(PAddr addr, u32 size) override {}
+    void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
+    void ClearAll(bool flush) override {}
+
+private:
+    FrameStats& stats;
+};
+
+bool IsTriggerRegister(u32 index) {
+    switch (index) {
+    case GPU_REG_INDEX(memory_fill_config[0].trigger):
+    case GPU_REG_INDEX(memory_fill_config[1].trigger):
+    case GPU_REG_INDEX(display_transfer_config.trigger):
+    case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[0]):
+    case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[1]):
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // Anonymous namespace
+
+Player::Player(Memory::MemorySystem& memory_, bool rasterize_)
+    : memory{memory_}, rasterize{rasterize_} {}
+
+Player::~Player() = default;
+
+bool Player::Load(const std::string& filename) {
+    FileUtil::IOFile file(filename, "rb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Could not open CiTrace {}", filename);
+        return false;
+    }
+    trace.resize(file.GetSize());
+    if (file.ReadBytes(trace.data(), trace.size()) != trace.size() ||
+        trace.size() < sizeof(CTHeader)) {
+        LOG_ERROR(HW_GPU, "Could not read CiTrace {}", filename);
+        return false;
+    }
+
+    std::memcpy(&header, trace.data(), sizeof(CTHeader));
+    if (std::memcmp(header.magic, CTHeader::ExpectedMagicWord(), sizeof(header.magic)) != 0 ||
+        header.version != CTHeader::ExpectedVersion()) {
+        LOG_ERROR(HW_GPU, "{} is not a supported CiTrace", filename);
+        return false;
+    }
+
+    const u64 stream_end =
+        header.stream_offset + u64{header.stream_size} * sizeof(CTStreamElement);
+    if (stream_end > trace.size()) {
+        LOG_ERROR(HW_GPU, "CiTrace {} is truncated", filename);
+        return false;
+    }
+    for (u32 i = 0; i < header.stream_size; ++i) {
+        CTStreamElement element;
+        std::memcpy(&element, trace.data() + header.stream_offset + i * sizeof(element),
+                    sizeof(element));
+        if (element.type == MemoryLoad &&
+            u64{element.memory_load.file_offset} + element.memory_load.size > trace.size()) {
+            LOG_ERROR(HW_GPU, "CiTrace {} has a memory load outside of the file", filename);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Player::FrameStats> Player::Play() {
+    // Start from a fresh GPU so that every replay of the trace does the same work.
+    blitter.reset();
+    rasterizer.reset();
+    pica = std::make_unique<Pica::PicaCore>(memory, nullptr);
+    pica->SetShaderEngine(std::make_unique<TimedShaderEngine>(
+        Pica::CreateEngine(Settings::values.use_shader_jit.GetValue()), current_frame));
+    if (rasterize) {
+        rasterizer = std::make_unique<TimedRasterizer>(memory, *pica, current_frame);
+    } else {
+        rasterizer = std::make_unique<NullRasterizer>(current_frame);
+    }
+    pica->BindRasterizer(rasterizer.get());
+    Service::GSP::InterruptHandler interrupt_handler = [](Service::GSP::InterruptId) {};
+    pica->SetInterruptHandler(interrupt_handler);
+    blitter = std::make_unique<SwRenderer::SwBlitter>(memory, rasterizer.get());
+
+    LoadInitialState();
+    current_frame = {};
+    pending_trigger.reset();
+
+    std::vector<FrameStats> frames;
+    for (u32 i = 0; i < header.stream_size; ++i) {
+        CTStreamElement element;
+        std::memcpy(&element, trace.data() + header.stream_offset + i * sizeof(element),
+                    sizeof(element));
+
+        switch (element.type) {
+        case FrameMarker:
+            RunPendingTrigger();
+            frames.push_back(std::exchange(current_frame, {}));
+            break;
+        case MemoryLoad: {
+            const auto& load = element.memory_load;
+            if (u8* dest = memory.GetPhysicalPointer(load.physical_address)) {
+                std::memcpy(dest, trace.data() + load.file_offset, load.size);
+            }
+            break;
+        }
+        case RegisterWrite:
+            RunPendingTrigger();
+            WriteRegister(element.register_write);
+            break;
+        default:
+            LOG_WARNING(HW_GPU, "Unknown CiTrace stream element {:#x}",
+                        static_cast<u32>(element.type));
+            break;
+        }
+    }
+
+    // Keep the work done after the last frame marker, if any.
+    RunPendingTrigger();
+    if (current_frame.total.count() != 0) {
+        frames.push_back(current_frame);
+    }
+    return frames;
+}
+
+void Player::LoadInitialState() {
+    const auto& offsets = header.initial_state_offsets;
+    auto& regs = pica->regs;
+
+    ReadWords(offsets.lcd_registers, offsets.lcd_registers_size, &pica->regs_lcd,
+              sizeof(pica->regs_lcd));
+    ReadWords(offsets.pica_registers, offsets.pica_registers_size, regs.reg_array.data(),
+              sizeof(regs.reg_array));
+
+    const auto read_floats = [this](u32 offset, u32 count,
+                                    std::span<Common::Vec4<Pica::f24>> dest) {
+        std::vector<u32> values(std::min<std::size_t>(count, dest.size() * 4));
+        ReadWords(offset, count, values.data(), values.size() * sizeof(u32));
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            dest[i / 4][i % 4] = Pica::f24::FromRaw(values[i]);
+        }
+    };
+    read_floats(offsets.default_attributes, offsets.default_attributes_size,
+                pica->input_default_attributes);
+
+    const auto read_shader = [&](Pica::ShaderSetup& setup, const Pica::ShaderRegs& config,
+                                 u32 program_offset, u32 program_size, u32 swizzle_offset,
+                                 u32 swizzle_size, u32 uniforms_offset, u32 uniforms_size) {
+        ReadWords(program_offset, program_size, setup.program_code.data(),
+                  sizeof(setup.program_code));
+        ReadWords(swizzle_offset, swizzle_size, setup.swizzle_data.data(),
+                  sizeof(setup.swizzle_data));
+        read_floats(uniforms_offset, uniforms_size, setup.uniforms.f);
+        setup.MarkProgramCodeDirty();
+        setup.MarkSwizzleDataDirty();
+
+        // Boolean and integer uniforms are only kept in the registers.
+        setup.WriteUniformBoolReg(config.bool_uniforms.Value());
+        for (u32 i = 0; i < 4; ++i) {
+            setup.WriteUniformIntReg(i, config.GetIntUniform(i));
+        }
+    };
+    read_shader(pica->vs_setup, regs.internal.vs, offsets.vs_program_binary,
+                offsets.vs_program_binary_size, offsets.vs_swizzle_data,
+                offsets.vs_swizzle_data_size, offsets.vs_float_uniforms,
+                offsets.vs_float_uniforms_size);
+    read_shader(pica->gs_setup, regs.internal.gs, offsets.gs_program_binary,
+                offsets.gs_program_binary_size, offsets.gs_swizzle_data,
+                offsets.gs_swizzle_data_size, offsets.gs_float_uniforms,
+                offsets.gs_float_uniforms_size);
+}
+
+std::size_t Player::ReadWords(u32 offset, u32 count, void* dest, std::size_t dest_size) const {
+    std::size_t size = std::min<std::size_t>(u64{count} * sizeof(u32), dest_size);
+    if (offset > trace.size()) {
+        return 0;
+    }
+    size = std::min<std::size_t>(size, trace.size() - offset);
+    std::memcpy(dest, trace.data() + offset, size);
+    return size / sizeof(u32);
+}
+
+void Player::WriteRegister(const CTRegisterWrite& write) {
+    const PAddr addr = write.physical_address;
+    if (addr >= VideoCore::PADDR_GPU &&
+        addr < VideoCore::PADDR_GPU + Pica::PicaCore::Regs::NUM_REGS * sizeof(u32)) {
+        const u32 index = (addr - VideoCore::PADDR_GPU) / sizeof(u32);
+        pica->regs.reg_array[index] = write.value;
+        if (IsTriggerRegister(index)) {
+            pending_trigger = index;
+        }
+    } else if (addr >= VideoCore::PADDR_LCD &&
+               addr < VideoCore::PADDR_LCD + Pica::RegsLcd::NumIds() * sizeof(u32)) {
+        pica->regs_lcd[(addr - VideoCore::PADDR_LCD) / sizeof(u32)] = write.value;
+    } else {
+        LOG_WARNING(HW_GPU, "Ignoring CiTrace write to unknown register {:#010X}", addr);
+    }
+}
+
+void Player::RunPendingTrigger() {
+    if (!pending_trigger) {
+        return;
+    }
+    const u32 index = *std::exchange(pending_trigger, std::nullopt);
+    auto& regs = pica->regs;
+
+    const auto start = Clock::now();
+    switch (index) {
+    case GPU_REG_INDEX(memory_fill_config[0].trigger):
+    case GPU_REG_INDEX(memory_fill_config[1].trigger): {
+        const bool second = index == GPU_REG_INDEX(memory_fill_config[1].trigger);
+        auto& config = regs.memory_fill_config[second ? 1 : 0];
+        if (config.trigger) {
+            blitter->MemoryFill(config);
+            config.trigger.Assign(0);
+            config.finished.Assign(1);
+        }
+        break;
+    }
+    case GPU_REG_INDEX(display_transfer_config.trigger): {
+        auto& config = regs.display_transfer_config;
+        if (config.trigger) {
+            if (config.is_texture_copy) {
+                blitter->TextureCopy(config);
+            } else {
+                blitter->DisplayTransfer(config);
+            }
+            config.trigger.Assign(0);
+        }
+        break;
+    }
+    case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[0]):
+    case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[1]): {
+        auto& config = regs.internal.pipeline.command_buffer;
+        const u32 channel = index - GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[0]);
+        if (config.trigger[channel]) {
+            pica->ProcessCmdList(config.GetPhysicalAddress(channel), config.GetSize(channel),
+                                 false);
+            config.trigger[channel] = 0;
+        }
+        break;
+    }
+    default:
+        UNREACHABLE();
+    }
+    current_frame.total += Clock::now() - start;
+}
+
+} // namespace CiTrace
@@ -0,0 +1,89 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "core/tracer/citrace.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace Pica {
+class PicaCore;
+}
+
+namespace VideoCore {
+class RasterizerInterface;
+}
+
+namespace SwRenderer {
+class SwBlitter;
+}
+
+namespace CiTrace {
+
+/**
+ * Replays a CiTrace through the PICA GPU emulation without the rest of the system, measuring the
+ * time spent on every frame. Triangles are drawn by the software rasterizer, or discarded when
+ * rasterization is disabled to only measure command processing and vertex shading.
+ */
+class Player {
+public:
+    struct FrameStats {
+        std::chrono::nanoseconds total{};          ///< Time spent on all the GPU operations
+        std::chrono::nanoseconds vertex_shading{}; ///< Time spent running vertex/geometry shaders
+        std::chrono::nanoseconds rasterization{};  ///< Time spent drawing triangles
+        u64 triangles{};
+
+        /// Returns the time spent processing commands, loading vertices and transferring data.
+        std::chrono::nanoseconds CommandProcessing() const {
+            return total - vertex_shading - rasterization;
+        }
+    };
+
+    Player(Memory::MemorySystem& memory, bool rasterize);
+    ~Player();
+
+    /// Loads the trace from the given file, returns false if it is not a valid CiTrace.
+    bool Load(const std::string& filename);
+
+    /// Replays the loaded trace from its initial state and returns the statistics of every frame.
+    std::vector<FrameStats> Play();
+
+private:
+    /// Resets the GPU to the initial state stored in the trace.
+    void LoadInitialState();
+
+    /// Copies an array of words of the initial state to dest, returns the amount of words copied.
+    std::size_t ReadWords(u32 offset, u32 count, void* dest, std::size_t dest_size) const;
+
+    void WriteRegister(const CTRegisterWrite& write);
+
+    /**
+     * Runs the operation started by the last trigger register write. Operations are deferred
+     * until the next register write or frame marker, since the memory they read is recorded
+     * after the trigger.
+     */
+    void RunPendingTrigger();
+
+    Memory::MemorySystem& memory;
+    bool rasterize;
+    std::vector<u8> trace;
+    CTHeader header{};
+
+    std::unique_ptr<Pica::PicaCore> pica;
+    std::unique_ptr<VideoCore::RasterizerInterface> rasterizer;
+    std::unique_ptr<SwRenderer::SwBlitter> blitter;
+    FrameStats current_frame;
+    std::optional<u32> pending_trigger;
+};
+
+} // namespace CiTrace
@@ -2,13 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/alignment.h"
 #include "common/archives.h"
 #include "common/hacks/hack_manager.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp_gpu.h"
 #include "core/hle/service/plgldr/plgldr.h"
+#include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
 #include "video_core/gpu_debugger.h"
@@ -28,6 +31,24 @@ constexpr VAddr VADDR_GPU = 0x1EF00000;
 MICROPROFILE_DEFINE(GPU_DisplayTransfer, "GPU", "DisplayTransfer", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
 
+/// Returns the amount of bytes read from the input buffer by a display transfer or texture copy.
+static u32 GetTransferInputSize(const Pica::DisplayTransferConfig& config) {
+    if (!config.is_texture_copy) {
+        return config.input_width * config.input_height *
+               Pica::BytesPerPixel(config.input_format);
+    }
+    const u32 size = Common::AlignDown(config.texture_copy.size, 16);
+    const u32 width = config.texture_copy.input_width * 16;
+    const u32 gap = config.texture_copy.input_gap * 16;
+    if (gap == 0 || width == 0) {
+        return size;
+    }
+    // Every full line of input is followed by a gap, except for the last one.
+    const u32 lines = size / width;
+    const u32 remainder = size % width;
+    return remainder != 0 ? lines * (width + gap) + remainder : lines * (width + gap) - gap;
+}
+
 GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
          Frontend::EmuWindow* secondary_window)
     : right_eye_disabler{std::make_unique<RightEyeDisabler>(*this)},
@@ -36,9 +57,19 @@ GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
         "GPU::VBlankCallback",
         [this](uintptr_t user_data, s64 cycles_late) { VBlankCallback(user_data, cycles_late); });
     impl->timing.ScheduleEvent(FRAME_TICKS, impl->vblank_event);
+    impl->interrupt_event = impl->timing.RegisterEvent(
+        "GPU::InterruptCallback", [this](uintptr_t, s64) { DeliverPendingInterrupts(); });
 
     // Bind the rasterizer to the PICA GPU
     impl->pica.BindRasterizer(impl->rasterizer);
+
+    if (Settings::values.use_gpu_thread.GetValue()) {
+        if (impl->renderer->SupportsGPUThread()) {
+            impl->gpu_thread = std::make_unique<Common::ThreadWorker>(1, "GPU");
+        } else {
+            LOG_WARNING(HW_GPU, "The GPU thread is not supported by the current renderer");
+        }
+    }
 }
 
 GPU::~GPU() = default;
@@ -70,18 +101,33 @@ PAddr GPU::VirtualToPhysicalAddress(VAddr addr) {
 
 void GPU::SetInterruptHandler(Service::GSP::InterruptHandler handler) {
     impl->signal_interrupt = handler;
-    impl->pica.SetInterruptHandler(handler);
+    Service::GSP::InterruptHandler pica_handler = [this](Service::GSP::InterruptId interrupt_id) {
+        SignalInterrupt(interrupt_id);
+    };
+    impl->pica.SetInterruptHandler(pica_handler);
 }
 
 void GPU::FlushRegion(PAddr addr, u32 size) {
+    // The CPU is about to read the region, so wait for the GPU to be done writing it.
+    impl->WaitIdle();
     impl->rasterizer->FlushRegion(addr, size);
 }
 
 void GPU::InvalidateRegion(PAddr addr, u32 size) {
-    impl->rasterizer->InvalidateRegion(addr, size);
+    // Commands already queued were submitted before the CPU wrote the region, so ordering the
+    // invalidation after them is enough.
+    impl->Dispatch([this, addr, size] { impl->rasterizer->InvalidateRegion(addr, size); });
+}
+
+void GPU::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    impl->WaitIdle();
+    impl->rasterizer->FlushAndInvalidateRegion(addr, size);
 }
 
 void GPU::ClearAll(bool flush) {
+    // This is used around save states, so leave nothing in flight.
+    impl->WaitIdle();
+    DeliverPendingInterrupts();
     impl->rasterizer->ClearAll(flush);
 }
 
@@ -91,6 +137,8 @@ void GPU::Execute(const Service::GSP::Command& command) {
 
     switch (command.id) {
     case CommandId::RequestDma: {
+        // GSP commands complete in order, so the copy must observe all the previous ones.
+        impl->WaitIdle();
         impl->system.Memory().RasterizerFlushVirtualRegion(
             command.dma_request.source_address, command.dma_request.size, Memory::FlushMode::Flush);
         impl->system.Memory().RasterizerFlushVirtualRegion(command.dma_request.dest_address,
@@ -109,10 +157,17 @@ void GPU::Execute(const Service::GSP::Command& command) {
         auto& params = command.submit_gpu_cmdlist;
         auto& cmdbuffer = regs.internal.pipeline.command_buffer;
 
+        // A list still running on the GPU thread writes the internal registers and reads these
+        // ones for chained jumps, so let it finish first.
+        impl->WaitIdle();
+
         // Write to the command buffer GPU registers
         cmdbuffer.addr[0].Assign(VirtualToPhysicalAddress(params.address) >> 3);
         cmdbuffer.size[0].Assign(params.size >> 3);
         cmdbuffer.trigger[0] = 1;
+        RecordRegisters({GPU_REG_INDEX(internal.pipeline.command_buffer.addr[0]),
+                         GPU_REG_INDEX(internal.pipeline.command_buffer.size[0]),
+                         GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[0])});
 
         // Trigger processing of the command list
         SubmitCmdList(0);
@@ -130,6 +185,10 @@ void GPU::Execute(const Service::GSP::Command& command) {
             memfill[0].address_end = VirtualToPhysicalAddress(params.end1) >> 3;
             memfill[0].value_32bit = params.value1;
             memfill[0].control = params.control1;
+            RecordRegisters({GPU_REG_INDEX(memory_fill_config[0].address_start),
+                             GPU_REG_INDEX(memory_fill_config[0].address_end),
+                             GPU_REG_INDEX(memory_fill_config[0].value_32bit),
+                             GPU_REG_INDEX(memory_fill_config[0].control)});
             MemoryFill(0, has_both_bufs ? std::numeric_limits<u32>::max() : 0);
         }
         if (params.start2 != 0) {
@@ -137,6 +196,10 @@ void GPU::Execute(const Service::GSP::Command& command) {
             memfill[1].address_end = VirtualToPhysicalAddress(params.end2) >> 3;
             memfill[1].value_32bit = params.value2;
             memfill[1].control = params.control2;
+            RecordRegisters({GPU_REG_INDEX(memory_fill_config[1].address_start),
+                             GPU_REG_INDEX(memory_fill_config[1].address_end),
+                             GPU_REG_INDEX(memory_fill_config[1].value_32bit),
+                             GPU_REG_INDEX(memory_fill_config[1].control)});
             MemoryFill(1, has_both_bufs ? 0 : 1);
         }
         break;
@@ -152,6 +215,12 @@ void GPU::Execute(const Service::GSP::Command& command) {
         display_transfer.output_size = params.out_buffer_size;
         display_transfer.flags = params.flags;
         display_transfer.trigger.Assign(1);
+        RecordRegisters({GPU_REG_INDEX(display_transfer_config.input_address),
+                         GPU_REG_INDEX(display_transfer_config.output_address),
+                         GPU_REG_INDEX(display_transfer_config.input_size),
+                         GPU_REG_INDEX(display_transfer_config.output_size),
+                         GPU_REG_INDEX(display_transfer_config.flags),
+                         GPU_REG_INDEX(display_transfer_config.trigger)});
 
         // Trigger the display transfer.
         MemoryTransfer();
@@ -169,6 +238,13 @@ void GPU::Execute(const Service::GSP::Command& command) {
         texture_copy.texture_copy.output_size = params.out_width_gap;
         texture_copy.flags = params.flags;
         texture_copy.trigger.Assign(1);
+        RecordRegisters({GPU_REG_INDEX(display_transfer_config.input_address),
+                         GPU_REG_INDEX(display_transfer_config.output_address),
+                         GPU_REG_INDEX(display_transfer_config.texture_copy.size),
+                         GPU_REG_INDEX(display_transfer_config.texture_copy.input_size),
+                         GPU_REG_INDEX(display_transfer_config.texture_copy.output_size),
+                         GPU_REG_INDEX(display_transfer_config.flags),
+                         GPU_REG_INDEX(display_transfer_config.trigger)});
 
         // Trigger the texture copy.
         MemoryTransfer();
@@ -225,6 +301,8 @@ void GPU::SetColorFill(const Pica::ColorFill& fill) {
 }
 
 u32 GPU::ReadReg(VAddr addr) {
+    // Registers are updated by the GPU thread as commands complete.
+    impl->WaitIdle();
     switch (addr & 0xFFFFF000) {
     case VADDR_LCD: {
         const u32 offset = addr - VADDR_LCD;
@@ -254,6 +332,9 @@ void GPU::WriteReg(VAddr addr, u32 data) {
         ASSERT(addr % sizeof(u32) == 0);
         ASSERT(index < Pica::RegsLcd::NumIds());
         impl->pica.regs_lcd[index] = data;
+        if (auto* recorder = impl->TraceRecorder()) {
+            recorder->RegisterWritten(PADDR_LCD + offset, data);
+        }
         break;
     }
     case VADDR_GPU:
@@ -263,7 +344,10 @@ void GPU::WriteReg(VAddr addr, u32 data) {
 
         ASSERT(addr % sizeof(u32) == 0);
         ASSERT(index < Pica::PicaCore::Regs::NUM_REGS);
+        // The GPU thread accesses the registers while it runs command lists.
+        impl->WaitIdle();
         impl->pica.regs.reg_array[index] = data;
+        RecordRegisters({index});
 
         // Handle registers that trigger GPU actions
         switch (index) {
@@ -339,13 +423,15 @@ void GPU::SubmitCmdList(u32 index) {
         return;
     }
 
-    MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
-
     // Forward command list processing to the PICA core.
     const PAddr addr = config.GetPhysicalAddress(index);
     const u32 size = config.GetSize(index);
-    impl->pica.ProcessCmdList(addr, size,
-                              !right_eye_disabler->ShouldAllowCmdQueueTrigger(addr, size));
+    const bool ignore_list = !right_eye_disabler->ShouldAllowCmdQueueTrigger(addr, size);
+    RecordMemoryAccess(addr, size);
+    impl->Dispatch([this, addr, size, ignore_list] {
+        MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
+        impl->pica.ProcessCmdList(addr, size, ignore_list);
+    });
     config.trigger[index] = 0;
 }
 
@@ -356,20 +442,23 @@ void GPU::MemoryFill(u32 index, u32 intr_index) {
         return;
     }
 
-    // Perform memory fill.
-    if (!impl->rasterizer->AccelerateFill(config)) {
-        impl->sw_blitter->MemoryFill(config);
-    }
+    // Perform memory fill. The registers may be rewritten before the GPU thread gets to it, so
+    // it works on a copy of the configuration.
+    impl->Dispatch([this, config = config, intr_index] {
+        if (!impl->rasterizer->AccelerateFill(config)) {
+            impl->sw_blitter->MemoryFill(config);
+        }
 
-    // It seems that it won't signal interrupt if "address_start" is zero.
-    // TODO: hwtest this
-    if (config.GetStartAddress() != 0) {
-        if (intr_index == 0) {
-            impl->signal_interrupt(Service::GSP::InterruptId::PSC0);
-        } else if (intr_index == 1) {
-            impl->signal_interrupt(Service::GSP::InterruptId::PSC1);
+        // It seems that it won't signal interrupt if "address_start" is zero.
+        // TODO: hwtest this
+        if (config.GetStartAddress() != 0) {
+            if (intr_index == 0) {
+                SignalInterrupt(Service::GSP::InterruptId::PSC0);
+            } else if (intr_index == 1) {
+                SignalInterrupt(Service::GSP::InterruptId::PSC1);
+            }
         }
-    }
+    });
 
     // Reset "trigger" flag and set the "finish" flag
     // This was confirmed to happen on hardware even if "address_start" is zero.
@@ -384,36 +473,52 @@ void GPU::MemoryTransfer() {
         return;
     }
 
-    MICROPROFILE_SCOPE(GPU_DisplayTransfer);
-
     // Notify debugger about the display transfer.
     if (impl->debug_context) {
         impl->debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer, nullptr);
     }
 
+    const bool skip_transfer =
+        !config.is_texture_copy &&
+        !right_eye_disabler->ShouldAllowDisplayTransfer(config.GetPhysicalInputAddress(),
+                                                        config.input_height);
+
+    if (impl->TraceRecorder()) {
+        RecordMemoryAccess(config.GetPhysicalInputAddress(), GetTransferInputSize(config));
+    }
+
     // Perform memory transfer
-    if (config.is_texture_copy) {
-        if (!impl->rasterizer->AccelerateTextureCopy(config)) {
-            impl->sw_blitter->TextureCopy(config);
-        }
-    } else {
-        if (right_eye_disabler->ShouldAllowDisplayTransfer(config.GetPhysicalInputAddress(),
-                                                           config.input_height)) {
+    impl->Dispatch([this, config = config, skip_transfer] {
+        MICROPROFILE_SCOPE(GPU_DisplayTransfer);
+        if (config.is_texture_copy) {
+            if (!impl->rasterizer->AccelerateTextureCopy(config)) {
+                impl->sw_blitter->TextureCopy(config);
+            }
+        } else if (!skip_transfer) {
             if (!impl->rasterizer->AccelerateDisplayTransfer(config)) {
                 impl->sw_blitter->DisplayTransfer(config);
             }
         }
-    }
+        SignalInterrupt(Service::GSP::InterruptId::PPF);
+    });
 
     // Complete transfer.
     config.trigger.Assign(0);
-    impl->signal_interrupt(Service::GSP::InterruptId::PPF);
 }
 
 void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
-    // Present renderered frame.
+    // Present renderered frame. The renderer reads the framebuffers the queued commands are
+    // writing, so let them finish first.
+    impl->WaitIdle();
     impl->renderer->SwapBuffers();
 
+    if (auto* recorder = impl->TraceRecorder()) {
+        recorder->FrameFinished();
+    }
+
+    // Catch up on completed GPU commands in case their event has not fired yet.
+    DeliverPendingInterrupts();
+
     // Signal to GSP that GPU interrupt has occurred
     impl->signal_interrupt(Service::GSP::InterruptId::PDC0);
     impl->signal_interrupt(Service::GSP::InterruptId::PDC1);
@@ -422,6 +527,44 @@ void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
     impl->timing.ScheduleEvent(FRAME_TICKS - cycles_late, impl->vblank_event);
 }
 
+void GPU::SignalInterrupt(Service::GSP::InterruptId interrupt_id) {
+    if (!impl->gpu_thread) {
+        impl->signal_interrupt(interrupt_id);
+        return;
+    }
+    // The kernel may only be touched from the emulation thread, hand the interrupt over to it.
+    impl->pending_interrupts.Push(interrupt_id);
+    impl->timing.ScheduleEvent(0, impl->interrupt_event, 0, 0, true);
+}
+
+void GPU::DeliverPendingInterrupts() {
+    Service::GSP::InterruptId interrupt_id;
+    while (impl->pending_interrupts.Pop(interrupt_id)) {
+        impl->signal_interrupt(interrupt_id);
+    }
+}
+
+void GPU::RecordRegisters(std::initializer_list<u32> indices) {
+    auto* recorder = impl->TraceRecorder();
+    if (!recorder) {
+        return;
+    }
+    for (const u32 index : indices) {
+        recorder->RegisterWritten(PADDR_GPU + index * sizeof(u32),
+                                  impl->pica.regs.reg_array[index]);
+    }
+}
+
+void GPU::RecordMemoryAccess(PAddr addr, u32 size) {
+    auto* recorder = impl->TraceRecorder();
+    if (!recorder || size == 0) {
+        return;
+    }
+    if (const u8* data = impl->memory.GetPhysicalPointer(addr)) {
+        recorder->MemoryAccessed(data, size, addr);
+    }
+}
+
 template <class Archive>
 void GPU::serialize(Archive& ar, const u32 file_version) {
     ar & impl->pica;
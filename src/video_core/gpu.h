@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <initializer_list>
 #include <memory>
 #include <boost/serialization/access.hpp>
 
@@ -35,6 +36,10 @@ namespace VideoCore {
 /// Measured on hardware to be 2240568 timer cycles or 4481136 ARM11 cycles
 constexpr u64 FRAME_TICKS = 4481136ull;
 
+/// Physical addresses of the LCD and GPU register blocks, as stored in CiTrace register writes.
+constexpr PAddr PADDR_LCD = 0x10202000;
+constexpr PAddr PADDR_GPU = 0x10400000;
+
 class GraphicsDebugger;
 class RendererBase;
 class RightEyeDisabler;
@@ -57,6 +62,9 @@ public:
     /// Notify rasterizer that any caches of the specified region should be invalidated
     void InvalidateRegion(PAddr addr, u32 size);
 
+    /// Notify rasterizer that any caches of the specified region should be flushed and invalidated
+    void FlushAndInvalidateRegion(PAddr addr, u32 size);
+
     /// Flushes and invalidates all memory in the rasterizer cache and removes any leftover state.
     void ClearAll(bool flush);
 
@@ -106,6 +114,18 @@ private:
 
     void VBlankCallback(uintptr_t user_data, s64 cycles_late);
 
+    /// Signals the interrupt, deferring it to the emulation thread if raised on the GPU thread.
+    void SignalInterrupt(Service::GSP::InterruptId interrupt_id);
+
+    /// Signals the interrupts raised on the GPU thread since the last call.
+    void DeliverPendingInterrupts();
+
+    /// Records the current value of the given GPU registers to the active CiTrace, if any.
+    void RecordRegisters(std::initializer_list<u32> indices);
+
+    /// Records the contents of a memory range read by the GPU to the active CiTrace, if any.
+    void RecordMemoryAccess(PAddr addr, u32 size);
+
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const u32 file_version);
@@ -7,6 +7,8 @@
 
 #include "common/archives.h"
 #include "common/microprofile.h"
+#include "common/thread_worker.h"
+#include "common/threadsafe_queue.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp_gpu.h"
@@ -34,8 +36,16 @@ struct GPU::Impl {
     RasterizerInterface* rasterizer;
     std::unique_ptr<SwRenderer::SwBlitter> sw_blitter;
     Core::TimingEventType* vblank_event;
+    Core::TimingEventType* interrupt_event;
     Service::GSP::InterruptHandler signal_interrupt;
 
+    /// Interrupts raised on the GPU thread, waiting to be signalled on the emulation thread.
+    Common::MPSCQueue<Service::GSP::InterruptId> pending_interrupts;
+
+    /// Processes GPU commands when the GPU thread is enabled, nullptr otherwise. Declared last so
+    /// that the thread is stopped before anything it uses is destroyed.
+    std::unique_ptr<Common::ThreadWorker> gpu_thread;
+
     explicit Impl(Core::System& system, Frontend::EmuWindow& emu_window,
                   Frontend::EmuWindow* secondary_window)
         : timing{system.CoreTiming()}, system{system}, memory{system.Memory()},
@@ -44,5 +54,30 @@ struct GPU::Impl {
           rasterizer{renderer->Rasterizer()},
           sw_blitter{std::make_unique<SwRenderer::SwBlitter>(memory, rasterizer)} {}
     ~Impl() = default;
+
+    /// Returns the active CiTrace recorder, or nullptr when no trace is being recorded.
+    CiTrace::Recorder* TraceRecorder() const {
+        return debug_context ? debug_context->recorder.get() : nullptr;
+    }
+
+    /// Runs the command on the GPU thread when it is enabled, otherwise right away.
+    template <typename Func>
+    void Dispatch(Func&& command) {
+        // Traces are recorded from the emulation thread in submission order, so while recording
+        // every command runs synchronously.
+        if (gpu_thread && !TraceRecorder()) {
+            gpu_thread->QueueWork(std::move(command));
+        } else {
+            WaitIdle();
+            command();
+        }
+    }
+
+    /// Waits until the GPU thread has processed all the dispatched commands.
+    void WaitIdle() {
+        if (gpu_thread) {
+            gpu_thread->WaitForRequests();
+        }
+    }
 };
 } // namespace VideoCore
\ No newline at end of file
@@ -309,12 +309,18 @@ private:
 
 GeometryPipeline::GeometryPipeline(RegsInternal& regs_, GeometryShaderUnit& gs_unit_,
                                    ShaderSetup& gs_)
-    : regs(regs_), gs_unit(gs_unit_), gs(gs_) {}
+    : regs(regs_), gs_unit(gs_unit_), gs(gs_) {
+    // A geometry shader invocation may emit several triangles, leave room for them.
+    primitives.reserve(MAX_BATCHED_PRIMITIVES * 2);
+    gs_unit.SetPrimitiveBuffer(&primitives);
+}
 
 GeometryPipeline::~GeometryPipeline() = default;
 
-void GeometryPipeline::SetVertexHandler(VertexHandler vertex_handler) {
+void GeometryPipeline::SetVertexHandlers(VertexHandler vertex_handler,
+                                         PrimitiveHandler primitive_handler) {
     this->vertex_handler = std::move(vertex_handler);
+    this->primitive_handler = std::move(primitive_handler);
 }
 
 void GeometryPipeline::Setup(ShaderEngine* shader_engine) {
@@ -383,13 +389,26 @@ void GeometryPipeline::SubmitVertex(const AttributeBuffer& input) {
             // for the shader to know if this is the first invocation in a batch, if the program set
             // b15 to false first.
             gs.uniforms.b[15] = true;
+
+            if (primitives.size() >= MAX_BATCHED_PRIMITIVES) {
+                Flush();
+            }
         }
     }
 }
 
+void GeometryPipeline::Flush() {
+    if (primitives.empty()) {
+        return;
+    }
+    primitive_handler(primitives);
+    primitives.clear();
+}
+
 template <class Archive>
 void GeometryPipeline::serialize(Archive& ar, const unsigned int version) {
-    // vertex_handler and shader_engine are always set to the same value
+    // vertex_handler, primitive_handler and shader_engine are always set to the same value, and
+    // emitted primitives are flushed before the end of every draw
     ar & backend;
 }
 
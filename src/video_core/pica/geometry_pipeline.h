@@ -26,8 +26,9 @@ public:
     explicit GeometryPipeline(RegsInternal& regs, GeometryShaderUnit& gs_unit, ShaderSetup& gs);
     ~GeometryPipeline();
 
-    /// Sets the handler for receiving vertex outputs from vertex shader
-    void SetVertexHandler(VertexHandler vertex_handler);
+    /// Sets the handlers for receiving vertex outputs from vertex shader and the triangles
+    /// emitted by geometry shader
+    void SetVertexHandlers(VertexHandler vertex_handler, PrimitiveHandler primitive_handler);
 
     /// Setup the geometry shader unit if it is in use
     void Setup(ShaderEngine* shader_engine);
@@ -44,8 +45,16 @@ public:
     /// Submits vertex attributes output from vertex shader
     void SubmitVertex(const AttributeBuffer& input);
 
+    /// Sends the triangles emitted by geometry shader so far to the primitive handler
+    void Flush();
+
 private:
+    /// Amount of emitted triangles after which they are sent without waiting for the batch end
+    static constexpr std::size_t MAX_BATCHED_PRIMITIVES = 256;
+
     VertexHandler vertex_handler;
+    PrimitiveHandler primitive_handler;
+    std::vector<EmittedPrimitive> primitives;
     ShaderEngine* shader_engine;
     std::unique_ptr<GeometryPipelineBackend> backend;
     RegsInternal& regs;
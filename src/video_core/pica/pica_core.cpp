@@ -9,6 +9,7 @@
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/memory.h"
+#include "core/tracer/recorder.h"
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/pica/vertex_loader.h"
@@ -36,17 +37,28 @@ PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext>
       shader_engine{CreateEngine(Settings::values.use_shader_jit.GetValue())} {
     InitializeRegs();
 
-    const auto submit_vertex = [this](const AttributeBuffer& buffer) {
-        const auto add_triangle = [this](const OutputVertex& v0, const OutputVertex& v1,
-                                         const OutputVertex& v2) {
-            rasterizer->AddTriangle(v0, v1, v2);
-        };
+    const auto add_triangle = [this](const OutputVertex& v0, const OutputVertex& v1,
+                                     const OutputVertex& v2) {
+        rasterizer->AddTriangle(v0, v1, v2);
+    };
+    const auto submit_vertex = [this, add_triangle](const AttributeBuffer& buffer) {
         const auto vertex = OutputVertex(regs.internal.rasterizer, buffer);
         primitive_assembler.SubmitVertex(vertex, add_triangle);
     };
+    const auto submit_primitives = [this,
+                                    add_triangle](std::span<const EmittedPrimitive> primitives) {
+        for (const auto& primitive : primitives) {
+            if (primitive.winding) {
+                primitive_assembler.SetWinding();
+            }
+            for (const auto& buffer : primitive.vertices) {
+                const auto vertex = OutputVertex(regs.internal.rasterizer, buffer);
+                primitive_assembler.SubmitVertex(vertex, add_triangle);
+            }
+        }
+    };
 
-    gs_unit.SetVertexHandlers(submit_vertex, [this]() { primitive_assembler.SetWinding(); });
-    geometry_pipeline.SetVertexHandler(submit_vertex);
+    geometry_pipeline.SetVertexHandlers(submit_vertex, submit_primitives);
 
     primitive_assembler.Reconfigure(PipelineRegs::TriangleTopology::List);
 }
@@ -95,6 +107,10 @@ void PicaCore::SetInterruptHandler(Service::GSP::InterruptHandler& signal_interr
     this->signal_interrupt = signal_interrupt;
 }
 
+void PicaCore::SetShaderEngine(std::unique_ptr<ShaderEngine> engine) {
+    shader_engine = std::move(engine);
+}
+
 void PicaCore::ProcessCmdList(PAddr list, u32 size, bool ignore_list) {
     if (ignore_list) {
         signal_interrupt(Service::GSP::InterruptId::P3D);
@@ -514,6 +530,7 @@ void PicaCore::DrawImmediate() {
     ASSERT(!geometry_pipeline.NeedIndexInput());
     geometry_pipeline.Setup(shader_engine.get());
     geometry_pipeline.SubmitVertex(output);
+    geometry_pipeline.Flush();
 
     // Flush the immediate triangle.
     rasterizer->DrawTriangles();
@@ -530,6 +547,9 @@ void PicaCore::DrawArrays(bool is_indexed) {
     // Track vertex in the debug recorder.
     if (debug_context) {
         debug_context->OnEvent(DebugContext::Event::IncomingPrimitiveBatch, nullptr);
+        if (debug_context->recorder) {
+            RecordDrawMemory(is_indexed);
+        }
     }
 
     const bool accelerate_draw = [this] {
@@ -570,6 +590,65 @@ void PicaCore::DrawArrays(bool is_indexed) {
     }
 }
 
+void PicaCore::RecordDrawMemory(bool is_indexed) {
+    auto& recorder = *debug_context->recorder;
+    const auto record = [&](PAddr addr, u32 size) {
+        const u8* data = memory.GetPhysicalPointer(addr);
+        if (data && size != 0) {
+            recorder.MemoryAccessed(data, size, addr);
+        }
+    };
+
+    const auto& pipeline = regs.internal.pipeline;
+    const auto& attribute_config = pipeline.vertex_attributes;
+    const PAddr base_address = attribute_config.GetPhysicalBaseAddress();
+    if (pipeline.num_vertices == 0) {
+        return;
+    }
+
+    // Find the highest vertex referenced by the draw to know how much of each array is read.
+    u32 max_vertex = pipeline.vertex_offset + pipeline.num_vertices - 1;
+    if (is_indexed) {
+        const auto& index_info = pipeline.index_array;
+        const PAddr index_address = base_address + index_info.offset;
+        const bool index_u16 = index_info.format != 0;
+        const u32 index_size = pipeline.num_vertices * (index_u16 ? sizeof(u16) : sizeof(u8));
+        record(index_address, index_size);
+
+        const u8* index_data = memory.GetPhysicalPointer(index_address);
+        if (!index_data) {
+            return;
+        }
+        max_vertex = 0;
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            u16 vertex = index_data[index];
+            if (index_u16) {
+                std::memcpy(&vertex, index_data + index * sizeof(u16), sizeof(u16));
+            }
+            max_vertex = std::max<u32>(max_vertex, vertex);
+        }
+    }
+
+    for (const auto& loader : attribute_config.attribute_loaders) {
+        if (loader.component_count == 0) {
+            continue;
+        }
+        // Even arrays with a zero stride read the attributes of one vertex.
+        const u32 stride = std::max<u32>(loader.byte_count, 16);
+        record(base_address + loader.data_offset, loader.byte_count * max_vertex + stride);
+    }
+
+    // Only the first face of cube maps is recorded.
+    for (const auto& texture : regs.internal.texturing.GetTextures()) {
+        if (!texture.enabled) {
+            continue;
+        }
+        const u32 size = TexturingRegs::NibblesPerPixel(texture.format) * texture.config.width *
+                         texture.config.height / 2;
+        record(texture.config.GetPhysicalAddress(), size);
+    }
+}
+
 void PicaCore::LoadVertices(bool is_indexed) {
     // Read and validate vertex information from the loaders
     const auto& pipeline = regs.internal.pipeline;
@@ -625,7 +704,7 @@ void PicaCore::LoadVertices(bool is_indexed) {
         if (!vertex_cache_hit) {
             // Initialize data for the current vertex
             AttributeBuffer input;
-            loader.LoadVertex(base_address, index, vertex, input, input_default_attributes);
+            loader.LoadVertex(vertex, input, input_default_attributes);
 
             // Record vertex processing to the debugger.
             if (debug_context) {
@@ -650,6 +729,9 @@ void PicaCore::LoadVertices(bool is_indexed) {
         // Send to geometry pipeline
         geometry_pipeline.SubmitVertex(vs_output);
     }
+
+    // Send the triangles emitted by the geometry shader that are still batched.
+    geometry_pipeline.Flush();
 }
 
 PicaCore::RenderPropertiesGuess PicaCore::GuessCmdRenderProperties(PAddr list, u32 size) {
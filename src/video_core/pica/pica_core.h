@@ -40,6 +40,9 @@ public:
 
     void ProcessCmdList(PAddr list, u32 size, bool ignore_list);
 
+    /// Replaces the engine used to run vertex and geometry shaders.
+    void SetShaderEngine(std::unique_ptr<ShaderEngine> engine);
+
 private:
     void InitializeRegs();
 
@@ -53,6 +56,9 @@ private:
 
     void LoadVertices(bool is_indexed);
 
+    /// Records the vertex, index and texture data read by a draw to the active CiTrace.
+    void RecordDrawMemory(bool is_indexed);
+
 public:
     union Regs {
         static constexpr std::size_t NUM_REGS = 0x732;
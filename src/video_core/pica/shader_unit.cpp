@@ -37,12 +37,7 @@ void GeometryEmitter::Emit(std::span<Common::Vec4<f24>, 16> output_regs) {
     }
 
     if (prim_emit) {
-        if (winding) {
-            handlers->winding_setter();
-        }
-        for (std::size_t i = 0; i < buffer.size(); ++i) {
-            handlers->vertex_handler(buffer[i]);
-        }
+        primitives->push_back({buffer, winding});
     }
 }
 
@@ -50,11 +45,8 @@ GeometryShaderUnit::GeometryShaderUnit() : ShaderUnit{&emitter} {}
 
 GeometryShaderUnit::~GeometryShaderUnit() = default;
 
-void GeometryShaderUnit::SetVertexHandlers(VertexHandler vertex_handler,
-                                           WindingSetter winding_setter) {
-    emitter.handlers = new Handlers;
-    emitter.handlers->vertex_handler = vertex_handler;
-    emitter.handlers->winding_setter = winding_setter;
+void GeometryShaderUnit::SetPrimitiveBuffer(std::vector<EmittedPrimitive>* primitives) {
+    emitter.primitives = primitives;
 }
 
 void GeometryShaderUnit::ConfigOutput(const ShaderRegs& config) {
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <span>
+#include <vector>
 #include <boost/serialization/base_object.hpp>
 
 #include "video_core/pica/output_vertex.h"
@@ -15,8 +16,14 @@ namespace Pica {
 /// Handler type for receiving vertex outputs from vertex shader or geometry shader
 using VertexHandler = std::function<void(const AttributeBuffer&)>;
 
-/// Handler type for signaling to invert the vertex order of the next triangle
-using WindingSetter = std::function<void()>;
+/// A triangle emitted by a geometry shader
+struct EmittedPrimitive {
+    std::array<AttributeBuffer, 3> vertices;
+    bool winding; ///< Whether the vertex order of the triangle is inverted
+};
+
+/// Handler type for receiving a batch of triangles emitted by a geometry shader
+using PrimitiveHandler = std::function<void(std::span<const EmittedPrimitive>)>;
 
 struct ShaderRegs;
 struct GeometryEmitter;
@@ -65,11 +72,6 @@ private:
     }
 };
 
-struct Handlers {
-    VertexHandler vertex_handler;
-    WindingSetter winding_setter;
-};
-
 /// This structure contains state information for primitive emitting in geometry shader.
 struct GeometryEmitter {
     void Emit(std::span<Common::Vec4<f24>, 16> output_regs);
@@ -80,7 +82,7 @@ public:
     bool prim_emit;
     bool winding;
     u32 output_mask;
-    Handlers* handlers;
+    std::vector<EmittedPrimitive>* primitives; ///< Receives the emitted triangles
 
 private:
     friend class boost::serialization::access;
@@ -103,7 +105,8 @@ struct GeometryShaderUnit : public ShaderUnit {
     GeometryShaderUnit();
     ~GeometryShaderUnit();
 
-    void SetVertexHandlers(VertexHandler vertex_handler, WindingSetter winding_setter);
+    /// Sets the buffer the triangles emitted by the geometry shader are appended to.
+    void SetPrimitiveBuffer(std::vector<EmittedPrimitive>* primitives);
     void ConfigOutput(const ShaderRegs& config);
 
     GeometryEmitter emitter;
@@ -2,19 +2,57 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <limits>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "video_core/pica/vertex_loader.h"
 
 namespace Pica {
 
-VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& regs)
-    : memory{memory_} {
+namespace {
+
+using FetchFunc = void (*)(const u8* data, Common::Vec4<f24>& out);
+
+/**
+ * Converts an attribute of N elements of type T to f24. Missing elements are filled with the
+ * default values (0, 0, 0, 1), these are *not* carried over from the default attribute settings
+ * even if they're enabled for this attribute.
+ */
+template <typename T, u32 N>
+void FetchAttribute(const u8* data, Common::Vec4<f24>& out) {
+    std::array<T, N> values;
+    std::memcpy(values.data(), data, sizeof(values));
+
+    std::array<float, 4> result{0.f, 0.f, 0.f, 1.f};
+    for (u32 comp = 0; comp < N; ++comp) {
+        result[comp] = static_cast<float>(values[comp]);
+    }
+    out = Common::MakeVec(f24::FromFloat32(result[0]), f24::FromFloat32(result[1]),
+                          f24::FromFloat32(result[2]), f24::FromFloat32(result[3]));
+}
+
+template <typename T>
+constexpr std::array<FetchFunc, 4> MakeFetchFuncs() {
+    return {&FetchAttribute<T, 1>, &FetchAttribute<T, 2>, &FetchAttribute<T, 3>,
+            &FetchAttribute<T, 4>};
+}
+
+/// Fetch routines indexed by attribute format and number of elements minus one.
+constexpr std::array<std::array<FetchFunc, 4>, 4> FETCH_FUNCS = {
+    MakeFetchFuncs<s8>(),
+    MakeFetchFuncs<u8>(),
+    MakeFetchFuncs<s16>(),
+    MakeFetchFuncs<f32>(),
+};
+
+} // Anonymous namespace
+
+VertexLoader::VertexLoader(Memory::MemorySystem& memory, const PipelineRegs& regs) {
     const auto& attribute_config = regs.vertex_attributes;
+    const PAddr base_address = attribute_config.GetPhysicalBaseAddress();
     num_total_attributes = attribute_config.GetNumTotalAttributes();
 
-    vertex_attribute_sources.fill(0xdeadbeef);
-
     for (u32 i = 0; i < 16; i++) {
         vertex_attribute_is_default[i] = attribute_config.IsDefaultAttribute(i);
     }
@@ -38,14 +76,27 @@ VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& re
             if (attribute_index < 12) {
                 offset = Common::AlignUp(offset,
                                          attribute_config.GetElementSizeInBytes(attribute_index));
-                vertex_attribute_sources[attribute_index] = loader_config.data_offset + offset;
-                vertex_attribute_strides[attribute_index] =
-                    static_cast<u32>(loader_config.byte_count);
-                vertex_attribute_formats[attribute_index] =
-                    attribute_config.GetFormat(attribute_index);
-                vertex_attribute_elements[attribute_index] =
-                    attribute_config.GetNumElements(attribute_index);
-                offset += attribute_config.GetStride(attribute_index);
+
+                auto& attribute = attributes[attribute_index];
+                const auto format = attribute_config.GetFormat(attribute_index);
+                const u32 num_elements = attribute_config.GetNumElements(attribute_index);
+                const u32 size = attribute_config.GetStride(attribute_index);
+                attribute.stride = static_cast<u32>(loader_config.byte_count);
+                attribute.fetch = FETCH_FUNCS[static_cast<u32>(format)][num_elements - 1];
+
+                // Resolve the array once, so that loading a vertex is a plain pointer access.
+                const auto region =
+                    memory.GetPhysicalRef(base_address + loader_config.data_offset + offset);
+                if (region && region.GetSize() >= size) {
+                    attribute.data = region.GetPtr();
+                    attribute.max_vertex =
+                        attribute.stride == 0
+                            ? std::numeric_limits<u32>::max()
+                            : static_cast<u32>((region.GetSize() - size) / attribute.stride);
+                } else {
+                    attribute.data = nullptr;
+                }
+                offset += size;
             } else if (attribute_index < 16) {
                 // Attribute ids 12, 13, 14 and 15 signify 4, 8, 12 and 16-byte paddings,
                 // respectively
@@ -61,8 +112,8 @@ VertexLoader::VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& re
 
 VertexLoader::~VertexLoader() = default;
 
-void VertexLoader::LoadVertex(PAddr base_address, u32 index, u32 vertex, AttributeBuffer& input,
-                              AttributeBuffer& input_default_attributes) const {
+void VertexLoader::LoadVertex(u32 vertex, AttributeBuffer& input,
+                              const AttributeBuffer& input_default_attributes) const {
     for (s32 i = 0; i < num_total_attributes; ++i) {
         // Load the default attribute if we're configured to do so
         if (vertex_attribute_is_default[i]) {
@@ -73,36 +124,20 @@ void VertexLoader::LoadVertex(PAddr base_address, u32 index, u32 vertex, Attribu
         // TODO(yuriks): In this case, no data gets loaded and the vertex
         // remains with the last value it had. This isn't currently maintained
         // as global state, however, and so won't work in Citra yet.
-        if (vertex_attribute_elements[i] == 0) {
+        const auto& attribute = attributes[i];
+        if (!attribute.fetch) {
             LOG_ERROR(HW_GPU, "Vertex retension unimplemented");
             continue;
         }
 
-        // Load per-vertex data from the loader arrays
-        const PAddr source_addr =
-            base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
-
-        switch (vertex_attribute_formats[i]) {
-        case PipelineRegs::VertexAttributeFormat::BYTE:
-            LoadAttribute<s8>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::UBYTE:
-            LoadAttribute<u8>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::SHORT:
-            LoadAttribute<s16>(source_addr, i, input);
-            break;
-        case PipelineRegs::VertexAttributeFormat::FLOAT:
-            LoadAttribute<f32>(source_addr, i, input);
-            break;
+        if (!attribute.data || vertex > attribute.max_vertex) [[unlikely]] {
+            LOG_ERROR(HW_GPU, "Vertex {} of attribute {} is outside of memory", vertex, i);
+            input[i] = Common::MakeVec(f24::Zero(), f24::Zero(), f24::Zero(), f24::One());
+            continue;
         }
 
-        // Default attribute values set if array elements have < 4 components. This
-        // is *not* carried over from the default attribute settings even if they're
-        // enabled for this attribute.
-        for (u32 comp = vertex_attribute_elements[i]; comp < 4; comp++) {
-            input[i][comp] = comp == 3 ? f24::One() : f24::Zero();
-        }
+        // Load per-vertex data from the loader arrays
+        attribute.fetch(attribute.data + attribute.stride * vertex, input[i]);
     }
 }
 
@@ -14,32 +14,34 @@ class MemorySystem;
 
 namespace Pica {
 
+/**
+ * Loads the input attributes of vertices from the arrays configured in the pipeline registers.
+ * Host pointers and bounds of every attribute array are resolved once on construction, and each
+ * attribute is converted by a routine specialized for its format and number of elements.
+ */
 class VertexLoader {
 public:
-    explicit VertexLoader(Memory::MemorySystem& memory_, const PipelineRegs& regs);
+    explicit VertexLoader(Memory::MemorySystem& memory, const PipelineRegs& regs);
     ~VertexLoader();
 
-    void LoadVertex(PAddr base_address, u32 index, u32 vertex, AttributeBuffer& input,
-                    AttributeBuffer& input_default_attributes) const;
-
-    template <typename T>
-    void LoadAttribute(PAddr source_addr, u32 attrib, AttributeBuffer& out) const {
-        const T* data = reinterpret_cast<const T*>(memory.GetPhysicalPointer(source_addr));
-        for (u32 comp = 0; comp < vertex_attribute_elements[attrib]; ++comp) {
-            out[attrib][comp] = f24::FromFloat32(data[comp]);
-        }
-    }
+    void LoadVertex(u32 vertex, AttributeBuffer& input,
+                    const AttributeBuffer& input_default_attributes) const;
 
     int GetNumTotalAttributes() const {
         return num_total_attributes;
     }
 
 private:
-    Memory::MemorySystem& memory;
-    std::array<u32, 16> vertex_attribute_sources;
-    std::array<u32, 16> vertex_attribute_strides{};
-    std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
-    std::array<u32, 16> vertex_attribute_elements{};
+    using FetchFunc = void (*)(const u8* data, Common::Vec4<f24>& out);
+
+    struct Attribute {
+        const u8* data = nullptr; ///< Host pointer to the attribute of the first vertex
+        u32 stride = 0;
+        u32 max_vertex = 0; ///< Highest vertex that can be read without leaving the memory region
+        FetchFunc fetch = nullptr;
+    };
+
+    std::array<Attribute, 16> attributes{};
     std::array<bool, 16> vertex_attribute_is_default;
     int num_total_attributes = 0;
 };
@@ -63,6 +63,11 @@ public:
     /// This is called to notify the rendering backend of a surface change
     virtual void NotifySurfaceChanged() {}
 
+    /// Returns whether the rasterizer may be driven from a thread other than the emulation thread
+    virtual bool SupportsGPUThread() const {
+        return false;
+    }
+
     /// Returns the resolution scale factor relative to the native 3DS screen resolution
     u32 GetResolutionScaleFactor();
 
@@ -36,6 +36,10 @@ public:
     void SwapBuffers() override;
     void TryPresent(int timeout_ms, bool is_secondary) override {}
 
+    bool SupportsGPUThread() const override {
+        return true;
+    }
+
 private:
     void PrepareRenderTarget();
     void LoadFBToScreenInfo(int i, const Pica::ColorFill& color_fill);
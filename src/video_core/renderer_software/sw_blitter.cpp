@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <utility>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/vector_math.h"
@@ -13,24 +15,170 @@
 
 namespace SwRenderer {
 
-static Common::Vec4<u8> DecodePixel(Pica::PixelFormat input_format, const u8* src_pixel) {
-    switch (input_format) {
-    case Pica::PixelFormat::RGBA8:
+namespace {
+
+using Pica::PixelFormat;
+
+template <PixelFormat format>
+Common::Vec4<u8> DecodePixel(const u8* src_pixel) {
+    if constexpr (format == PixelFormat::RGBA8) {
         return Common::Color::DecodeRGBA8(src_pixel);
-    case Pica::PixelFormat::RGB8:
+    } else if constexpr (format == PixelFormat::RGB8) {
         return Common::Color::DecodeRGB8(src_pixel);
-    case Pica::PixelFormat::RGB565:
+    } else if constexpr (format == PixelFormat::RGB565) {
         return Common::Color::DecodeRGB565(src_pixel);
-    case Pica::PixelFormat::RGB5A1:
+    } else if constexpr (format == PixelFormat::RGB5A1) {
         return Common::Color::DecodeRGB5A1(src_pixel);
-    case Pica::PixelFormat::RGBA4:
+    } else {
         return Common::Color::DecodeRGBA4(src_pixel);
-    default:
-        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}", input_format);
-        return {0, 0, 0, 0};
     }
 }
 
+template <PixelFormat format>
+void EncodePixel(const Common::Vec4<u8>& color, u8* dst_pixel) {
+    if constexpr (format == PixelFormat::RGBA8) {
+        Common::Color::EncodeRGBA8(color, dst_pixel);
+    } else if constexpr (format == PixelFormat::RGB8) {
+        Common::Color::EncodeRGB8(color, dst_pixel);
+    } else if constexpr (format == PixelFormat::RGB565) {
+        Common::Color::EncodeRGB565(color, dst_pixel);
+    } else if constexpr (format == PixelFormat::RGB5A1) {
+        Common::Color::EncodeRGB5A1(color, dst_pixel);
+    } else {
+        Common::Color::EncodeRGBA4(color, dst_pixel);
+    }
+}
+
+constexpr u32 NUM_PIXEL_FORMATS = 5;
+
+/**
+ * Describes where the rows and columns of a transfer surface are. Column offsets are
+ * precomputed once per transfer; tiled surfaces have a set of them for each of the 8 rows of a
+ * tile, as the Morton order only depends on the position within the tile.
+ */
+struct SurfaceLayout {
+    const u32* columns;
+    u32 width;
+    u32 row_size;
+    bool tiled;
+
+    u32 RowOffset(u32 y) const {
+        return tiled ? (y & ~7) * row_size : y * row_size;
+    }
+
+    const u32* RowColumns(u32 y) const {
+        return tiled ? columns + (y & 7) * width : columns;
+    }
+};
+
+/**
+ * Computes the offsets of the columns of a surface, column x being at x << scale. With scaling,
+ * the pixels averaged into an output pixel follow the one at the column offset, since they are
+ * consecutive in tiled surfaces.
+ */
+void BuildColumns(std::vector<u32>& columns, u32 width, u32 scale, u32 bytes_per_pixel,
+                  bool tiled) {
+    const u32 rows = tiled ? 8 : 1;
+    columns.resize(rows * width);
+    for (u32 row = 0; row < rows; ++row) {
+        for (u32 x = 0; x < width; ++x) {
+            const u32 pixel_x = x << scale;
+            columns[row * width + x] =
+                tiled ? ((pixel_x & ~7) * 8 + VideoCore::MortonInterleave(pixel_x, row)) *
+                            bytes_per_pixel
+                      : pixel_x * bytes_per_pixel;
+        }
+    }
+}
+
+using TransferFunc = void (*)(const u8* src, const SurfaceLayout& src_layout, u8* dst,
+                              const SurfaceLayout& dst_layout, u32 width, u32 height,
+                              u32 vertical_scale, bool flip_vertically);
+
+/**
+ * Converts the rows of a display transfer between the given formats, averaging the group of
+ * input pixels (1, 2 or 4) that makes up each output pixel.
+ */
+template <PixelFormat input_format, PixelFormat output_format, u32 group>
+void TransferRows(const u8* src, const SurfaceLayout& src_layout, u8* dst,
+                  const SurfaceLayout& dst_layout, u32 width, u32 height, u32 vertical_scale,
+                  bool flip_vertically) {
+    constexpr u32 src_bytes_per_pixel = Pica::BytesPerPixel(input_format);
+    constexpr u32 dst_bytes_per_pixel = Pica::BytesPerPixel(output_format);
+
+    for (u32 y = 0; y < height; ++y) {
+        // Flip the y value of the output data after calculating the position of the input row,
+        // to account for the scaling options.
+        const u32 input_y = y << vertical_scale;
+        const u32 output_y = flip_vertically ? height - y - 1 : y;
+
+        const u8* src_row = src + src_layout.RowOffset(input_y);
+        const u32* src_columns = src_layout.RowColumns(input_y);
+        u8* dst_row = dst + dst_layout.RowOffset(output_y);
+        const u32* dst_columns = dst_layout.RowColumns(output_y);
+
+        for (u32 x = 0; x < width; ++x) {
+            const u8* src_pixel = src_row + src_columns[x];
+            u8* dst_pixel = dst_row + dst_columns[x];
+
+            if constexpr (input_format == output_format && group == 1) {
+                // Decoding and encoding to the same format doesn't change the pixel.
+                std::memcpy(dst_pixel, src_pixel, dst_bytes_per_pixel);
+            } else if constexpr (group == 1) {
+                EncodePixel<output_format>(DecodePixel<input_format>(src_pixel), dst_pixel);
+            } else if constexpr (group == 2) {
+                const auto pixel0 = DecodePixel<input_format>(src_pixel);
+                const auto pixel1 = DecodePixel<input_format>(src_pixel + src_bytes_per_pixel);
+                EncodePixel<output_format>(((pixel0 + pixel1) / 2).template Cast<u8>(),
+                                           dst_pixel);
+            } else {
+                const auto pixel0 = DecodePixel<input_format>(src_pixel);
+                const auto pixel1 = DecodePixel<input_format>(src_pixel + src_bytes_per_pixel);
+                const auto pixel2 =
+                    DecodePixel<input_format>(src_pixel + 2 * src_bytes_per_pixel);
+                const auto pixel3 =
+                    DecodePixel<input_format>(src_pixel + 3 * src_bytes_per_pixel);
+                EncodePixel<output_format>(
+                    (((pixel0 + pixel1) + (pixel2 + pixel3)) / 4).template Cast<u8>(), dst_pixel);
+            }
+        }
+    }
+}
+
+template <std::size_t... I>
+constexpr auto MakeTransferTable(std::index_sequence<I...>) {
+    constexpr auto make = [](auto i) -> TransferFunc {
+        constexpr u32 index = decltype(i)::value;
+        constexpr auto input_format =
+            static_cast<PixelFormat>(index / NUM_PIXEL_FORMATS % NUM_PIXEL_FORMATS);
+        constexpr auto output_format = static_cast<PixelFormat>(index % NUM_PIXEL_FORMATS);
+        constexpr u32 group = 1 << (index / (NUM_PIXEL_FORMATS * NUM_PIXEL_FORMATS));
+        return &TransferRows<input_format, output_format, group>;
+    };
+    return std::array{make(std::integral_constant<u32, I>{})...};
+}
+
+/// Kernels indexed by [scaling][input format][output format].
+constexpr auto TRANSFER_FUNCS =
+    MakeTransferTable(std::make_index_sequence<3 * NUM_PIXEL_FORMATS * NUM_PIXEL_FORMATS>{});
+
+/**
+ * Fills size bytes at dst with a repeating pattern. The pattern is written once and then the
+ * filled region is copied over itself with doubling sizes, so most of the work is done by large
+ * memcpy calls.
+ */
+void FillPattern(u8* dst, std::size_t size, const u8* pattern, std::size_t pattern_size) {
+    std::size_t filled = std::min(size, pattern_size);
+    std::memcpy(dst, pattern, filled);
+    while (filled < size) {
+        const std::size_t copy_size = std::min(filled, size - filled);
+        std::memcpy(dst + filled, dst, copy_size);
+        filled += copy_size;
+    }
+}
+
+} // Anonymous namespace
+
 SwBlitter::SwBlitter(Memory::MemorySystem& memory_, VideoCore::RasterizerInterface* rasterizer_)
     : memory{memory_}, rasterizer{rasterizer_} {}
 
@@ -152,11 +300,27 @@ void SwBlitter::DisplayTransfer(const Pica::DisplayTransferConfig& config) {
         return;
     }
 
+    const auto input_format = config.input_format.Value();
+    const auto output_format = config.output_format.Value();
+    // The transfer is skipped for formats the hardware does not define, as their pixel size is
+    // unknown and the source and destination regions can't be computed.
+    if (static_cast<u32>(input_format) >= NUM_PIXEL_FORMATS) {
+        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}",
+                  static_cast<u32>(input_format));
+        return;
+    }
+
+    if (static_cast<u32>(output_format) >= NUM_PIXEL_FORMATS) {
+        LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
+                  static_cast<u32>(output_format));
+        return;
+    }
+
     // Using flip_vertically alongside crop_input_lines produces skewed output on hardware.
     // We have to emulate this because some games rely on this behaviour to render correctly.
     if (config.flip_vertically && config.crop_input_lines) {
         dst_addr += (config.input_width - config.output_width) * (config.output_height - 1) *
-                    BytesPerPixel(config.output_format);
+                    BytesPerPixel(output_format);
     }
 
     u8* src_pointer = memory.GetPhysicalPointer(src_addr);
@@ -181,115 +345,34 @@ void SwBlitter::DisplayTransfer(const Pica::DisplayTransferConfig& config) {
     const u32 output_width = config.output_width >> horizontal_scale;
     const u32 output_height = config.output_height >> vertical_scale;
 
-    const u32 input_size =
-        config.input_width * config.input_height * BytesPerPixel(config.input_format);
-    const u32 output_size = output_width * output_height * BytesPerPixel(config.output_format);
+    const u32 src_bytes_per_pixel = BytesPerPixel(input_format);
+    const u32 dst_bytes_per_pixel = BytesPerPixel(output_format);
+    const u32 input_size = config.input_width * config.input_height * src_bytes_per_pixel;
+    const u32 output_size = output_width * output_height * dst_bytes_per_pixel;
 
     rasterizer->FlushRegion(config.GetPhysicalInputAddress(), input_size);
     rasterizer->InvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
-    for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Common::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            const u32 input_x = x << horizontal_scale;
-            const u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
-            } else {
-                output_y = y;
-            }
-
-            const u32 dst_bytes_per_pixel = BytesPerPixel(config.output_format);
-            const u32 src_bytes_per_pixel = BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
-                } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    const u32 coarse_y = input_y & ~7;
-                    const u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    const u32 out_coarse_y = output_y & ~7;
-                    const u32 out_stride = output_width * dst_bytes_per_pixel;
-
-                    const u32 in_coarse_y = input_y & ~7;
-                    const u32 in_stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
-                }
-            }
-
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
-            if (config.scaling == config.ScaleX) {
-                const auto pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
-            } else if (config.scaling == config.ScaleXY) {
-                const auto pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                const auto pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                const auto pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
-            }
-
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Pica::PixelFormat::RGBA8:
-                Common::Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB8:
-                Common::Color::EncodeRGB8(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB565:
-                Common::Color::EncodeRGB565(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB5A1:
-                Common::Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGBA4:
-                Common::Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
-            }
-        }
-    }
+    // With linear input the output is tiled and vice versa, unless swizzling is disabled in which
+    // case both sides keep the same layout.
+    const bool input_tiled = !config.input_linear;
+    const bool output_tiled = config.input_linear != config.dont_swizzle;
+
+    BuildColumns(src_columns, output_width, horizontal_scale, src_bytes_per_pixel, input_tiled);
+    BuildColumns(dst_columns, output_width, 0, dst_bytes_per_pixel, output_tiled);
+
+    const SurfaceLayout src_layout{src_columns.data(), output_width,
+                                   config.input_width * src_bytes_per_pixel, input_tiled};
+    const SurfaceLayout dst_layout{dst_columns.data(), output_width,
+                                   output_width * dst_bytes_per_pixel, output_tiled};
+
+    const u32 scale_index = horizontal_scale + vertical_scale;
+    const auto transfer =
+        TRANSFER_FUNCS[(scale_index * NUM_PIXEL_FORMATS + static_cast<u32>(input_format)) *
+                           NUM_PIXEL_FORMATS +
+                       static_cast<u32>(output_format)];
+    transfer(src_pointer, src_layout, dst_pointer, dst_layout, output_width, output_height,
+             vertical_scale, config.flip_vertically);
 }
 
 void SwBlitter::MemoryFill(const Pica::MemoryFillConfig& config) {
@@ -318,28 +401,23 @@ void SwBlitter::MemoryFill(const Pica::MemoryFillConfig& config) {
 
     rasterizer->InvalidateRegion(start_addr, end_addr - start_addr);
 
+    const std::size_t size = end - start;
     if (config.fill_24bit) {
-        // Fill with 24-bit values
-        for (u8* ptr = start; ptr < end; ptr += 3) {
-            ptr[0] = config.value_24bit_r;
-            ptr[1] = config.value_24bit_g;
-            ptr[2] = config.value_24bit_b;
-        }
+        // Fill with 24-bit values, the last value is written whole even if it crosses the end
+        const std::array<u8, 3> value = {static_cast<u8>(config.value_24bit_r),
+                                         static_cast<u8>(config.value_24bit_g),
+                                         static_cast<u8>(config.value_24bit_b)};
+        FillPattern(start, Common::AlignUp(size, 3), value.data(), value.size());
     } else if (config.fill_32bit) {
         // Fill with 32-bit values
-        if (end > start) {
-            const u32 value = config.value_32bit;
-            const std::size_t len = (end - start) / sizeof(u32);
-            for (std::size_t i = 0; i < len; ++i) {
-                std::memcpy(&start[i * sizeof(u32)], &value, sizeof(u32));
-            }
-        }
+        const u32 value = config.value_32bit;
+        FillPattern(start, Common::AlignDown(size, sizeof(u32)),
+                    reinterpret_cast<const u8*>(&value), sizeof(u32));
     } else {
         // Fill with 16-bit values
         const u16 value_16bit = config.value_16bit.Value();
-        for (u8* ptr = start; ptr < end; ptr += sizeof(u16)) {
-            std::memcpy(ptr, &value_16bit, sizeof(u16));
-        }
+        FillPattern(start, Common::AlignUp(size, sizeof(u16)),
+                    reinterpret_cast<const u8*>(&value_16bit), sizeof(u16));
     }
 }
 
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <vector>
+#include "common/common_types.h"
+
 namespace Pica {
 struct DisplayTransferConfig;
 struct MemoryFillConfig;
@@ -33,6 +36,8 @@ public:
 private:
     Memory::MemorySystem& memory;
     VideoCore::RasterizerInterface* rasterizer;
+    std::vector<u32> src_columns;
+    std::vector<u32> dst_columns;
 };
 
 } // namespace SwRenderer
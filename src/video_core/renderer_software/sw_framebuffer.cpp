@@ -42,189 +42,93 @@ Framebuffer::Framebuffer(Memory::MemorySystem& memory_, const Pica::FramebufferR
 Framebuffer::~Framebuffer() = default;
 
 void Framebuffer::Bind() {
-    PAddr addr = regs.framebuffer.GetColorBufferPhysicalAddress();
+    const auto& framebuffer = regs.framebuffer;
+    PAddr addr = framebuffer.GetColorBufferPhysicalAddress();
     if (color_addr != addr) [[unlikely]] {
         color_addr = addr;
         color_buffer = memory.GetPhysicalPointer(color_addr);
     }
 
-    addr = regs.framebuffer.GetDepthBufferPhysicalAddress();
+    addr = framebuffer.GetDepthBufferPhysicalAddress();
     if (depth_addr != addr) [[unlikely]] {
         depth_addr = addr;
         depth_buffer = memory.GetPhysicalPointer(depth_addr);
     }
-}
-
-void Framebuffer::DrawPixel(u32 x, u32 y, const Common::Vec4<u8>& color) const {
-    const auto& framebuffer = regs.framebuffer;
-    // Similarly to textures, the render framebuffer is laid out from bottom to top, too.
-    // NOTE: The framebuffer height register contains the actual FB height minus one.
-    y = framebuffer.height - y;
 
-    const u32 coarse_y = y & ~7;
-    const u32 bytes_per_pixel =
-        Pica::BytesPerPixel(Pica::PixelFormat(framebuffer.color_format.Value()));
-    const u32 dst_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) +
-                           coarse_y * framebuffer.width * bytes_per_pixel;
-    u8* dst_pixel = color_buffer + dst_offset;
+    height = framebuffer.height;
+    BindColorFormat(framebuffer.color_format);
+    BindDepthFormat(framebuffer.depth_format);
+    color_stride = framebuffer.width * color_bytes_per_pixel;
+    depth_stride = framebuffer.width * depth_bytes_per_pixel;
+}
 
-    switch (framebuffer.color_format) {
+void Framebuffer::BindColorFormat(FramebufferRegs::ColorFormat format) {
+    switch (format) {
     case FramebufferRegs::ColorFormat::RGBA8:
-        Common::Color::EncodeRGBA8(color, dst_pixel);
+        decode_color = &Common::Color::DecodeRGBA8;
+        encode_color = &Common::Color::EncodeRGBA8;
         break;
     case FramebufferRegs::ColorFormat::RGB8:
-        Common::Color::EncodeRGB8(color, dst_pixel);
+        decode_color = &Common::Color::DecodeRGB8;
+        encode_color = &Common::Color::EncodeRGB8;
         break;
     case FramebufferRegs::ColorFormat::RGB5A1:
-        Common::Color::EncodeRGB5A1(color, dst_pixel);
+        decode_color = &Common::Color::DecodeRGB5A1;
+        encode_color = &Common::Color::EncodeRGB5A1;
         break;
     case FramebufferRegs::ColorFormat::RGB565:
-        Common::Color::EncodeRGB565(color, dst_pixel);
+        decode_color = &Common::Color::DecodeRGB565;
+        encode_color = &Common::Color::EncodeRGB565;
         break;
     case FramebufferRegs::ColorFormat::RGBA4:
-        Common::Color::EncodeRGBA4(color, dst_pixel);
+        decode_color = &Common::Color::DecodeRGBA4;
+        encode_color = &Common::Color::EncodeRGBA4;
         break;
     default:
         LOG_CRITICAL(Render_Software, "Unknown framebuffer color format {:x}",
-                     static_cast<u32>(framebuffer.color_format.Value()));
-        UNIMPLEMENTED();
-    }
-}
-
-const Common::Vec4<u8> Framebuffer::GetPixel(u32 x, u32 y) const {
-    const auto& framebuffer = regs.framebuffer;
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    const u32 bytes_per_pixel =
-        Pica::BytesPerPixel(Pica::PixelFormat(framebuffer.color_format.Value()));
-    const u32 src_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) +
-                           coarse_y * framebuffer.width * bytes_per_pixel;
-    const u8* src_pixel = color_buffer + src_offset;
-
-    switch (framebuffer.color_format) {
-    case FramebufferRegs::ColorFormat::RGBA8:
-        return Common::Color::DecodeRGBA8(src_pixel);
-    case FramebufferRegs::ColorFormat::RGB8:
-        return Common::Color::DecodeRGB8(src_pixel);
-    case FramebufferRegs::ColorFormat::RGB5A1:
-        return Common::Color::DecodeRGB5A1(src_pixel);
-    case FramebufferRegs::ColorFormat::RGB565:
-        return Common::Color::DecodeRGB565(src_pixel);
-    case FramebufferRegs::ColorFormat::RGBA4:
-        return Common::Color::DecodeRGBA4(src_pixel);
-    default:
-        LOG_CRITICAL(Render_Software, "Unknown framebuffer color format {:x}",
-                     static_cast<u32>(framebuffer.color_format.Value()));
-        UNIMPLEMENTED();
-    }
-
-    return {0, 0, 0, 0};
-}
-
-u32 Framebuffer::GetDepth(u32 x, u32 y) const {
-    const auto& framebuffer = regs.framebuffer;
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    const u32 bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    const u32 stride = framebuffer.width * bytes_per_pixel;
-
-    const u32 src_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    const u8* src_pixel = depth_buffer + src_offset;
-
-    switch (framebuffer.depth_format) {
-    case FramebufferRegs::DepthFormat::D16:
-        return Common::Color::DecodeD16(src_pixel);
-    case FramebufferRegs::DepthFormat::D24:
-        return Common::Color::DecodeD24(src_pixel);
-    case FramebufferRegs::DepthFormat::D24S8:
-        return Common::Color::DecodeD24S8(src_pixel).x;
-    default:
-        LOG_CRITICAL(HW_GPU, "Unimplemented depth format {}",
-                     static_cast<u32>(framebuffer.depth_format.Value()));
+                     static_cast<u32>(format));
         UNIMPLEMENTED();
-        return 0;
-    }
-}
-
-u8 Framebuffer::GetStencil(u32 x, u32 y) const {
-    const auto& framebuffer = regs.framebuffer;
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    const u32 bytes_per_pixel = Pica::FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    const u32 stride = framebuffer.width * bytes_per_pixel;
-
-    const u32 src_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    const u8* src_pixel = depth_buffer + src_offset;
-
-    switch (framebuffer.depth_format) {
-    case FramebufferRegs::DepthFormat::D24S8:
-        return Common::Color::DecodeD24S8(src_pixel).y;
-    default:
-        LOG_WARNING(
-            HW_GPU,
-            "GetStencil called for function which doesn't have a stencil component (format {})",
-            static_cast<u32>(framebuffer.depth_format.Value()));
-        return 0;
+        decode_color = [](const u8*) -> Common::Vec4<u8> { return {0, 0, 0, 0}; };
+        encode_color = [](const Common::Vec4<u8>&, u8*) {};
+        color_bytes_per_pixel = 0;
+        return;
     }
+    color_bytes_per_pixel = FramebufferRegs::BytesPerColorPixel(format);
 }
 
-void Framebuffer::SetDepth(u32 x, u32 y, u32 value) const {
-    const auto& framebuffer = regs.framebuffer;
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    const u32 bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    const u32 stride = framebuffer.width * bytes_per_pixel;
-
-    const u32 dst_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    u8* dst_pixel = depth_buffer + dst_offset;
-
-    switch (framebuffer.depth_format) {
+void Framebuffer::BindDepthFormat(FramebufferRegs::DepthFormat format) {
+    switch (format) {
     case FramebufferRegs::DepthFormat::D16:
-        Common::Color::EncodeD16(value, dst_pixel);
+        decode_depth = &Common::Color::DecodeD16;
+        encode_depth = &Common::Color::EncodeD16;
+        decode_stencil = [](const u8*) -> u8 { return 0; };
+        encode_stencil = [](u8, u8*) {};
         break;
     case FramebufferRegs::DepthFormat::D24:
-        Common::Color::EncodeD24(value, dst_pixel);
+        decode_depth = &Common::Color::DecodeD24;
+        encode_depth = &Common::Color::EncodeD24;
+        decode_stencil = [](const u8*) -> u8 { return 0; };
+        encode_stencil = [](u8, u8*) {};
         break;
     case FramebufferRegs::DepthFormat::D24S8:
-        Common::Color::EncodeD24X8(value, dst_pixel);
-        break;
-    default:
-        LOG_CRITICAL(HW_GPU, "Unimplemented depth format {}",
-                     static_cast<u32>(framebuffer.depth_format.Value()));
-        UNIMPLEMENTED();
-        break;
-    }
-}
-
-void Framebuffer::SetStencil(u32 x, u32 y, u8 value) const {
-    const auto& framebuffer = regs.framebuffer;
-    y = framebuffer.height - y;
-
-    const u32 coarse_y = y & ~7;
-    const u32 bytes_per_pixel = Pica::FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
-    const u32 stride = framebuffer.width * bytes_per_pixel;
-
-    const u32 dst_offset = VideoCore::GetMortonOffset(x, y, bytes_per_pixel) + coarse_y * stride;
-    u8* dst_pixel = depth_buffer + dst_offset;
-
-    switch (framebuffer.depth_format) {
-    case Pica::FramebufferRegs::DepthFormat::D16:
-    case Pica::FramebufferRegs::DepthFormat::D24:
-        // Nothing to do
-        break;
-    case Pica::FramebufferRegs::DepthFormat::D24S8:
-        Common::Color::EncodeX24S8(value, dst_pixel);
+        decode_depth = [](const u8* bytes) { return Common::Color::DecodeD24S8(bytes).x; };
+        encode_depth = &Common::Color::EncodeD24X8;
+        decode_stencil = [](const u8* bytes) {
+            return static_cast<u8>(Common::Color::DecodeD24S8(bytes).y);
+        };
+        encode_stencil = &Common::Color::EncodeX24S8;
         break;
     default:
-        LOG_CRITICAL(HW_GPU, "Unimplemented depth format {}",
-                     static_cast<u32>(framebuffer.depth_format.Value()));
+        LOG_CRITICAL(HW_GPU, "Unimplemented depth format {}", static_cast<u32>(format));
         UNIMPLEMENTED();
-        break;
+        decode_depth = [](const u8*) -> u32 { return 0; };
+        encode_depth = [](u32, u8*) {};
+        decode_stencil = [](const u8*) -> u8 { return 0; };
+        encode_stencil = [](u8, u8*) {};
+        depth_bytes_per_pixel = 0;
+        return;
     }
+    depth_bytes_per_pixel = FramebufferRegs::BytesPerDepthPixel(format);
 }
 
 void Framebuffer::DrawShadowMapPixel(u32 x, u32 y, u32 depth, u8 stencil) const {
@@ -7,6 +7,7 @@
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica/regs_framebuffer.h"
+#include "video_core/utils.h"
 
 namespace Memory {
 class MemorySystem;
@@ -20,40 +21,106 @@ namespace SwRenderer {
 
 class Framebuffer {
 public:
+    /// Row of the color and depth buffers, resolved once to locate the pixels within it.
+    struct Span {
+        u8* color;
+        u8* depth;
+        u32 y;
+    };
+
+    /// Location of a pixel in the color and depth buffers.
+    struct Pixel {
+        u8* color;
+        u8* depth;
+    };
+
     explicit Framebuffer(Memory::MemorySystem& memory, const Pica::FramebufferRegs& framebuffer);
     ~Framebuffer();
 
-    /// Updates the framebuffer addresses from the PICA registers.
+    /// Updates the framebuffer addresses and formats from the PICA registers.
     void Bind();
 
-    /// Draws a pixel at the specified coordinates.
-    void DrawPixel(u32 x, u32 y, const Common::Vec4<u8>& color) const;
-
-    /// Returns the current color at the specified coordinates.
-    [[nodiscard]] const Common::Vec4<u8> GetPixel(u32 x, u32 y) const;
-
-    /// Returns the depth value at the specified coordinates.
-    [[nodiscard]] u32 GetDepth(u32 x, u32 y) const;
-
-    /// Returns the stencil value at the specified coordinates.
-    [[nodiscard]] u8 GetStencil(u32 x, u32 y) const;
-
-    /// Stores the provided depth value at the specified coordinates.
-    void SetDepth(u32 x, u32 y, u32 value) const;
-
-    /// Stores the provided stencil value at the specified coordinates.
-    void SetStencil(u32 x, u32 y, u8 value) const;
+    /// Returns the row of the framebuffer at the specified y coordinate.
+    [[nodiscard]] Span GetSpan(u32 y) const {
+        // Similarly to textures, the render framebuffer is laid out from bottom to top, too.
+        // NOTE: The framebuffer height register contains the actual FB height minus one.
+        y = height - y;
+        const u32 coarse_y = y & ~7;
+        return {color_buffer + coarse_y * color_stride, depth_buffer + coarse_y * depth_stride,
+                y};
+    }
+
+    /// Returns the location of the pixel at the specified x coordinate of a row.
+    [[nodiscard]] Pixel Locate(const Span& span, u32 x) const {
+        const u32 index = (x & ~7) * 8 + VideoCore::MortonInterleave(x, span.y);
+        return {span.color + index * color_bytes_per_pixel,
+                span.depth + index * depth_bytes_per_pixel};
+    }
+
+    /// Draws a pixel at the specified location.
+    void DrawPixel(const Pixel& pixel, const Common::Vec4<u8>& color) const {
+        encode_color(color, pixel.color);
+    }
+
+    /// Returns the current color at the specified location.
+    [[nodiscard]] Common::Vec4<u8> GetPixel(const Pixel& pixel) const {
+        return decode_color(pixel.color);
+    }
+
+    /// Returns the depth value at the specified location.
+    [[nodiscard]] u32 GetDepth(const Pixel& pixel) const {
+        return decode_depth(pixel.depth);
+    }
+
+    /// Returns the stencil value at the specified location.
+    [[nodiscard]] u8 GetStencil(const Pixel& pixel) const {
+        return decode_stencil(pixel.depth);
+    }
+
+    /// Stores the provided depth value at the specified location.
+    void SetDepth(const Pixel& pixel, u32 value) const {
+        encode_depth(value, pixel.depth);
+    }
+
+    /// Stores the provided stencil value at the specified location.
+    void SetStencil(const Pixel& pixel, u8 value) const {
+        encode_stencil(value, pixel.depth);
+    }
 
     /// Draws a pixel to the shadow buffer.
     void DrawShadowMapPixel(u32 x, u32 y, u32 depth, u8 stencil) const;
 
 private:
+    using DecodeColorFunc = Common::Vec4<u8> (*)(const u8* bytes);
+    using EncodeColorFunc = void (*)(const Common::Vec4<u8>& color, u8* bytes);
+    using DecodeDepthFunc = u32 (*)(const u8* bytes);
+    using EncodeDepthFunc = void (*)(u32 value, u8* bytes);
+    using DecodeStencilFunc = u8 (*)(const u8* bytes);
+    using EncodeStencilFunc = void (*)(u8 value, u8* bytes);
+
+    /// Selects the routines accessing the color buffer in the given format.
+    void BindColorFormat(Pica::FramebufferRegs::ColorFormat format);
+
+    /// Selects the routines accessing the depth buffer in the given format.
+    void BindDepthFormat(Pica::FramebufferRegs::DepthFormat format);
+
     Memory::MemorySystem& memory;
     const Pica::FramebufferRegs& regs;
     PAddr color_addr;
     u8* color_buffer{};
     PAddr depth_addr;
     u8* depth_buffer{};
+    u32 height{};
+    u32 color_bytes_per_pixel{};
+    u32 color_stride{};
+    u32 depth_bytes_per_pixel{};
+    u32 depth_stride{};
+    DecodeColorFunc decode_color{};
+    EncodeColorFunc encode_color{};
+    DecodeDepthFunc decode_depth{};
+    EncodeDepthFunc encode_depth{};
+    DecodeStencilFunc decode_stencil{};
+    EncodeStencilFunc encode_stencil{};
 };
 
 u8 PerformStencilAction(Pica::FramebufferRegs::StencilAction action, u8 old_stencil, u8 ref);
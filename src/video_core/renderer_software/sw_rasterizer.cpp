@@ -14,6 +14,7 @@
 #include "video_core/renderer_software/sw_lighting.h"
 #include "video_core/renderer_software/sw_proctex.h"
 #include "video_core/renderer_software/sw_rasterizer.h"
+#include "video_core/renderer_software/sw_tev.h"
 #include "video_core/renderer_software/sw_texturing.h"
 #include "video_core/texture/texture_decode.h"
 
@@ -296,7 +297,7 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     const auto w_inverse = Common::MakeVec(v0.pos.w, v1.pos.w, v2.pos.w);
 
     const auto textures = regs.texturing.GetTextures();
-    const auto tev_stages = regs.texturing.GetTevStages();
+    tev_program.Configure(regs.texturing);
 
     fb.Bind();
 
@@ -304,6 +305,7 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     // TODO: Not sure if looping through x first might be faster
     for (u16 y = min_y + 8; y < max_y; y += 0x10) {
         const auto process_scanline = [&, y] {
+            const auto span = fb.GetSpan(y >> 4);
             for (u16 x = min_x + 8; x < max_x; x += 0x10) {
                 // Do not process the pixel if it's inside the scissor box and the scissor mode is
                 // set to Exclude.
@@ -437,9 +439,9 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
                 }
 
                 // Write the TEV stages.
-                auto combiner_output =
-                    WriteTevConfig(texture_color, tev_stages, primary_color, primary_fragment_color,
-                                   secondary_fragment_color);
+                auto combiner_output = tev_program.Run(texture_color, primary_color,
+                                                       primary_fragment_color,
+                                                       secondary_fragment_color);
 
                 const auto& output_merger = regs.framebuffer.output_merger;
                 if (output_merger.fragment_operation_mode ==
@@ -457,12 +459,13 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
                     continue;
                 }
                 WriteFog(depth, combiner_output);
-                if (!DoDepthStencilTest(x, y, depth)) {
+                const auto pixel = fb.Locate(span, x >> 4);
+                if (!DoDepthStencilTest(pixel, depth)) {
                     continue;
                 }
-                const auto result = PixelColor(x, y, combiner_output);
+                const auto result = PixelColor(pixel, combiner_output);
                 if (regs.framebuffer.framebuffer.allow_color_write != 0) {
-                    fb.DrawPixel(x >> 4, y >> 4, result);
+                    fb.DrawPixel(pixel, result);
                 }
             }
         };
@@ -591,9 +594,9 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
     return texture_color;
 }
 
-Common::Vec4<u8> RasterizerSoftware::PixelColor(u16 x, u16 y,
+Common::Vec4<u8> RasterizerSoftware::PixelColor(const Framebuffer::Pixel& pixel,
                                                 Common::Vec4<u8> combiner_output) const {
-    const auto dest = fb.GetPixel(x >> 4, y >> 4);
+    const auto dest = fb.GetPixel(pixel);
     Common::Vec4<u8> blend_output = combiner_output;
 
     const auto& output_merger = regs.framebuffer.output_merger;
@@ -682,120 +685,6 @@ Common::Vec4<u8> RasterizerSoftware::PixelColor(u16 x, u16 y,
     return result;
 }
 
-Common::Vec4<u8> RasterizerSoftware::WriteTevConfig(
-    std::span<const Common::Vec4<u8>, 4> texture_color,
-    std::span<const Pica::TexturingRegs::TevStageConfig, 6> tev_stages,
-    Common::Vec4<u8> primary_color, Common::Vec4<u8> primary_fragment_color,
-    Common::Vec4<u8> secondary_fragment_color) {
-    /**
-     * Texture environment - consists of 6 stages of color and alpha combining.
-     * Color combiners take three input color values from some source (e.g. interpolated
-     * vertex color, texture color, previous stage, etc), perform some very simple
-     * operations on each of them (e.g. inversion) and then calculate the output color
-     * with some basic arithmetic. Alpha combiners can be configured separately but work
-     * analogously.
-     **/
-    Common::Vec4<u8> combiner_output = {0, 0, 0, 0};
-    Common::Vec4<u8> combiner_buffer = {0, 0, 0, 0};
-    Common::Vec4<u8> next_combiner_buffer =
-        Common::MakeVec(regs.texturing.tev_combiner_buffer_color.r.Value(),
-                        regs.texturing.tev_combiner_buffer_color.g.Value(),
-                        regs.texturing.tev_combiner_buffer_color.b.Value(),
-                        regs.texturing.tev_combiner_buffer_color.a.Value())
-            .Cast<u8>();
-
-    for (u32 tev_stage_index = 0; tev_stage_index < tev_stages.size(); ++tev_stage_index) {
-        const auto& tev_stage = tev_stages[tev_stage_index];
-        using Source = TexturingRegs::TevStageConfig::Source;
-
-        auto get_source = [&](Source source) -> Common::Vec4<u8> {
-            switch (source) {
-            case Source::PrimaryColor:
-                return primary_color;
-            case Source::PrimaryFragmentColor:
-                return primary_fragment_color;
-            case Source::SecondaryFragmentColor:
-                return secondary_fragment_color;
-            case Source::Texture0:
-                return texture_color[0];
-            case Source::Texture1:
-                return texture_color[1];
-            case Source::Texture2:
-                return texture_color[2];
-            case Source::Texture3:
-                return texture_color[3];
-            case Source::PreviousBuffer:
-                return combiner_buffer;
-            case Source::Constant:
-                return Common::MakeVec(tev_stage.const_r.Value(), tev_stage.const_g.Value(),
-                                       tev_stage.const_b.Value(), tev_stage.const_a.Value())
-                    .Cast<u8>();
-            case Source::Previous:
-                return combiner_output;
-            default:
-                LOG_ERROR(HW_GPU, "Unknown color combiner source {}", (int)source);
-                UNIMPLEMENTED();
-                return {0, 0, 0, 0};
-            }
-        };
-
-        /**
-         * Color combiner
-         * NOTE: Not sure if the alpha combiner might use the color output of the previous
-         *       stage as input. Hence, we currently don't directly write the result to
-         *       combiner_output.rgb(), but instead store it in a temporary variable until
-         *       alpha combining has been done.
-         **/
-        const auto source1 = tev_stage_index == 0 && tev_stage.color_source1 == Source::Previous
-                                 ? tev_stage.color_source3.Value()
-                                 : tev_stage.color_source1.Value();
-        const auto source2 = tev_stage_index == 0 && tev_stage.color_source2 == Source::Previous
-                                 ? tev_stage.color_source3.Value()
-                                 : tev_stage.color_source2.Value();
-        const std::array<Common::Vec3<u8>, 3> color_result = {
-            GetColorModifier(tev_stage.color_modifier1, get_source(source1)),
-            GetColorModifier(tev_stage.color_modifier2, get_source(source2)),
-            GetColorModifier(tev_stage.color_modifier3, get_source(tev_stage.color_source3)),
-        };
-        const Common::Vec3<u8> color_output = ColorCombine(tev_stage.color_op, color_result);
-
-        u8 alpha_output;
-        if (tev_stage.color_op == TexturingRegs::TevStageConfig::Operation::Dot3_RGBA) {
-            // result of Dot3_RGBA operation is also placed to the alpha component
-            alpha_output = color_output.x;
-        } else {
-            // alpha combiner
-            const std::array<u8, 3> alpha_result = {{
-                GetAlphaModifier(tev_stage.alpha_modifier1, get_source(tev_stage.alpha_source1)),
-                GetAlphaModifier(tev_stage.alpha_modifier2, get_source(tev_stage.alpha_source2)),
-                GetAlphaModifier(tev_stage.alpha_modifier3, get_source(tev_stage.alpha_source3)),
-            }};
-            alpha_output = AlphaCombine(tev_stage.alpha_op, alpha_result);
-        }
-
-        combiner_output[0] = std::min(255U, color_output.r() * tev_stage.GetColorMultiplier());
-        combiner_output[1] = std::min(255U, color_output.g() * tev_stage.GetColorMultiplier());
-        combiner_output[2] = std::min(255U, color_output.b() * tev_stage.GetColorMultiplier());
-        combiner_output[3] = std::min(255U, alpha_output * tev_stage.GetAlphaMultiplier());
-
-        combiner_buffer = next_combiner_buffer;
-
-        if (regs.texturing.tev_combiner_buffer_input.TevStageUpdatesCombinerBufferColor(
-                tev_stage_index)) {
-            next_combiner_buffer.r() = combiner_output.r();
-            next_combiner_buffer.g() = combiner_output.g();
-            next_combiner_buffer.b() = combiner_output.b();
-        }
-
-        if (regs.texturing.tev_combiner_buffer_input.TevStageUpdatesCombinerBufferAlpha(
-                tev_stage_index)) {
-            next_combiner_buffer.a() = combiner_output.a();
-        }
-    }
-
-    return combiner_output;
-}
-
 void RasterizerSoftware::WriteFog(float depth, Common::Vec4<u8>& combiner_output) const {
     /**
      * Apply fog combiner. Not fully accurate. We'd have to know what data type is used to
@@ -856,7 +745,7 @@ bool RasterizerSoftware::DoAlphaTest(u8 alpha) const {
     }
 }
 
-bool RasterizerSoftware::DoDepthStencilTest(u16 x, u16 y, float depth) const {
+bool RasterizerSoftware::DoDepthStencilTest(const Framebuffer::Pixel& pixel, float depth) const {
     const auto& framebuffer = regs.framebuffer.framebuffer;
     const auto stencil_test = regs.framebuffer.output_merger.stencil_test;
     u8 old_stencil = 0;
@@ -867,7 +756,7 @@ bool RasterizerSoftware::DoDepthStencilTest(u16 x, u16 y, float depth) const {
         if (framebuffer.allow_depth_stencil_write != 0) {
             const u8 stencil =
                 (new_stencil & stencil_test.write_mask) | (old_stencil & ~stencil_test.write_mask);
-            fb.SetStencil(x >> 4, y >> 4, stencil);
+            fb.SetStencil(pixel, stencil);
         }
     };
 
@@ -876,7 +765,7 @@ bool RasterizerSoftware::DoDepthStencilTest(u16 x, u16 y, float depth) const {
         regs.framebuffer.framebuffer.depth_format == FramebufferRegs::DepthFormat::D24S8;
 
     if (stencil_action_enable) {
-        old_stencil = fb.GetStencil(x >> 4, y >> 4);
+        old_stencil = fb.GetStencil(pixel);
         const u8 dest = old_stencil & stencil_test.input_mask;
         const u8 ref = stencil_test.reference_value & stencil_test.input_mask;
         bool pass = false;
@@ -917,7 +806,7 @@ bool RasterizerSoftware::DoDepthStencilTest(u16 x, u16 y, float depth) const {
 
     const auto& output_merger = regs.framebuffer.output_merger;
     if (output_merger.depth_test_enable) {
-        const u32 ref_z = fb.GetDepth(x >> 4, y >> 4);
+        const u32 ref_z = fb.GetDepth(pixel);
         bool pass = false;
         switch (output_merger.depth_test_func) {
         case FramebufferRegs::CompareFunc::Never:
@@ -953,7 +842,7 @@ bool RasterizerSoftware::DoDepthStencilTest(u16 x, u16 y, float depth) const {
         }
     }
     if (framebuffer.allow_depth_stencil_write != 0 && output_merger.depth_write_enable) {
-        fb.SetDepth(x >> 4, y >> 4, z);
+        fb.SetDepth(pixel, z);
     }
     // The stencil depth_pass action is executed even if depth testing is disabled
     if (stencil_action_enable) {
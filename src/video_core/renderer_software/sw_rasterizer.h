@@ -10,6 +10,7 @@
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_software/sw_clipper.h"
 #include "video_core/renderer_software/sw_framebuffer.h"
+#include "video_core/renderer_software/sw_tev.h"
 
 namespace Pica {
 struct RegsInternal;
@@ -47,14 +48,8 @@ private:
         std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w) const;
 
     /// Returns the final pixel color with blending or logic ops applied.
-    Common::Vec4<u8> PixelColor(u16 x, u16 y, Common::Vec4<u8> combiner_output) const;
-
-    /// Emulates the TEV configuration and returns the combiner output.
-    Common::Vec4<u8> WriteTevConfig(
-        std::span<const Common::Vec4<u8>, 4> texture_color,
-        std::span<const Pica::TexturingRegs::TevStageConfig, 6> tev_stages,
-        Common::Vec4<u8> primary_color, Common::Vec4<u8> primary_fragment_color,
-        Common::Vec4<u8> secondary_fragment_color);
+    Common::Vec4<u8> PixelColor(const Framebuffer::Pixel& pixel,
+                                Common::Vec4<u8> combiner_output) const;
 
     /// Blends fog to the combiner output if enabled.
     void WriteFog(float depth, Common::Vec4<u8>& combiner_output) const;
@@ -63,7 +58,7 @@ private:
     bool DoAlphaTest(u8 alpha) const;
 
     /// Performs the depth stencil test. Returns false if the test failed.
-    bool DoDepthStencilTest(u16 x, u16 y, float depth) const;
+    bool DoDepthStencilTest(const Framebuffer::Pixel& pixel, float depth) const;
 
 private:
     Memory::MemorySystem& memory;
@@ -72,6 +67,7 @@ private:
     std::size_t num_sw_threads;
     Common::ThreadWorker sw_workers;
     Framebuffer fb;
+    TevProgram tev_program;
 };
 
 } // namespace SwRenderer
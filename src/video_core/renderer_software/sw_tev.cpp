@@ -0,0 +1,191 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/logging/log.h"
+#include "video_core/renderer_software/sw_tev.h"
+
+namespace SwRenderer {
+
+using TevStageConfig = Pica::TexturingRegs::TevStageConfig;
+using Source = TevStageConfig::Source;
+
+namespace {
+
+/// Returns the input slot of a source, which is the value of the source itself.
+u8 GetSourceSlot(Source source) {
+    switch (source) {
+    case Source::PrimaryColor:
+    case Source::PrimaryFragmentColor:
+    case Source::SecondaryFragmentColor:
+    case Source::Texture0:
+    case Source::Texture1:
+    case Source::Texture2:
+    case Source::Texture3:
+    case Source::PreviousBuffer:
+    case Source::Constant:
+    case Source::Previous:
+        break;
+    default:
+        // Unknown sources are never written and always read as zero.
+        LOG_ERROR(HW_GPU, "Unknown color combiner source {}", static_cast<u32>(source));
+        break;
+    }
+    return static_cast<u8>(source);
+}
+
+/// Returns whether the stage outputs the result of the previous stage unmodified.
+bool IsPassthrough(const TevStageConfig& stage) {
+    using ColorModifier = TevStageConfig::ColorModifier;
+    using AlphaModifier = TevStageConfig::AlphaModifier;
+    using Operation = TevStageConfig::Operation;
+
+    return stage.color_op == Operation::Replace && stage.alpha_op == Operation::Replace &&
+           stage.color_source1 == Source::Previous && stage.alpha_source1 == Source::Previous &&
+           stage.color_modifier1 == ColorModifier::SourceColor &&
+           stage.alpha_modifier1 == AlphaModifier::SourceAlpha &&
+           stage.GetColorMultiplier() == 1 && stage.GetAlphaMultiplier() == 1;
+}
+
+} // Anonymous namespace
+
+void TevProgram::Configure(const Pica::TexturingRegs& regs) {
+    const auto tev_stages = regs.GetTevStages();
+    const auto& buffer_input = regs.tev_combiner_buffer_input;
+
+    Key new_key;
+    for (std::size_t i = 0; i < tev_stages.size(); ++i) {
+        const auto& tev_stage = tev_stages[i];
+        new_key.stages[i * 5 + 0] = tev_stage.sources_raw;
+        new_key.stages[i * 5 + 1] = tev_stage.modifiers_raw;
+        new_key.stages[i * 5 + 2] = tev_stage.ops_raw;
+        new_key.stages[i * 5 + 3] = tev_stage.const_color;
+        new_key.stages[i * 5 + 4] = tev_stage.scales_raw;
+    }
+    new_key.update_masks = buffer_input.update_mask_rgb | (buffer_input.update_mask_a << 4);
+    new_key.buffer_color = regs.tev_combiner_buffer_color.raw;
+
+    if (configured && new_key == key) {
+        return;
+    }
+    key = new_key;
+    configured = true;
+
+    // Stages after the last one that modifies the output can't affect the result. The first
+    // stage is always kept, as it doesn't read the previous output like the others.
+    num_stages = tev_stages.size();
+    while (num_stages > 1 && IsPassthrough(tev_stages[num_stages - 1])) {
+        --num_stages;
+    }
+
+    for (std::size_t i = 0; i < num_stages; ++i) {
+        const auto& tev_stage = tev_stages[i];
+        auto& stage = stages[i];
+
+        // The first stage reads the third source in place of the previous output for the first
+        // two color sources.
+        const auto source1 = i == 0 && tev_stage.color_source1 == Source::Previous
+                                 ? tev_stage.color_source3.Value()
+                                 : tev_stage.color_source1.Value();
+        const auto source2 = i == 0 && tev_stage.color_source2 == Source::Previous
+                                 ? tev_stage.color_source3.Value()
+                                 : tev_stage.color_source2.Value();
+        stage.color_sources = {GetSourceSlot(source1), GetSourceSlot(source2),
+                               GetSourceSlot(tev_stage.color_source3)};
+        stage.alpha_sources = {GetSourceSlot(tev_stage.alpha_source1),
+                               GetSourceSlot(tev_stage.alpha_source2),
+                               GetSourceSlot(tev_stage.alpha_source3)};
+
+        stage.color_modifiers = {GetColorModifier(tev_stage.color_modifier1),
+                                 GetColorModifier(tev_stage.color_modifier2),
+                                 GetColorModifier(tev_stage.color_modifier3)};
+        stage.alpha_modifiers = {GetAlphaModifier(tev_stage.alpha_modifier1),
+                                 GetAlphaModifier(tev_stage.alpha_modifier2),
+                                 GetAlphaModifier(tev_stage.alpha_modifier3)};
+
+        stage.color_combine = GetColorCombine(tev_stage.color_op);
+        // Result of Dot3_RGBA operation is also placed to the alpha component
+        stage.alpha_combine = tev_stage.color_op == TevStageConfig::Operation::Dot3_RGBA
+                                  ? nullptr
+                                  : GetAlphaCombine(tev_stage.alpha_op);
+
+        stage.color_multiplier = tev_stage.GetColorMultiplier();
+        stage.alpha_multiplier = tev_stage.GetAlphaMultiplier();
+        stage.const_color = Common::MakeVec(tev_stage.const_r.Value(), tev_stage.const_g.Value(),
+                                            tev_stage.const_b.Value(), tev_stage.const_a.Value())
+                                .Cast<u8>();
+        stage.update_buffer_color = buffer_input.TevStageUpdatesCombinerBufferColor(i);
+        stage.update_buffer_alpha = buffer_input.TevStageUpdatesCombinerBufferAlpha(i);
+    }
+
+    buffer_color = Common::MakeVec(regs.tev_combiner_buffer_color.r.Value(),
+                                   regs.tev_combiner_buffer_color.g.Value(),
+                                   regs.tev_combiner_buffer_color.b.Value(),
+                                   regs.tev_combiner_buffer_color.a.Value())
+                       .Cast<u8>();
+}
+
+Common::Vec4<u8> TevProgram::Run(std::span<const Common::Vec4<u8>, 4> texture_color,
+                                 Common::Vec4<u8> primary_color,
+                                 Common::Vec4<u8> primary_fragment_color,
+                                 Common::Vec4<u8> secondary_fragment_color) const {
+    std::array<Common::Vec4<u8>, NUM_SOURCES> inputs{};
+    inputs[static_cast<u32>(Source::PrimaryColor)] = primary_color;
+    inputs[static_cast<u32>(Source::PrimaryFragmentColor)] = primary_fragment_color;
+    inputs[static_cast<u32>(Source::SecondaryFragmentColor)] = secondary_fragment_color;
+    std::copy(texture_color.begin(), texture_color.end(),
+              inputs.begin() + static_cast<u32>(Source::Texture0));
+
+    auto& combiner_output = inputs[static_cast<u32>(Source::Previous)];
+    auto& combiner_buffer = inputs[static_cast<u32>(Source::PreviousBuffer)];
+    auto& constant = inputs[static_cast<u32>(Source::Constant)];
+    Common::Vec4<u8> next_combiner_buffer = buffer_color;
+
+    for (std::size_t i = 0; i < num_stages; ++i) {
+        const auto& stage = stages[i];
+        constant = stage.const_color;
+
+        // The alpha combiner might use the color output of the previous stage as input, so
+        // the color result is only written to combiner_output after alpha combining.
+        const std::array<Common::Vec3<u8>, 3> color_result = {
+            stage.color_modifiers[0](inputs[stage.color_sources[0]]),
+            stage.color_modifiers[1](inputs[stage.color_sources[1]]),
+            stage.color_modifiers[2](inputs[stage.color_sources[2]]),
+        };
+        const Common::Vec3<u8> color_output = stage.color_combine(color_result);
+
+        u8 alpha_output;
+        if (stage.alpha_combine) {
+            const std::array<u8, 3> alpha_result = {{
+                stage.alpha_modifiers[0](inputs[stage.alpha_sources[0]]),
+                stage.alpha_modifiers[1](inputs[stage.alpha_sources[1]]),
+                stage.alpha_modifiers[2](inputs[stage.alpha_sources[2]]),
+            }};
+            alpha_output = stage.alpha_combine(alpha_result);
+        } else {
+            alpha_output = color_output.x;
+        }
+
+        combiner_output[0] = std::min(255U, color_output.r() * stage.color_multiplier);
+        combiner_output[1] = std::min(255U, color_output.g() * stage.color_multiplier);
+        combiner_output[2] = std::min(255U, color_output.b() * stage.color_multiplier);
+        combiner_output[3] = std::min(255U, alpha_output * stage.alpha_multiplier);
+
+        combiner_buffer = next_combiner_buffer;
+
+        if (stage.update_buffer_color) {
+            next_combiner_buffer.r() = combiner_output.r();
+            next_combiner_buffer.g() = combiner_output.g();
+            next_combiner_buffer.b() = combiner_output.b();
+        }
+
+        if (stage.update_buffer_alpha) {
+            next_combiner_buffer.a() = combiner_output.a();
+        }
+    }
+
+    return combiner_output;
+}
+
+} // namespace SwRenderer
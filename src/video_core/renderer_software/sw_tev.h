@@ -0,0 +1,72 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <span>
+#include "common/common_types.h"
+#include "common/vector_math.h"
+#include "video_core/pica/regs_texturing.h"
+#include "video_core/renderer_software/sw_texturing.h"
+
+namespace SwRenderer {
+
+/**
+ * Texture environment - consists of 6 stages of color and alpha combining.
+ * Color combiners take three input color values from some source (e.g. interpolated
+ * vertex color, texture color, previous stage, etc), perform some very simple
+ * operations on each of them (e.g. inversion) and then calculate the output color
+ * with some basic arithmetic. Alpha combiners can be configured separately but work
+ * analogously.
+ *
+ * The program is built once per combiner configuration: sources are resolved to input slots,
+ * modifiers and operations to specialized routines, and trailing stages that only pass the
+ * previous output through are dropped, so that running it per fragment does not have to decode
+ * the registers again.
+ */
+class TevProgram {
+public:
+    /// Rebuilds the program if the combiner registers changed since the last call.
+    void Configure(const Pica::TexturingRegs& regs);
+
+    /// Runs the configured stages on the inputs of a fragment and returns the combiner output.
+    Common::Vec4<u8> Run(std::span<const Common::Vec4<u8>, 4> texture_color,
+                         Common::Vec4<u8> primary_color, Common::Vec4<u8> primary_fragment_color,
+                         Common::Vec4<u8> secondary_fragment_color) const;
+
+private:
+    static constexpr std::size_t NUM_STAGES = 6;
+    static constexpr std::size_t NUM_SOURCES = 16;
+
+    struct Stage {
+        std::array<u8, 3> color_sources;
+        std::array<u8, 3> alpha_sources;
+        std::array<ColorModifierFunc, 3> color_modifiers;
+        std::array<AlphaModifierFunc, 3> alpha_modifiers;
+        ColorCombineFunc color_combine;
+        AlphaCombineFunc alpha_combine; ///< nullptr when the color operation also writes alpha
+        u32 color_multiplier;
+        u32 alpha_multiplier;
+        Common::Vec4<u8> const_color;
+        bool update_buffer_color;
+        bool update_buffer_alpha;
+    };
+
+    /// Raw register values the program was built from.
+    struct Key {
+        std::array<u32, NUM_STAGES * 5> stages{};
+        u32 update_masks{};
+        u32 buffer_color{};
+        bool operator==(const Key&) const = default;
+    };
+
+    Key key{};
+    bool configured = false;
+    std::array<Stage, NUM_STAGES> stages{};
+    std::size_t num_stages = 0;
+    Common::Vec4<u8> buffer_color{};
+};
+
+} // namespace SwRenderer
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <utility>
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/vector_math.h"
@@ -50,8 +51,13 @@ int GetWrappedTexCoord(Pica::TexturingRegs::TextureConfig::WrapMode mode, s32 va
     }
 };
 
-Common::Vec3<u8> GetColorModifier(TevStageConfig::ColorModifier factor,
-                                  const Common::Vec4<u8>& values) {
+namespace {
+
+// The routines below are instantiated for every value of the modifier or operation, so that the
+// switch is resolved at compile time and the TEV only has to pick the routine once per config.
+
+template <TevStageConfig::ColorModifier factor>
+Common::Vec3<u8> ColorModifierImpl(const Common::Vec4<u8>& values) {
     using ColorModifier = TevStageConfig::ColorModifier;
 
     switch (factor) {
@@ -79,7 +85,8 @@ Common::Vec3<u8> GetColorModifier(TevStageConfig::ColorModifier factor,
     UNREACHABLE();
 };
 
-u8 GetAlphaModifier(TevStageConfig::AlphaModifier factor, const Common::Vec4<u8>& values) {
+template <TevStageConfig::AlphaModifier factor>
+u8 AlphaModifierImpl(const Common::Vec4<u8>& values) {
     using AlphaModifier = TevStageConfig::AlphaModifier;
 
     switch (factor) {
@@ -103,8 +110,8 @@ u8 GetAlphaModifier(TevStageConfig::AlphaModifier factor, const Common::Vec4<u8>
     UNREACHABLE();
 };
 
-Common::Vec3<u8> ColorCombine(TevStageConfig::Operation op,
-                              std::span<const Common::Vec3<u8>, 3> input) {
+template <TevStageConfig::Operation op>
+Common::Vec3<u8> ColorCombineImpl(std::span<const Common::Vec3<u8>, 3> input) {
     using Operation = TevStageConfig::Operation;
 
     switch (op) {
@@ -175,7 +182,8 @@ Common::Vec3<u8> ColorCombine(TevStageConfig::Operation op,
     }
 };
 
-u8 AlphaCombine(TevStageConfig::Operation op, const std::array<u8, 3>& input) {
+template <TevStageConfig::Operation op>
+u8 AlphaCombineImpl(const std::array<u8, 3>& input) {
     switch (op) {
         using Operation = TevStageConfig::Operation;
     case Operation::Replace:
@@ -204,4 +212,43 @@ u8 AlphaCombine(TevStageConfig::Operation op, const std::array<u8, 3>& input) {
     }
 };
 
+/// Builds a table of the instances of a routine for every value of a field with N bits.
+template <std::size_t N, typename Make>
+constexpr auto MakeTable(Make make) {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array{make(std::integral_constant<u32, I>{})...};
+    }(std::make_index_sequence<1 << N>{});
+}
+
+constexpr auto COLOR_MODIFIERS = MakeTable<4>([](auto i) -> ColorModifierFunc {
+    return &ColorModifierImpl<static_cast<TevStageConfig::ColorModifier>(i())>;
+});
+constexpr auto ALPHA_MODIFIERS = MakeTable<3>([](auto i) -> AlphaModifierFunc {
+    return &AlphaModifierImpl<static_cast<TevStageConfig::AlphaModifier>(i())>;
+});
+constexpr auto COLOR_COMBINERS = MakeTable<4>([](auto i) -> ColorCombineFunc {
+    return &ColorCombineImpl<static_cast<TevStageConfig::Operation>(i())>;
+});
+constexpr auto ALPHA_COMBINERS = MakeTable<4>([](auto i) -> AlphaCombineFunc {
+    return &AlphaCombineImpl<static_cast<TevStageConfig::Operation>(i())>;
+});
+
+} // Anonymous namespace
+
+ColorModifierFunc GetColorModifier(TevStageConfig::ColorModifier factor) {
+    return COLOR_MODIFIERS[static_cast<u32>(factor) % COLOR_MODIFIERS.size()];
+}
+
+AlphaModifierFunc GetAlphaModifier(TevStageConfig::AlphaModifier factor) {
+    return ALPHA_MODIFIERS[static_cast<u32>(factor) % ALPHA_MODIFIERS.size()];
+}
+
+ColorCombineFunc GetColorCombine(TevStageConfig::Operation op) {
+    return COLOR_COMBINERS[static_cast<u32>(op) % COLOR_COMBINERS.size()];
+}
+
+AlphaCombineFunc GetAlphaCombine(TevStageConfig::Operation op) {
+    return ALPHA_COMBINERS[static_cast<u32>(op) % ALPHA_COMBINERS.size()];
+}
+
 } // namespace SwRenderer
@@ -14,15 +14,21 @@ namespace SwRenderer {
 
 int GetWrappedTexCoord(Pica::TexturingRegs::TextureConfig::WrapMode mode, s32 val, u32 size);
 
-Common::Vec3<u8> GetColorModifier(Pica::TexturingRegs::TevStageConfig::ColorModifier factor,
-                                  const Common::Vec4<u8>& values);
+using ColorModifierFunc = Common::Vec3<u8> (*)(const Common::Vec4<u8>& values);
+using AlphaModifierFunc = u8 (*)(const Common::Vec4<u8>& values);
+using ColorCombineFunc = Common::Vec3<u8> (*)(std::span<const Common::Vec3<u8>, 3> input);
+using AlphaCombineFunc = u8 (*)(const std::array<u8, 3>& input);
 
-u8 GetAlphaModifier(Pica::TexturingRegs::TevStageConfig::AlphaModifier factor,
-                    const Common::Vec4<u8>& values);
+/// Returns the routine applying the given color modifier to a source.
+ColorModifierFunc GetColorModifier(Pica::TexturingRegs::TevStageConfig::ColorModifier factor);
 
-Common::Vec3<u8> ColorCombine(Pica::TexturingRegs::TevStageConfig::Operation op,
-                              std::span<const Common::Vec3<u8>, 3> input);
+/// Returns the routine applying the given alpha modifier to a source.
+AlphaModifierFunc GetAlphaModifier(Pica::TexturingRegs::TevStageConfig::AlphaModifier factor);
 
-u8 AlphaCombine(Pica::TexturingRegs::TevStageConfig::Operation op, const std::array<u8, 3>& input);
+/// Returns the routine combining the modified color sources with the given operation.
+ColorCombineFunc GetColorCombine(Pica::TexturingRegs::TevStageConfig::Operation op);
+
+/// Returns the routine combining the modified alpha sources with the given operation.
+AlphaCombineFunc GetAlphaCombine(Pica::TexturingRegs::TevStageConfig::Operation op);
 
 } // namespace SwRenderer
@@ -3,13 +3,15 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <numeric>
-#include <boost/circular_buffer.hpp>
+#include <vector>
 #include <boost/container/static_vector.hpp>
 #include <nihstro/shader_bytecode.h>
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/vector_math.h"
@@ -44,12 +46,52 @@ struct LoopStackElement {
     u8 previous_aL;
 };
 
+/**
+ * Fixed capacity stack of flow control scopes. Like on hardware, pushing to a full stack discards
+ * its oldest element.
+ */
+template <typename T, std::size_t Capacity>
+class ScopeStack {
+public:
+    bool empty() const {
+        return count == 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    T& back() {
+        return elements[(top - 1) % Capacity];
+    }
+
+    void push_back(const T& element) {
+        elements[top % Capacity] = element;
+        ++top;
+        count = std::min(count + 1, Capacity);
+    }
+
+    void pop_back() {
+        --top;
+        --count;
+    }
+
+private:
+    std::array<T, Capacity> elements{};
+    std::size_t top = 0;
+    std::size_t count = 0;
+};
+
+// Constants for handling invalid inputs
+static f24 dummy_vec4_float24_zeros[4] = {f24::Zero(), f24::Zero(), f24::Zero(), f24::Zero()};
+static f24 dummy_vec4_float24_ones[4] = {f24::One(), f24::One(), f24::One(), f24::One()};
+
 template <bool Debug>
 static void RunInterpreter(const ShaderSetup& setup, ShaderUnit& state,
                            DebugData<Debug>& debug_data, unsigned entry_point) {
-    boost::circular_buffer<IfStackElement> if_stack(8);
-    boost::circular_buffer<CallStackElement> call_stack(4);
-    boost::circular_buffer<LoopStackElement> loop_stack(4);
+    ScopeStack<IfStackElement, 8> if_stack;
+    ScopeStack<CallStackElement, 4> call_stack;
+    ScopeStack<LoopStackElement, 4> loop_stack;
     u32 program_counter = entry_point;
 
     const auto do_if = [&](Instruction instr, bool condition) {
@@ -108,10 +150,6 @@ static void RunInterpreter(const ShaderSetup& setup, ShaderUnit& state,
     const auto& swizzle_data = setup.swizzle_data;
     const auto& program_code = setup.program_code;
 
-    // Constants for handling invalid inputs
-    static f24 dummy_vec4_float24_zeros[4] = {f24::Zero(), f24::Zero(), f24::Zero(), f24::Zero()};
-    static f24 dummy_vec4_float24_ones[4] = {f24::One(), f24::One(), f24::One(), f24::One()};
-
     u32 iteration = 0;
     bool should_stop = false;
     while (!should_stop) {
@@ -720,19 +758,772 @@ static void RunInterpreter(const ShaderSetup& setup, ShaderUnit& state,
     }
 }
 
+/// Operation of a pre-decoded instruction. Opcode aliases with inverted sources are merged.
+enum class DecodedOp : u8 {
+    ADD,
+    MUL,
+    FLR,
+    MAX,
+    MIN,
+    DP3,
+    DP4,
+    DPH,
+    RCP,
+    RSQ,
+    MOVA,
+    MOV,
+    SGE,
+    SLT,
+    CMP,
+    EX2,
+    LG2,
+    MAD,
+    END,
+    JMPC,
+    JMPU,
+    CALL,
+    CALLU,
+    CALLC,
+    NOP,
+    IFU,
+    IFC,
+    LOOP,
+    BREAK,
+    BREAKC,
+    EMIT,
+    SETEMIT,
+    Unhandled,
+};
+
+struct DecodedSource {
+    enum class Type : u8 {
+        Unit,    ///< Input or temporary register, offset is its location in the ShaderUnit
+        Uniform, ///< Float uniform, offset is its index
+        Invalid,
+    };
+
+    Type type;
+    u8 address_register; ///< Address register added to the uniform index, 0 if none
+    u16 offset;
+    std::array<u8, 4> selectors;
+    bool negate;
+};
+
+struct DecodedInstruction {
+    DecodedOp op;
+    u8 dest_mask;    ///< Bit i is set if the component i of the destination is written
+    u16 dest_offset; ///< Location of the destination register in the ShaderUnit
+    std::array<DecodedSource, 3> src;
+
+    u32 dest_address;  ///< Target of jumps, calls and scopes
+    u32 scope_end;     ///< End address of the scope opened by calls and conditionals
+    u8 uniform_id;     ///< Bool or int uniform read by flow control
+    bool jump_if;      ///< Value of the bool uniform for which JMPU jumps
+    bool refx;         ///< Reference value of the x component of the conditional code
+    bool refy;         ///< Reference value of the y component of the conditional code
+    Instruction::FlowControlType::Op condition_op;
+    std::array<Instruction::Common::CompareOpType::Op, 2> compare_op;
+    u8 vertex_id;
+    bool prim_emit;
+    bool winding;
+
+    u32 hex; ///< Original instruction, for error reporting
+};
+
+/**
+ * Shader program with all its instructions decoded ahead of time: operand descriptors are
+ * resolved to register locations, component selectors and write masks, and the fields of flow
+ * control instructions are extracted.
+ */
+struct DecodedProgram {
+    DecodedProgram(const ProgramCode& program_code, const SwizzleData& swizzle_data);
+
+    std::vector<DecodedInstruction> instructions;
+};
+
+static DecodedSource DecodeSource(SourceRegister reg, u32 address_register_index,
+                                  std::array<u8, 4> selectors, bool negate) {
+    DecodedSource source{
+        .type = DecodedSource::Type::Invalid,
+        .address_register = 0,
+        .offset = 0,
+        .selectors = selectors,
+        .negate = negate,
+    };
+    const int index = reg.GetIndex();
+    switch (reg.GetRegisterType()) {
+    case RegisterType::Input:
+        source.type = DecodedSource::Type::Unit;
+        source.offset = static_cast<u16>(ShaderUnit::InputOffset(index));
+        break;
+    case RegisterType::Temporary:
+        source.type = DecodedSource::Type::Unit;
+        source.offset = static_cast<u16>(ShaderUnit::TemporaryOffset(index));
+        break;
+    case RegisterType::FloatUniform:
+        source.type = DecodedSource::Type::Uniform;
+        source.address_register = static_cast<u8>(address_register_index);
+        source.offset = static_cast<u16>(index);
+        break;
+    default:
+        break;
+    }
+    return source;
+}
+
+static u16 DecodeDest(nihstro::DestRegister dest) {
+    return static_cast<u16>(dest < 0x10 ? ShaderUnit::OutputOffset(dest.GetIndex())
+                                        : ShaderUnit::TemporaryOffset(dest.GetIndex()));
+}
+
+static u8 DecodeDestMask(const SwizzlePattern& swizzle) {
+    u8 mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        mask |= swizzle.DestComponentEnabled(i) ? (1 << i) : 0;
+    }
+    return mask;
+}
+
+static DecodedOp DecodeArithmeticOp(OpCode::Id opcode) {
+    switch (opcode) {
+    case OpCode::Id::ADD:
+        return DecodedOp::ADD;
+    case OpCode::Id::MUL:
+        return DecodedOp::MUL;
+    case OpCode::Id::FLR:
+        return DecodedOp::FLR;
+    case OpCode::Id::MAX:
+        return DecodedOp::MAX;
+    case OpCode::Id::MIN:
+        return DecodedOp::MIN;
+    case OpCode::Id::DP3:
+        return DecodedOp::DP3;
+    case OpCode::Id::DP4:
+        return DecodedOp::DP4;
+    case OpCode::Id::DPH:
+    case OpCode::Id::DPHI:
+        return DecodedOp::DPH;
+    case OpCode::Id::RCP:
+        return DecodedOp::RCP;
+    case OpCode::Id::RSQ:
+        return DecodedOp::RSQ;
+    case OpCode::Id::MOVA:
+        return DecodedOp::MOVA;
+    case OpCode::Id::MOV:
+        return DecodedOp::MOV;
+    case OpCode::Id::SGE:
+    case OpCode::Id::SGEI:
+        return DecodedOp::SGE;
+    case OpCode::Id::SLT:
+    case OpCode::Id::SLTI:
+        return DecodedOp::SLT;
+    case OpCode::Id::CMP:
+        return DecodedOp::CMP;
+    case OpCode::Id::EX2:
+        return DecodedOp::EX2;
+    case OpCode::Id::LG2:
+        return DecodedOp::LG2;
+    default:
+        return DecodedOp::Unhandled;
+    }
+}
+
+static DecodedOp DecodeFlowControlOp(OpCode::Id opcode) {
+    switch (opcode) {
+    case OpCode::Id::END:
+        return DecodedOp::END;
+    case OpCode::Id::JMPC:
+        return DecodedOp::JMPC;
+    case OpCode::Id::JMPU:
+        return DecodedOp::JMPU;
+    case OpCode::Id::CALL:
+        return DecodedOp::CALL;
+    case OpCode::Id::CALLU:
+        return DecodedOp::CALLU;
+    case OpCode::Id::CALLC:
+        return DecodedOp::CALLC;
+    case OpCode::Id::NOP:
+        return DecodedOp::NOP;
+    case OpCode::Id::IFU:
+        return DecodedOp::IFU;
+    case OpCode::Id::IFC:
+        return DecodedOp::IFC;
+    case OpCode::Id::LOOP:
+        return DecodedOp::LOOP;
+    case OpCode::Id::BREAK:
+        return DecodedOp::BREAK;
+    case OpCode::Id::BREAKC:
+        return DecodedOp::BREAKC;
+    case OpCode::Id::EMIT:
+        return DecodedOp::EMIT;
+    case OpCode::Id::SETEMIT:
+        return DecodedOp::SETEMIT;
+    default:
+        return DecodedOp::Unhandled;
+    }
+}
+
+static DecodedInstruction DecodeInstruction(const Instruction instr,
+                                            const SwizzleData& swizzle_data) {
+    DecodedInstruction decoded{};
+    decoded.hex = instr.hex;
+
+    const OpCode opcode = instr.opcode.Value();
+    switch (opcode.GetInfo().type) {
+    case OpCode::Type::Arithmetic: {
+        const SwizzlePattern swizzle = {swizzle_data[instr.common.operand_desc_id]};
+        const bool is_inverted = (0 != (opcode.GetInfo().subtype & OpCode::Info::SrcInversed));
+
+        decoded.op = DecodeArithmeticOp(opcode.EffectiveOpCode());
+        decoded.src[0] = DecodeSource(instr.common.GetSrc1(is_inverted),
+                                      !is_inverted * instr.common.address_register_index,
+                                      {
+                                          static_cast<u8>(swizzle.src1_selector_0.Value()),
+                                          static_cast<u8>(swizzle.src1_selector_1.Value()),
+                                          static_cast<u8>(swizzle.src1_selector_2.Value()),
+                                          static_cast<u8>(swizzle.src1_selector_3.Value()),
+                                      },
+                                      swizzle.negate_src1.Value() != 0);
+        decoded.src[1] = DecodeSource(instr.common.GetSrc2(is_inverted),
+                                      is_inverted * instr.common.address_register_index,
+                                      {
+                                          static_cast<u8>(swizzle.src2_selector_0.Value()),
+                                          static_cast<u8>(swizzle.src2_selector_1.Value()),
+                                          static_cast<u8>(swizzle.src2_selector_2.Value()),
+                                          static_cast<u8>(swizzle.src2_selector_3.Value()),
+                                      },
+                                      swizzle.negate_src2.Value() != 0);
+        decoded.dest_offset = DecodeDest(instr.common.dest.Value());
+        decoded.dest_mask = DecodeDestMask(swizzle);
+        decoded.compare_op = {instr.common.compare_op.x.Value(), instr.common.compare_op.y.Value()};
+        break;
+    }
+
+    case OpCode::Type::MultiplyAdd: {
+        if ((opcode.EffectiveOpCode() != OpCode::Id::MAD) &&
+            (opcode.EffectiveOpCode() != OpCode::Id::MADI)) {
+            decoded.op = DecodedOp::Unhandled;
+            break;
+        }
+
+        const SwizzlePattern swizzle = {swizzle_data[instr.mad.operand_desc_id]};
+        const bool is_inverted = (opcode.EffectiveOpCode() == OpCode::Id::MADI);
+
+        decoded.op = DecodedOp::MAD;
+        decoded.src[0] = DecodeSource(instr.mad.GetSrc1(is_inverted), 0,
+                                      {
+                                          static_cast<u8>(swizzle.src1_selector_0.Value()),
+                                          static_cast<u8>(swizzle.src1_selector_1.Value()),
+                                          static_cast<u8>(swizzle.src1_selector_2.Value()),
+                                          static_cast<u8>(swizzle.src1_selector_3.Value()),
+                                      },
+                                      swizzle.negate_src1.Value() != 0);
+        decoded.src[1] = DecodeSource(instr.mad.GetSrc2(is_inverted),
+                                      !is_inverted * instr.mad.address_register_index,
+                                      {
+                                          static_cast<u8>(swizzle.src2_selector_0.Value()),
+                                          static_cast<u8>(swizzle.src2_selector_1.Value()),
+                                          static_cast<u8>(swizzle.src2_selector_2.Value()),
+                                          static_cast<u8>(swizzle.src2_selector_3.Value()),
+                                      },
+                                      swizzle.negate_src2.Value() != 0);
+        decoded.src[2] = DecodeSource(instr.mad.GetSrc3(is_inverted),
+                                      is_inverted * instr.mad.address_register_index,
+                                      {
+                                          static_cast<u8>(swizzle.src3_selector_0.Value()),
+                                          static_cast<u8>(swizzle.src3_selector_1.Value()),
+                                          static_cast<u8>(swizzle.src3_selector_2.Value()),
+                                          static_cast<u8>(swizzle.src3_selector_3.Value()),
+                                      },
+                                      swizzle.negate_src3.Value() != 0);
+        decoded.dest_offset = DecodeDest(instr.mad.dest.Value());
+        decoded.dest_mask = DecodeDestMask(swizzle);
+        break;
+    }
+
+    default: {
+        const auto& flow_control = instr.flow_control;
+        decoded.op = DecodeFlowControlOp(opcode);
+        decoded.dest_address = flow_control.dest_offset;
+        decoded.scope_end = flow_control.dest_offset + flow_control.num_instructions;
+        decoded.uniform_id = static_cast<u8>(decoded.op == DecodedOp::LOOP
+                                                 ? flow_control.int_uniform_id
+                                                 : flow_control.bool_uniform_id);
+        decoded.jump_if = !(flow_control.num_instructions & 1);
+        decoded.refx = flow_control.refx.Value() != 0;
+        decoded.refy = flow_control.refy.Value() != 0;
+        decoded.condition_op = flow_control.op;
+        decoded.vertex_id = static_cast<u8>(instr.setemit.vertex_id);
+        decoded.prim_emit = instr.setemit.prim_emit != 0;
+        decoded.winding = instr.setemit.winding != 0;
+        break;
+    }
+    }
+
+    return decoded;
+}
+
+DecodedProgram::DecodedProgram(const ProgramCode& program_code, const SwizzleData& swizzle_data) {
+    instructions.reserve(program_code.size());
+    for (const u32 word : program_code) {
+        instructions.push_back(DecodeInstruction({word}, swizzle_data));
+    }
+}
+
+static void LogUnhandledInstruction(const Instruction instr) {
+    const OpCode opcode = instr.opcode.Value();
+    switch (opcode.GetInfo().type) {
+    case OpCode::Type::Arithmetic:
+        LOG_ERROR(HW_GPU, "Unhandled arithmetic instruction: 0x{:02x} ({}): 0x{:08x}",
+                  (int)opcode.EffectiveOpCode(), opcode.GetInfo().name, instr.hex);
+        DEBUG_ASSERT(false);
+        break;
+    case OpCode::Type::MultiplyAdd:
+        LOG_ERROR(HW_GPU, "Unhandled multiply-add instruction: 0x{:02x} ({}): 0x{:08x}",
+                  (int)opcode.EffectiveOpCode(), opcode.GetInfo().name, instr.hex);
+        break;
+    default:
+        LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
+                  (int)opcode.EffectiveOpCode(), opcode.GetInfo().name, instr.hex);
+        break;
+    }
+}
+
+/**
+ * Runs a pre-decoded program. This matches RunInterpreter bit for bit, but without debug data
+ * and without decoding instructions and operand descriptors on every step.
+ */
+static void RunDecodedProgram(const DecodedProgram& program, const ShaderSetup& setup,
+                              ShaderUnit& state) {
+    ScopeStack<IfStackElement, 8> if_stack;
+    ScopeStack<CallStackElement, 4> call_stack;
+    ScopeStack<LoopStackElement, 4> loop_stack;
+    u32 program_counter = setup.entry_point;
+
+    const auto& uniforms = setup.uniforms;
+    u8* const unit = reinterpret_cast<u8*>(&state);
+
+    const auto lookup = [&](const DecodedSource& source) -> const f24* {
+        switch (source.type) {
+        case DecodedSource::Type::Unit:
+            return reinterpret_cast<const f24*>(unit + source.offset);
+        case DecodedSource::Type::Uniform: {
+            if (source.address_register == 0) {
+                return &uniforms.f[source.offset].x;
+            }
+            int offset = state.address_registers[source.address_register - 1];
+            if (offset < std::numeric_limits<s8>::min() ||
+                offset > std::numeric_limits<s8>::max()) [[unlikely]] {
+                offset = 0;
+            }
+            const int index = (source.offset + offset) & 0x7F;
+            // If the index is above 96, the result is all one.
+            if (index >= 96) [[unlikely]] {
+                return dummy_vec4_float24_ones;
+            }
+            return &uniforms.f[index].x;
+        }
+        default:
+            return dummy_vec4_float24_zeros;
+        }
+    };
+
+    const auto fetch = [&](const DecodedSource& source, f24 (&value)[4]) {
+        const f24* reg = lookup(source);
+        for (int i = 0; i < 4; ++i) {
+            value[i] = reg[source.selectors[i]];
+        }
+        if (source.negate) {
+            for (int i = 0; i < 4; ++i) {
+                value[i] = -value[i];
+            }
+        }
+    };
+
+    // Writes the enabled components of the destination, computing each one with func(i)
+    const auto write_dest = [unit](const DecodedInstruction& instr, auto func) {
+        f24* dest = reinterpret_cast<f24*>(unit + instr.dest_offset);
+        for (int i = 0; i < 4; ++i) {
+            if (instr.dest_mask & (1 << i)) {
+                dest[i] = func(i);
+            }
+        }
+    };
+
+    const auto evaluate_condition = [&state](const DecodedInstruction& instr) {
+        using Op = Instruction::FlowControlType::Op;
+
+        const bool result_x = instr.refx == state.conditional_code[0];
+        const bool result_y = instr.refy == state.conditional_code[1];
+
+        switch (instr.condition_op) {
+        case Op::Or:
+            return result_x || result_y;
+        case Op::And:
+            return result_x && result_y;
+        case Op::JustX:
+            return result_x;
+        case Op::JustY:
+            return result_y;
+        default:
+            UNREACHABLE();
+            return false;
+        }
+    };
+
+    const auto do_if = [&](const DecodedInstruction& instr, bool condition) {
+        if (condition) {
+            if_stack.push_back({
+                .else_address = instr.dest_address,
+                .end_address = instr.scope_end,
+            });
+        } else {
+            program_counter = instr.dest_address - 1;
+        }
+    };
+
+    const auto do_call = [&](const DecodedInstruction& instr) {
+        call_stack.push_back({
+            .end_address = instr.scope_end,
+            .return_address = program_counter + 1,
+        });
+        program_counter = instr.dest_address - 1;
+    };
+
+    bool should_stop = false;
+    while (!should_stop) {
+        bool is_break = false;
+        const u32 old_program_counter = program_counter;
+        const DecodedInstruction& instr = program.instructions[program_counter];
+
+        switch (instr.op) {
+        case DecodedOp::ADD: {
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            write_dest(instr, [&](int i) { return src1[i] + src2[i]; });
+            break;
+        }
+
+        case DecodedOp::MUL: {
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            write_dest(instr, [&](int i) { return src1[i] * src2[i]; });
+            break;
+        }
+
+        case DecodedOp::FLR: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            write_dest(instr,
+                       [&](int i) { return f24::FromFloat32(std::floor(src1[i].ToFloat32())); });
+            break;
+        }
+
+        case DecodedOp::MAX: {
+            // NOTE: Exact form required to match NaN semantics to hardware, see RunInterpreter
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            write_dest(instr, [&](int i) { return (src1[i] > src2[i]) ? src1[i] : src2[i]; });
+            break;
+        }
+
+        case DecodedOp::MIN: {
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            write_dest(instr, [&](int i) { return (src1[i] < src2[i]) ? src1[i] : src2[i]; });
+            break;
+        }
+
+        case DecodedOp::DP3:
+        case DecodedOp::DP4:
+        case DecodedOp::DPH: {
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            if (instr.op == DecodedOp::DPH) {
+                src1[3] = f24::One();
+            }
+
+            const int num_components = (instr.op == DecodedOp::DP3) ? 3 : 4;
+            const f24 dot = std::inner_product(src1, src1 + num_components, src2, f24::Zero());
+            write_dest(instr, [dot](int) { return dot; });
+            break;
+        }
+
+        case DecodedOp::RCP: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            const f24 rcp_res = f24::FromFloat32(1.0f / src1[0].ToFloat32());
+            write_dest(instr, [rcp_res](int) { return rcp_res; });
+            break;
+        }
+
+        case DecodedOp::RSQ: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            const f24 rsq_res = f24::FromFloat32(1.0f / std::sqrt(src1[0].ToFloat32()));
+            write_dest(instr, [rsq_res](int) { return rsq_res; });
+            break;
+        }
+
+        case DecodedOp::MOVA: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            for (int i = 0; i < 2; ++i) {
+                if (instr.dest_mask & (1 << i)) {
+                    state.address_registers[i] = static_cast<s32>(src1[i].ToFloat32());
+                }
+            }
+            break;
+        }
+
+        case DecodedOp::MOV: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            write_dest(instr, [&](int i) { return src1[i]; });
+            break;
+        }
+
+        case DecodedOp::SGE: {
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            write_dest(instr,
+                       [&](int i) { return (src1[i] >= src2[i]) ? f24::One() : f24::Zero(); });
+            break;
+        }
+
+        case DecodedOp::SLT: {
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            write_dest(instr,
+                       [&](int i) { return (src1[i] < src2[i]) ? f24::One() : f24::Zero(); });
+            break;
+        }
+
+        case DecodedOp::CMP: {
+            using CompareOp = Instruction::Common::CompareOpType::Op;
+
+            f24 src1[4], src2[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            for (int i = 0; i < 2; ++i) {
+                const CompareOp op = instr.compare_op[i];
+                switch (op) {
+                case CompareOp::Equal:
+                    state.conditional_code[i] = (src1[i] == src2[i]);
+                    break;
+                case CompareOp::NotEqual:
+                    state.conditional_code[i] = (src1[i] != src2[i]);
+                    break;
+                case CompareOp::LessThan:
+                    state.conditional_code[i] = (src1[i] < src2[i]);
+                    break;
+                case CompareOp::LessEqual:
+                    state.conditional_code[i] = (src1[i] <= src2[i]);
+                    break;
+                case CompareOp::GreaterThan:
+                    state.conditional_code[i] = (src1[i] > src2[i]);
+                    break;
+                case CompareOp::GreaterEqual:
+                    state.conditional_code[i] = (src1[i] >= src2[i]);
+                    break;
+                default:
+                    LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", static_cast<int>(op));
+                    break;
+                }
+            }
+            break;
+        }
+
+        case DecodedOp::EX2: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            const f24 ex2_res = f24::FromFloat32(std::exp2(src1[0].ToFloat32()));
+            write_dest(instr, [ex2_res](int) { return ex2_res; });
+            break;
+        }
+
+        case DecodedOp::LG2: {
+            f24 src1[4];
+            fetch(instr.src[0], src1);
+            const f24 lg2_res = f24::FromFloat32(std::log2(src1[0].ToFloat32()));
+            write_dest(instr, [lg2_res](int) { return lg2_res; });
+            break;
+        }
+
+        case DecodedOp::MAD: {
+            f24 src1[4], src2[4], src3[4];
+            fetch(instr.src[0], src1);
+            fetch(instr.src[1], src2);
+            fetch(instr.src[2], src3);
+            write_dest(instr, [&](int i) { return src1[i] * src2[i] + src3[i]; });
+            break;
+        }
+
+        case DecodedOp::END:
+            should_stop = true;
+            break;
+
+        case DecodedOp::JMPC:
+            if (evaluate_condition(instr)) {
+                program_counter = instr.dest_address - 1;
+            }
+            break;
+
+        case DecodedOp::JMPU:
+            if (uniforms.b[instr.uniform_id] == instr.jump_if) {
+                program_counter = instr.dest_address - 1;
+            }
+            break;
+
+        case DecodedOp::CALL:
+            do_call(instr);
+            break;
+
+        case DecodedOp::CALLU:
+            if (uniforms.b[instr.uniform_id]) {
+                do_call(instr);
+            }
+            break;
+
+        case DecodedOp::CALLC:
+            if (evaluate_condition(instr)) {
+                do_call(instr);
+            }
+            break;
+
+        case DecodedOp::NOP:
+            break;
+
+        case DecodedOp::IFU:
+            do_if(instr, uniforms.b[instr.uniform_id]);
+            break;
+
+        case DecodedOp::IFC:
+            do_if(instr, evaluate_condition(instr));
+            break;
+
+        case DecodedOp::LOOP: {
+            const Common::Vec4<u8>& loop_param = uniforms.i[instr.uniform_id];
+            // The previous aL saved in the scope is the value loaded by this instruction
+            loop_stack.push_back({
+                .entry_address = program_counter + 1,
+                .end_address = instr.dest_address + 1,
+                .loop_downcounter = loop_param.x,
+                .address_increment = loop_param.z,
+                .previous_aL = loop_param.y,
+            });
+            state.address_registers[2] = loop_param.y;
+            break;
+        }
+
+        case DecodedOp::BREAK:
+            is_break = true;
+            break;
+
+        case DecodedOp::BREAKC:
+            is_break = evaluate_condition(instr);
+            break;
+
+        case DecodedOp::EMIT: {
+            auto* emitter = state.emitter_ptr;
+            ASSERT_MSG(emitter, "Execute EMIT on VS");
+            emitter->Emit(state.output);
+            break;
+        }
+
+        case DecodedOp::SETEMIT: {
+            auto* emitter = state.emitter_ptr;
+            ASSERT_MSG(emitter, "Execute SETEMIT on VS");
+            emitter->vertex_id = instr.vertex_id;
+            emitter->prim_emit = instr.prim_emit;
+            emitter->winding = instr.winding;
+            break;
+        }
+
+        case DecodedOp::Unhandled:
+            LogUnhandledInstruction({instr.hex});
+            break;
+        }
+
+        ++program_counter;
+
+        // Scopes are closed like in RunInterpreter, skip it while none is open
+        if (call_stack.empty() && if_stack.empty() && loop_stack.empty()) {
+            continue;
+        }
+
+        u32 next_program_counter = old_program_counter + 1;
+        for (u32 i = 0; i < 4; i++) {
+            if (call_stack.empty() || call_stack.back().end_address != next_program_counter)
+                break;
+            // Hardware bug: when popping four CALL scopes at once, the last
+            // one doesn't update the program counter
+            if (i < 3) {
+                program_counter = call_stack.back().return_address;
+                next_program_counter = program_counter;
+            }
+            call_stack.pop_back();
+        }
+
+        if (!if_stack.empty() && if_stack.back().else_address == old_program_counter + 1) {
+            program_counter = if_stack.back().end_address;
+            if_stack.pop_back();
+        }
+
+        if (!loop_stack.empty() &&
+            (loop_stack.back().end_address == old_program_counter + 1 || is_break)) {
+            auto& loop = loop_stack.back();
+            state.address_registers[2] += loop.address_increment;
+            if (!is_break && loop.loop_downcounter--) {
+                program_counter = loop.entry_address;
+            } else {
+                program_counter = loop.end_address;
+                // Only restore previous value if there is a surrounding LOOP scope.
+                if (loop_stack.size() > 1)
+                    state.address_registers[2] = loop.previous_aL;
+                loop_stack.pop_back();
+            }
+        }
+    }
+}
+
+InterpreterEngine::InterpreterEngine() = default;
+InterpreterEngine::~InterpreterEngine() = default;
+
 void InterpreterEngine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
     setup.entry_point = entry_point;
+
+    const u64 code_hash = setup.GetProgramCodeHash();
+    const u64 swizzle_hash = setup.GetSwizzleDataHash();
+
+    const u64 cache_key = Common::HashCombine(code_hash, swizzle_hash);
+    auto iter = cache.find(cache_key);
+    if (iter != cache.end()) {
+        setup.cached_shader = iter->second.get();
+    } else {
+        auto program = std::make_unique<DecodedProgram>(setup.program_code, setup.swizzle_data);
+        setup.cached_shader = program.get();
+        cache.emplace_hint(iter, cache_key, std::move(program));
+    }
 }
 
 MICROPROFILE_DEFINE(GPU_Shader, "GPU", "Shader", MP_RGB(50, 50, 240));
 
 void InterpreterEngine::Run(const ShaderSetup& setup, ShaderUnit& state) const {
+    ASSERT(setup.cached_shader != nullptr);
 
     MICROPROFILE_SCOPE(GPU_Shader);
 
-    DebugData<false> dummy_debug_data;
-    RunInterpreter(setup, state, dummy_debug_data, setup.entry_point);
+    const DecodedProgram* program = static_cast<const DecodedProgram*>(setup.cached_shader);
+    RunDecodedProgram(*program, setup, state);
 }
 
 DebugData<true> InterpreterEngine::ProduceDebugInfo(const ShaderSetup& setup,